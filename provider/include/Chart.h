@@ -39,6 +39,7 @@
 #include <numeric>
 #include "ObjectDescription.h"
 #include "OexControl.h"
+#include "WorkerPool.h"
 
 
 class Chart
@@ -92,12 +93,18 @@ public:
      * prepareRender can be called from a different thread
      * while others still are rendering
      * so internally atomic operations only!
+     * workers (if set) can be used to split up the work
     */
-    virtual bool PrepareRender(s52::S52Data::ConstPtr s52data){
+    virtual bool PrepareRender(s52::S52Data::ConstPtr s52data, WorkerPool::Ptr workers=WorkerPool::Ptr()){
         if (s52data) md5=s52data->getMD5();
         return true;
     }
     virtual int getRenderPasses() const {return 1;}
+    /**
+     * false if the chart will never draw anything in this pass
+     * the renderer will skip those passes
+     */
+    virtual bool HasRenderPass(int pass) const {return pass < getRenderPasses();}
     virtual RenderResult Render(int pass,RenderContext & context,DrawingContext &out, const Coord::TileBox &box) const;
     //we use a (small) tile box that contains our tolerance
     //and the click point being the mid
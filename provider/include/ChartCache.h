@@ -36,6 +36,7 @@
 #include "ChartSet.h"
 #include "S52Data.h"
 #include "Exception.h"
+#include "WorkerPool.h"
 
 class ChartCache{
     static const long LOAD_WAIT_MILLIS=10000; //waittime for a chart being currently loaded
@@ -58,6 +59,10 @@ class ChartCache{
     int HouseKeeping();
     void CheckMemoryLimit();
     void SetMemoryLimit(unsigned int limit){memKb=limit;}
+    /**
+     * set a pool to be used for preparing charts after loading
+     */
+    void SetPrepareWorkers(WorkerPool::Ptr workers){prepareWorkers=workers;}
     void OpenerRun(int sequence,long timeout=1000);
     void StopOpeners();
     void StartOpeners(int number);
@@ -130,6 +135,7 @@ class ChartCache{
     void UpdateChart(s52::S52Data::ConstPtr s52data, const String & setKey, const String &fileName, Chart::Ptr chart);
     Chart::ConstPtr LoadInternal(s52::S52Data::ConstPtr s52data,ChartSet::Ptr chartSet, const String &fileName);
     IChartFactory::Ptr factory;
+    WorkerPool::Ptr prepareWorkers;
     Charts charts;
     long loadWaitMillis;
     std::atomic<unsigned int> memKb={0}; //memory limit if != 0
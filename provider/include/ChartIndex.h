@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Chart Index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#ifndef CHARTINDEX_H
+#define CHARTINDEX_H
+#include <vector>
+#include <memory>
+#include <limits>
+#include "ChartInfo.h"
+#include "Coordinates.h"
+#include "PackedRTree.h"
+
+/**
+ * static spatial index over the charts of a chart set
+ * a packed R-tree (sort tile recursive) over the chart extents
+ * every node additionally holds the range of native scales
+ * below it - so we can prune by extent and by scale
+ * the index is immutable - it is rebuilt whenever the set changes
+ */
+class ChartIndex{
+public:
+    using Ptr=std::shared_ptr<ChartIndex>;
+    using ConstPtr=std::shared_ptr<const ChartIndex>;
+    static const constexpr double NO_MAX_SCALE=std::numeric_limits<double>::max();
+    /**
+     * build the index
+     * only valid charts that are not ignored will be considered
+     */
+    ChartIndex(const std::vector<ChartInfo::Ptr> &charts);
+    /**
+     * find all charts intersecting the extent
+     * with minScale <= nativeScale < maxScale
+     * the result is in the order of the charts list the index has been built from
+     */
+    WeightedChartList   Find(const Coord::Extent &extent, double minScale=0, double maxScale=NO_MAX_SCALE) const;
+    size_t              GetNumCharts() const {return tree.size();}
+    int                 GetDepth() const {return tree.getDepth();}
+private:
+    class Entry{
+        public:
+        Coord::Extent extent;
+        int scale;
+        size_t order; //position in the original list
+        ChartInfo::Ptr info;
+        Entry(const Coord::Extent &e,int s, size_t o, ChartInfo::Ptr i):
+            extent(e),scale(s),order(o),info(i){}
+    };
+    class ScaleRange{
+        public:
+        int minScale=std::numeric_limits<int>::max();
+        int maxScale=std::numeric_limits<int>::min();
+        void add(const Entry &entry){
+            if (entry.scale < minScale) minScale=entry.scale;
+            if (entry.scale > maxScale) maxScale=entry.scale;
+        }
+        void add(const ScaleRange &other){
+            if (other.minScale < minScale) minScale=other.minScale;
+            if (other.maxScale > maxScale) maxScale=other.maxScale;
+        }
+    };
+    class Traits{
+        public:
+        using Summary=ScaleRange;
+        static const Coord::Extent &extent(const Entry &e){ return e.extent;}
+    };
+    PackedRTree<Entry,Traits> tree;
+};
+
+#endif /* CHARTINDEX_H */
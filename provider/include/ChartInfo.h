@@ -47,6 +47,7 @@ class ZoomLevelScales{
 private:
     double zoomMpp[MAX_ZOOM+1];
     double zoomScales[MAX_ZOOM+1];
+    double scaleLevel;
     const double BASE_MPP=0.264583333 / 1000; //meters/pixel for 96dpi
     //the factor here affects which details we will see at which zoom levels
         
@@ -60,6 +61,7 @@ public:
     double GetScaleForZoom(int zoom) const;
     double GetMppForZoom(int zoom) const;
     int FindZoomForScale(double scale) const;
+    double GetScaleLevel() const {return scaleLevel;}
 };
 
 
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Persistent chart header index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#ifndef _CHARTINFOCACHE_H
+#define _CHARTINFOCACHE_H
+#include <unordered_map>
+#include <memory>
+#include "Types.h"
+#include "ChartInfo.h"
+#include "ChartSet.h"
+
+/**
+ * persistent index of the chart headers of one chart set
+ * allows to skip reading the chart headers at startup
+ * for all charts that did not change (same size and modification time)
+ */
+class ChartInfoCache{
+    public:
+    using Ptr=std::shared_ptr<ChartInfoCache>;
+    static const constexpr char * EXTENSION=".cidx";
+    ChartInfoCache(const String &fileName);
+    /**
+     * read the index file
+     * @return false if the file does not exist or is invalid
+     */
+    bool            Read();
+    /**
+     * write all valid charts to the index file
+     * @return false on errors
+     */
+    bool            Write(const ChartSet::InfoList &charts);
+    /**
+     * find a chart in the index
+     * @return a verified ChartInfo if file size and time are unchanged,
+     *         an empty pointer otherwise
+     */
+    ChartInfo::Ptr  Find(const String &chartFile) const;
+    size_t          GetNumEntries() const {return entries.size();}
+    String          GetFileName() const {return fileName;}
+    private:
+    static const constexpr uint32_t VERSION=1;
+    class Entry{
+        public:
+        int32_t         type=0;
+        int64_t         fileSize=-1;
+        int64_t         fileTime=-1;
+        int32_t         nativeScale=-1;
+        Coord::Extent   extent;
+        bool            softUnder=false;
+        bool            ignore=false;
+    };
+    using EntryMap=std::unordered_map<String,Entry>;
+    String          fileName;
+    EntryMap        entries;
+};
+#endif
@@ -44,12 +44,17 @@
 #include "StringHelper.h"
 #include "ChartCache.h"
 #include "S52Data.h"
+#include "CoveragePlanCache.h"
+#include "ChartInfoCache.h"
+#include "WorkerPool.h"
 
 typedef std::map<String,ChartSet::Ptr> ChartSetMap;
 typedef std::shared_ptr<ChartSetMap> ChartSetMapPtr;
+typedef std::shared_ptr<const ChartSetMap> ChartSetMapConstPtr;
 class ChartManager : public StatusCollector{
 public:
     static constexpr const char * CHART_TEMP_DIR="_TMP";
+    static const constexpr size_t MAX_COVERAGE_PLANS=4096;
     using Ptr=std::shared_ptr<ChartManager>;
     using ManagerState= enum{
             STATE_INIT,
@@ -60,7 +65,10 @@ public:
     using RunFunction=std::function<void (void)>;
     using SetChangeFunction=std::function<void(const String &setKey)>;
     using SettingsChangeFunction=std::function<void(s52::S52Data::ConstPtr newData)>;
-    ChartManager(FontFileHolder::Ptr fontFile, IBaseSettings::ConstPtr bs, RenderSettings::ConstPtr rs, IChartFactory::Ptr chartFactory,String s57dataDir, unsigned int memLimitKb, int numOpeners);
+    /**
+     * @param numReaders the number of parallel chart header reads
+     */
+    ChartManager(FontFileHolder::Ptr fontFile, IBaseSettings::ConstPtr bs, RenderSettings::ConstPtr rs, IChartFactory::Ptr chartFactory,String s57dataDir, unsigned int memLimitKb, int numOpeners, int numReaders=4);
     /**
      * really start reading the charts
      * beside initially opening them it will also monitor the mem usage
@@ -107,27 +115,32 @@ public:
     unsigned long       GetMaxCacheSizeKb();
     String              GetCacheFileName(const String &fileName);
     /**
-     * write out extensions and native scale for all charts
-     * @param config
-     * @return true if written
-     */
-    bool                WriteChartInfoCache(const String &configFile);
-    /**
-     * read extension an native scale from the cache file
-     * is used as a replacement for ReadCharts on fast start
-     * it will set all needed sets to parsing state
-     * @param config
-     * @return true if at least one set needs parsing
+     * set the directory for the chart info cache files
+     * (one per chart set, see ChartInfoCache)
+     * an empty dir disables the cache
      */
-    bool                ReadChartInfoCache(const String &configFile);
+    void                SetChartInfoCacheDir(const String &dir);
 
     Chart::ConstPtr     OpenChart(s52::S52Data::ConstPtr s52data, ChartInfo::Ptr info,bool doWait=true);
     Chart::ConstPtr     OpenChart(const String &setName, const String &chartName, bool doWait=true);
     bool                CloseChart(const String &setName, const String &chartName);
-    ChartSet::Ptr       ParseChartDir(const String &dir,bool canDelete);
+    /**
+     * read all chart dirs in parallel
+     * each set becomes active as soon as all its charts have been read
+     * @return the number of charts in the sets
+     */
     int                 ReadChartDirs(const StringVector &dirsAndFiles,bool canDelete=false);
     WeightedChartList   FindChartsForTile(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, bool allLower=false);
-    ChartSet::ExtentList  GetChartSetExtents(const String &chartSetKey,bool includeSet);
+    /**
+     * get the charts for a tile (see FindChartsForTile) together with the set extents
+     * plans are cached until the chart set or the settings change
+     */
+    CoveragePlan::ConstPtr GetCoveragePlan(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, bool allLower=false);
+    /**
+     * get the extents of all charts of a set
+     * if includeSet is set, the first entry is the extent of the set
+     */
+    ChartSet::ExtentList::ConstPtr  GetChartSetExtents(const String &chartSetKey,bool includeSet);
     /**
      * add mappings to shorten the chart set names for known directories
     */
@@ -145,6 +158,22 @@ public:
     void                registerSetChagend(SetChangeFunction f);
     void                registerSettingsChanged(SettingsChangeFunction f);
 private:
+    /**
+     * state of parsing one chart dir
+     */
+    class ParseJob{
+        public:
+        using Ptr=std::shared_ptr<ParseJob>;
+        using DoneFunction=std::function<void(Ptr)>;
+        ChartSet::Ptr       set;
+        String              dir;
+        ChartInfoCache::Ptr infoCache;
+        int                 numFiles=0;
+        int                 fromCache=0;
+        std::atomic<int>    numAdded={0};
+        std::atomic<int>    pending={0};
+        DoneFunction        onDone;
+    };
     class HouseKeeper : public Thread{
         ChartCache::Ptr cache;
         long intervallMs=0;
@@ -165,16 +194,55 @@ private:
      * @return 
      */
     int                 computeActiveSets();
+    /**
+     * publish a copy of chartSets for lock free readers
+     * must be called with lock already held after any change to chartSets
+     */
+    void                publishSets();
+    /**
+     * lock free access to the published chart sets
+     */
+    ChartSetMapConstPtr getSets() const;
+    ChartSet::Ptr       findSet(const String &key) const;
+    WeightedChartList   computeChartsForTile(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, ChartIndex::ConstPtr index, bool allLower);
+    std::shared_ptr<const ZoomLevelScales> getZoomLevelScales(double scaleLevel);
     bool                buildS52Data(RenderSettings::ConstPtr s);
     s52::S52Data::Ptr   s52data;
     IBaseSettings::ConstPtr baseSettings;
     ChartSetMap         chartSets;
+    ChartSetMapConstPtr publishedSets; //only access via atomic_load/atomic_store
+    CoveragePlanCache::Ptr planCache;
+    std::shared_ptr<const ZoomLevelScales> zoomLevelScales; //only access via atomic_load/atomic_store
     NameValueMap        dirMappings;
     std::mutex          lock;
     std::mutex          s52lock; //lock for building/updating the s52data
     String              s57Dir;
+    String              chartInfoCacheDir;
     String              KeyFromChartDir(String chartDir);
+    /**
+     * the chart info cache file for a set
+     * must be called with lock held
+     * @return an empty string if there is no cache dir
+     */
+    String              ChartInfoCacheFile(const String &setKey);
+    /**
+     * remove the chart info cache files of sets we do not know (any more)
+     */
+    void                RemoveUnknownChartInfoCaches();
     bool                HandleChart(const String &chartFile,ChartSet::Ptr chartSet);
+    /**
+     * start parsing a chart dir
+     * charts not found in the info cache are read by the readers pool
+     * onDone is called (from any thread) when all charts are handled
+     * @return an empty pointer if the dir does not exist
+     */
+    ParseJob::Ptr       StartParseChartDir(const String &dir,bool canDelete, ParseJob::DoneFunction onDone);
+    void                FinishParseChartDir(ParseJob::Ptr job);
+    /**
+     * make a completely parsed set available
+     * @return the number of charts in the set
+     */
+    int                 ActivateChartSet(ChartSet::Ptr chartSet);
     /**
      * cleanup currently open charts from disabled chart sets
      * main thread only
@@ -189,6 +257,8 @@ private:
     IChartFactory::Ptr  chartFactory;
     HouseKeeper::Ptr    houseKeeper;
     int                 numOpeners;
+    WorkerPool::Ptr     readers;
+    WorkerPool::Ptr     prepareWorkers;
     FontFileHolder::Ptr fontFile;
     SetChangeFunction   setChanged;
     SettingsChangeFunction settingsChanged;
@@ -30,6 +30,7 @@
 #include "ChartSetInfo.h"
 #include "SimpleThread.h"
 #include "ChartInfo.h"
+#include "ChartIndex.h"
 #include "StatusCollector.h"
 #include "MD5.h"
 #include <vector>
@@ -48,6 +49,7 @@ public:
     class ExtentList: public std::vector<Coord::Extent>{
         public:
         using std::vector<Coord::Extent>::vector;
+        using ConstPtr=std::shared_ptr<const ExtentList>;
         String setHash;
         int setSequence=0;
     };
@@ -64,6 +66,21 @@ public:
             int minScale=0;
             int maxScale=0;
     };
+    /**
+     * immutable view of the charts of a set
+     * published whenever the chart list changes (after the set is ready)
+     * so readers can use it without holding the set lock
+     */
+    class Snapshot{
+        public:
+        using ConstPtr=std::shared_ptr<const Snapshot>;
+        ChartIndex::ConstPtr index;
+        //the set extent followed by all chart extents, with setHash and setSequence
+        ExtentList::ConstPtr extents;
+        ExtentInfo extent;
+        String hash;
+        int sequence=0; //increases with every published snapshot
+    };
     class ChartCounts{
         public:
         int valid=0;
@@ -87,10 +104,22 @@ public:
     
     virtual bool        LocalJson(StatusStream &stream) override;
     bool                DisabledByErrors();
+    /**
+     * add a chart while parsing the set directory
+     * the change only becomes visible to readers with the next SetReady
+     */
     void                AddChart(ChartInfo::Ptr info);
-    WeightedChartList   FindChartForTile(const Coord::Extent &tileExtent);
+    /**
+     * find the charts intersecting the tile extent
+     * optionally only with minScale <= nativeScale < maxScale
+     */
+    WeightedChartList   FindChartForTile(const Coord::Extent &tileExtent, double minScale=0, double maxScale=ChartIndex::NO_MAX_SCALE);
     int                 GetNumValidCharts(){return numValidCharts;}
     size_t              GetNumCharts();
+    /**
+     * a copy of the current chart list
+     */
+    InfoList            GetCharts();
     String              GetSetToken();
     bool                ShouldRetryReopen(){return reopenErrors < 2;}
     String              GetChartKey(Chart::ChartType type, const String &fileName);
@@ -101,6 +130,11 @@ public:
     ExtentInfo          GetExtent();
     int                 RemoveUnverified();
     void                FillChartExtents(ExtentList &extents);
+    /**
+     * the current snapshot, lock free
+     * empty as long as the set is not ready
+     */
+    Snapshot::ConstPtr  GetSnapshot() const;
 
     
     
@@ -122,7 +156,13 @@ private:
      * compute hash, numbers
     */
     void                computeHash();
+    /**
+     * build and publish a new snapshot
+     * lock must be held
+     */
+    void                publish();
     InfoList            chartList;
+    Snapshot::ConstPtr  snapshot; //only access via atomic_load/atomic_store
     std::atomic<int>    minScale={std::numeric_limits<int>().max()};
     std::atomic<int>    maxScale={std::numeric_limits<int>().min()}; 
     MD5Name             hash;
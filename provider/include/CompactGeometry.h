@@ -0,0 +1,115 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Compact geometry storage
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _COMPACTGEOMETRY_H
+#define _COMPACTGEOMETRY_H
+#include <climits>
+#include "Coordinates.h"
+#include "OcAllocator.h"
+
+/**
+ * compact storage for sequences of world points
+ * each point is stored as the difference to its predecessor,
+ * the first point of a sequence relative to the origin (normally the
+ * chart reference point)
+ * differences are 16 bit values, bigger differences are escaped and
+ * stored with 32 bit
+ * sequences can only be read in forward direction (see Reader)
+ */
+class CompactGeometry{
+    public:
+    using Word=int16_t;
+    static const constexpr Word ESCAPE=INT16_MIN;
+    CompactGeometry(ocalloc::PoolRef p):words(p){}
+    /**
+     * must be set before the first sequence is added
+     */
+    void setOrigin(const Coord::WorldXy &o){
+        origin=o;
+    }
+    /**
+     * start a new sequence
+     * @return the offset of the sequence for the Reader
+     */
+    uint32_t startSequence(){
+        last=origin;
+        return words.size();
+    }
+    /**
+     * add a point to the current sequence
+     */
+    void add(const Coord::WorldXy &p){
+        addValue(last.x,p.x);
+        addValue(last.y,p.y);
+        last=p;
+    }
+    /**
+     * release unused capacity after all sequences have been added
+     */
+    void finish(){
+        words.shrink_to_fit();
+    }
+    size_t sizeBytes() const{
+        return words.capacity()*sizeof(Word);
+    }
+    class Reader{
+        const Word *current;
+        Coord::WorldXy last;
+        static Coord::World decode(const Word *&current,Coord::World v){
+            Word w=*current++;
+            if (w != ESCAPE) return v+w;
+            uint32_t lo=(uint16_t)(*current++);
+            uint32_t hi=(uint16_t)(*current++);
+            return (Coord::World)((uint32_t)v+(lo | (hi << 16)));
+        }
+        public:
+        Reader(const CompactGeometry &g, uint32_t offset):
+            current(g.words.data()+offset),last(g.origin){}
+        Coord::WorldXy next(){
+            last.x=decode(current,last.x);
+            last.y=decode(current,last.y);
+            return last;
+        }
+    };
+    protected:
+    ocalloc::Vector<Word> words;
+    Coord::WorldXy origin;
+    Coord::WorldXy last;
+    void addValue(Coord::World previous,Coord::World v){
+        int64_t diff=(int64_t)v-(int64_t)previous;
+        if (diff > ESCAPE && diff <= INT16_MAX){
+            words.push_back((Word)diff);
+            return;
+        }
+        //wrap around is handled when decoding
+        uint32_t udiff=(uint32_t)v-(uint32_t)previous;
+        words.push_back(ESCAPE);
+        words.push_back((Word)(udiff & 0xffff));
+        words.push_back((Word)(udiff >> 16));
+    }
+};
+
+#endif
@@ -0,0 +1,112 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Coverage Plan Cache
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#ifndef COVERAGEPLANCACHE_H
+#define COVERAGEPLANCACHE_H
+#include <unordered_map>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include "Types.h"
+#include "ItemStatus.h"
+#include "SimpleThread.h"
+#include "Tiles.h"
+#include "MD5.h"
+#include "ChartInfo.h"
+#include "ChartSet.h"
+
+/**
+ * the result of ChartManager::FindChartsForTile
+ * together with the generations it has been computed for
+ */
+class CoveragePlan{
+    public:
+    using ConstPtr=std::shared_ptr<const CoveragePlan>;
+    int setSequence=0;
+    MD5Name settingsMd5;
+    WeightedChartList charts; //final, ordered list
+    ChartSet::ExtentList::ConstPtr extents;
+};
+
+/**
+ * cache of coverage plans per tile
+ * entries are only returned if set sequence and settings
+ * are still the same
+ * the map is split into shards to keep the render threads from
+ * contending on a single lock
+ */
+class CoveragePlanCache : public ItemStatus{
+    public:
+    using Ptr=std::shared_ptr<CoveragePlanCache>;
+    static const constexpr int NUM_SHARDS=16;
+    class Key{
+        public:
+        String setKey;
+        int zoom=0;
+        int x=0;
+        int y=0;
+        bool allLower=false;
+        Key(const TileInfo &tile, bool al):
+            setKey(tile.chartSetKey),zoom(tile.zoom),x(tile.x),y(tile.y),allLower(al){}
+        bool operator==(const Key &other) const{
+            return zoom == other.zoom && x == other.x && y == other.y &&
+                allLower == other.allLower && setKey == other.setKey;
+        }
+    };
+    /**
+     * @param maxEntries the max number of plans we keep
+     */
+    CoveragePlanCache(size_t maxEntries);
+    CoveragePlan::ConstPtr Get(const Key &key, int setSequence, const MD5Name &settingsMd5);
+    void Add(const Key &key, CoveragePlan::ConstPtr plan);
+    void Clear();
+    virtual void ToJson(StatusStream &stream) override;
+    private:
+    class KeyHash{
+        public:
+        std::size_t operator()(const Key &k) const noexcept{
+            std::size_t h=std::hash<String>{}(k.setKey);
+            h ^= std::hash<int>{}(k.x) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<int>{}(k.y) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<int>{}((k.zoom << 1) | (k.allLower?1:0)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+    class Shard{
+        public:
+        std::mutex lock;
+        std::unordered_map<Key,CoveragePlan::ConstPtr,KeyHash> plans;
+        std::deque<Key> order; //insertion order for eviction
+    };
+    Shard & getShard(const Key &key);
+    Shard shards[NUM_SHARDS];
+    size_t maxPerShard;
+    std::atomic<int> numHits={0};
+    std::atomic<int> numMisses={0};
+};
+
+#endif /* COVERAGEPLANCACHE_H */
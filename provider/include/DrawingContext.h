@@ -30,6 +30,7 @@
 #include "Types.h"
 #include "memory.h"
 #include "Coordinates.h"
+#include "SpanKernels.h"
 
 class DrawingContext
 {
@@ -37,8 +38,11 @@ class DrawingContext
 public:
     typedef uint32_t ColorAndAlpha;
     uint64_t numTriangles = 0;
-    uint64_t triHitCount = 0;
-    uint64_t triUnhitCount = 0;
+    uint64_t triHitCount = 0;   //triangles that have been rasterized
+    uint64_t triUnhitCount = 0; //triangles rejected as being outside
+    uint64_t listSkipCount = 0; //triangle lists skipped by their extent (set by the caller)
+    uint64_t fillCount = 0;     //complete fills by a triangle covering everything
+    uint64_t numPolygons = 0;
     bool extThickLine=true;
     typedef struct
     {
@@ -125,128 +129,151 @@ public:
     }
     inline void drawHLine(Coord::Pixel y, Coord::Pixel x0, Coord::Pixel x1, const ColorAndAlpha &color, bool useAlpha = false, const Dash *dash = nullptr)
     {
-        if (y < 0 || y >= height)
-            return;
-        if (x1 < x0)
-            std::swap(x0, x1);
-        x0 = std::max(0, x0);
-        x1 = std::min(x1, width - 1);
-        ColorAndAlpha *dst = buffer.get() + y * linelen + x0;
-        if (!dash)
+        if (useAlpha)
         {
-            for (Coord::Pixel x = x0; x <= x1; x++)
-            {
-                if (useAlpha)
-                {
-                    *dst = alpha(*dst, color);
-                }
-                else
-                {
-                    *dst = color;
-                }
-                dst++;
-            }
+            if (dash) hLine<true, true>(y, x0, x1, color, dash);
+            else hLine<true, false>(y, x0, x1, color, dash);
         }
         else
         {
-            DashHandler dh(dash);
-            for (Coord::Pixel x = x0; x <= x1; x++)
-            {
-                if (dh.shouldDraw(x, y))
-                {
-                    if (useAlpha)
-                    {
-                        *dst = alpha(*dst, color);
-                    }
-                    else
-                    {
-                        *dst = color;
-                    }
-                }
-                dst++;
-            }
+            if (dash) hLine<false, true>(y, x0, x1, color, dash);
+            else hLine<false, false>(y, x0, x1, color, dash);
         }
     }
     inline void drawVLine(Coord::Pixel x, Coord::Pixel y0, Coord::Pixel y1, const ColorAndAlpha &color, bool useAlpha = false, const Dash *dash = nullptr)
     {
-        if (x < 0 || x >= width)
-            return;
-        if (y1 < y0)
-            std::swap(y0, y1);
-        y0 = std::max(0, y0);
-        y1 = std::min(y1, height - 1);
-        ColorAndAlpha *dst = buffer.get() + y0 * linelen + x;
-        if (!dash)
+        if (useAlpha)
         {
-            for (Coord::Pixel y = y0; y <= y1; y++)
-            {
-                if (useAlpha)
-                {
-                    *dst = alpha(*dst, color);
-                }
-                else
-                {
-                    *dst = color;
-                }
-                dst += linelen;
-            }
+            if (dash) vLine<true, true>(x, y0, y1, color, dash);
+            else vLine<true, false>(x, y0, y1, color, dash);
         }
         else
         {
-            DashHandler dh(dash);
-            for (Coord::Pixel y = y0; y <= y1; y++)
-            {
-                if (dh.shouldDraw(x, y))
-                {
-                    if (useAlpha)
-                    {
-                        *dst = alpha(*dst, color);
-                    }
-                    else
-                    {
-                        *dst = color;
-                    }
-                }
-                dst += linelen;
-            }
+            if (dash) vLine<false, true>(x, y0, y1, color, dash);
+            else vLine<false, false>(x, y0, y1, color, dash);
         }
     }
 
 protected:
+    /**
+     * a context without a pixel buffer
+     * only usable with the HIT variants of the primitives (see HitTestContext)
+     */
+    DrawingContext(int width, int height, bool withBuffer);
     std::unique_ptr<ColorAndAlpha[]> buffer;
     int width;
     int height;
     int bufSize;
     int linelen;
     bool hasDrawn=false;
-    bool checkOnly=false;
-    static ColorAndAlpha factors[256];
-    static ColorAndAlpha alphaImpl(ColorAndAlpha dst, const ColorAndAlpha &src);
-    inline void setPixInt(int x, int y, ColorAndAlpha ca, bool swap = false)
+    const SpanKernels::Kernels *kernels=SpanKernels::get();
+    /*
+     * the drawing loops are specialized at compile time:
+     * ALPHA:  blend instead of overwriting
+     * DASHED: check a DashHandler for each pixel
+     * SWAP:   x and y are exchanged (steep lines)
+     * HIT:    do not draw, just record in hasDrawn if any pixel would be drawn
+     *         and stop at the first one (see HitTestContext)
+     */
+    template<bool ALPHA>
+    inline void putPixel(ColorAndAlpha *dst, const ColorAndAlpha &color)
     {
-        ColorAndAlpha *px = NULL;
-        if (!swap)
-            px = pixel(x, y);
+        if (ALPHA)
+            *dst = alpha(*dst, color);
         else
-            px = pixel(y, x);
+            *dst = color;
+    }
+    template<bool ALPHA, bool DASHED>
+    inline void hLine(Coord::Pixel y, Coord::Pixel x0, Coord::Pixel x1, const ColorAndAlpha &color, const Dash *dash)
+    {
+        if (y < 0 || y >= height)
+            return;
+        if (x1 < x0)
+            std::swap(x0, x1);
+        x0 = std::max(0, x0);
+        x1 = std::min(x1, width - 1);
+        if (x1 < x0)
+            return;
+        ColorAndAlpha *dst = buffer.get() + y * linelen + x0;
+        if (!DASHED)
+        {
+            if (ALPHA)
+                kernels->blendColor(dst, x1 - x0 + 1, color);
+            else
+                kernels->fill(dst, x1 - x0 + 1, color);
+            return;
+        }
+        DashHandler dh(dash);
+        for (Coord::Pixel x = x0; x <= x1; x++)
+        {
+            if (dh.shouldDraw(x, y))
+                putPixel<ALPHA>(dst, color);
+            dst++;
+        }
+    }
+    template<bool ALPHA, bool DASHED>
+    inline void vLine(Coord::Pixel x, Coord::Pixel y0, Coord::Pixel y1, const ColorAndAlpha &color, const Dash *dash)
+    {
+        if (x < 0 || x >= width)
+            return;
+        if (y1 < y0)
+            std::swap(y0, y1);
+        y0 = std::max(0, y0);
+        y1 = std::min(y1, height - 1);
+        ColorAndAlpha *dst = buffer.get() + y0 * linelen + x;
+        DashHandler dh(dash);
+        for (Coord::Pixel y = y0; y <= y1; y++)
+        {
+            if (!DASHED || dh.shouldDraw(x, y))
+                putPixel<ALPHA>(dst, color);
+            dst += linelen;
+        }
+    }
+    template<bool SWAP>
+    inline ColorAndAlpha *pixelAt(int x, int y)
+    {
+        return SWAP ? pixel(y, x) : pixel(x, y);
+    }
+    template<bool SWAP>
+    inline bool inside(int x, int y) const
+    {
+        if (SWAP)
+            std::swap(x, y);
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+    template<bool SWAP, bool HIT>
+    inline void setPixInt(int x, int y, ColorAndAlpha ca)
+    {
+        if (HIT)
+        {
+            //no buffer in hit test mode
+            if (inside<SWAP>(x, y))
+                hasDrawn = true;
+            return;
+        }
+        ColorAndAlpha *px = pixelAt<SWAP>(x, y);
         if (!px)
             return;
         hasDrawn = true;
         *px = ca;
     }
-    inline void setPixAlpha(int x, int y, ColorAndAlpha ca, bool swap = false)
+    template<bool SWAP, bool HIT>
+    inline void setPixAlpha(int x, int y, ColorAndAlpha ca)
     {
-        ColorAndAlpha *px = NULL;
-        if (!swap)
-            px = pixel(x, y);
-        else
-            px = pixel(y, x);
+        if (HIT)
+        {
+            if (inside<SWAP>(x, y))
+                hasDrawn = true;
+            return;
+        }
+        ColorAndAlpha *px = pixelAt<SWAP>(x, y);
         if (!px)
             return;
         hasDrawn = true;
         *px = alpha(*px, ca);
     }
-    inline void setPixWeight(int x, int y, ColorAndAlpha c, uint32_t weight, bool swap = false)
+    template<bool SWAP, bool HIT>
+    inline void setPixWeight(int x, int y, ColorAndAlpha c, uint32_t weight)
     {
         uint32_t alpha = (c & 0xFF000000) >> 24;
         alpha = ((alpha * weight) >> 8);
@@ -256,52 +283,103 @@ protected:
             alpha = (alpha & 0xff);
         c &= 0xffffff;
         c |= ((ColorAndAlpha)alpha) << 24;
-        return setPixAlpha(x, y, c, swap);
+        return setPixAlpha<SWAP, HIT>(x, y, c);
     }
     inline ColorAndAlpha alpha(ColorAndAlpha dst, const ColorAndAlpha &src)
     {
-        //some initial checks to speed up for common cases
-        if (src == 0) return dst;
-        if (dst == 0) return src;
-        if ((src & 0xff000000) == 0xff000000) return src;
-        return alphaImpl(dst,src);
+        return SpanKernels::blendPixel(dst,src);
     }
 
 public:
     virtual ~DrawingContext() {}
+    /**
+     * a pattern symbol expanded to one full period of the fill raster
+     * the raster x distance = width + distance
+     * the raster y distance = height + distance
+     * the texture contains the transparent gaps and - if stagger is set -
+     * two symbol rows, the second one shifted by (x raster)/2
+     * so filling only needs to wrap around at the texture borders
+     * (see dda_tri in s52plib.cpp)
+     * for each texture row we keep the range of non transparent pixels
+     * to skip the gaps without blending them
+     */
+    class PatternTexture{
+        public:
+        using ConstPtr=std::shared_ptr<const PatternTexture>;
+        class Row{
+            public:
+            Coord::Pixel first=0;
+            Coord::Pixel last=-1; //last < first: empty row
+        };
+        int width=0;
+        int height=0;
+        std::vector<ColorAndAlpha> buffer;
+        std::vector<Row> rows;
+        PatternTexture(const ColorAndAlpha *symbol,int w, int h, int distance, bool stagger);
+        uint64_t numBytes() const{
+            return sizeof(*this)+buffer.capacity()*sizeof(ColorAndAlpha)+rows.capacity()*sizeof(Row);
+        }
+    };
     class PatternSpec{
         /**
          * pattern are drawn by a fixed raster on the tile
          * (and by using xoffset/yoffset) on the world on a particular
          * zoom level
          * we ignore any pivot
-         * the raster x distance = width + distance
-         * the raster y distance = height + distance
-         * so for any y coordinate the symbol coordinate is:
-         *   (y + yoffset) % (height+distance)
-         *   if (y >= height) - do not draw
-         * for x similar:
-         *   (x + xoffset) % (width + distance)
-         *   if (x >= width) - do not draw
-         * if stagger is set, every second row is shifted
-         *   if ((y + yoffset)/(height + distance) & 1) - add (width+distance)/2 to x
-         * the x/y offset are computed by the (tile x/y * TILE_SIZE) % (raster x/y distance)
-         * see dda_tri in s52plib.cpp
+         * for any y coordinate the texture row is:
+         *   (y + yoffset) % texture height
+         * and the texture column at x=xmin is
+         *   (xmin + xoffset) % texture width
+         * the x/y offset are computed by the (tile x/y * TILE_SIZE) % (texture width/height)
+         * the spec is cheap and can live on the stack, the texture is shared
         */
         public:
-        //symbol data
-        int width;
-        int height;
-        const ColorAndAlpha *buffer;
-        //pattern info
+        const PatternTexture *texture;
         Coord::Pixel xoffset=0; //the x offset of the context x=0
         Coord::Pixel yoffset=0; //the y offset of the context y=0
-        Coord::Pixel distance=0;
-        bool stagger=false; //if true, shift every second symbol row by (width+distance)/2 
-        PatternSpec(const ColorAndAlpha *b,int w, int h):
-            buffer(b),width(w),height(h){}
+        PatternSpec(const PatternTexture *t):
+            texture(t){}
         
     };
+    /**
+     * the edges of a polygon to be filled in one scanline pass
+     * the polygon can be given by its outline(s) or by a set of
+     * non overlapping triangles
+     * filling uses the non zero winding rule, so edges shared between
+     * triangles cancel out and each pixel is only drawn once
+     * each edge covers the rows [ymin,ymax[
+     */
+    class EdgeTable{
+        public:
+        class Edge{
+            public:
+            Coord::Pixel ymin=0;
+            Coord::Pixel ymax=0;
+            Coord::Pixel x0=0; //x at y0
+            Coord::Pixel y0=0;
+            double dxdy=0;
+            int dir=1; //+1 downwards, -1 upwards
+            double xAt(Coord::Pixel y) const{
+                return x0+(y-y0)*dxdy;
+            }
+        };
+        std::vector<Edge> edges;
+        Coord::Box<Coord::Pixel> extent;
+        void clear(){
+            edges.clear();
+            extent=Coord::Box<Coord::Pixel>();
+        }
+        bool empty() const{ return edges.empty();}
+        /**
+         * add an edge of an outline
+         * horizontal edges are ignored
+         */
+        void addEdge(const Coord::PixelXy &p0, const Coord::PixelXy &p1);
+        /**
+         * add a triangle, all triangles are stored with the same orientation
+         */
+        void addTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2);
+    };
     static ColorAndAlpha convertColor(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha = 255);
     static inline uint8_t getAlpha(const ColorAndAlpha c)
     {
@@ -317,6 +395,25 @@ public:
         ThicknessMode aThicknessMode=DrawingContext::LINE_THICKNESS_DRAW_CLOCKWISE);
     virtual void drawAaLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, DrawingContext::ColorAndAlpha color, const Dash *dash = nullptr);
     virtual void drawTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2, const ColorAndAlpha &color, const PatternSpec *pattern=nullptr);
+    /**
+     * check if a triangle completely covers the context (with a margin of one pixel)
+     * in this case fillAll will give the same result as drawTriangle
+     */
+    bool coversAll(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2) const;
+    virtual void fillAll(const ColorAndAlpha &color, const PatternSpec *pattern=nullptr);
+    /**
+     * fill a polygon with a color or a pattern
+     * the edges will be sorted
+     */
+    virtual void drawPolygon(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern=nullptr);
+    /**
+     * an empty edge table that can be filled and passed to drawPolygon
+     * it is reused for every call - so only one table can be in use at a time
+     */
+    EdgeTable &getEdgeTable(){
+        edgeTable.clear();
+        return edgeTable;
+    }
     virtual void drawSymbol(const Coord::PixelXy &p0 /*upper left*/, int width, int height, const ColorAndAlpha *buffer);
     virtual void drawGlyph(const Coord::PixelXy &p0 /*upper left*/, int width, int height, const uint8_t *buffer, ColorAndAlpha c);
     // draw filled if radiusInner >= 0
@@ -328,9 +425,46 @@ public:
     int getBpp() { return sizeof(ColorAndAlpha); }
     bool getDrawn() { return hasDrawn; }
     void resetDrawn(bool value=false){ hasDrawn=value;}
-    void setCheckOnly(bool v){checkOnly=v;}
     virtual void reset(ColorAndAlpha pattern = 0);
     virtual String getStatistics() const;
     static DrawingContext *create(int width, int height);
+protected:
+    /**
+     * fill the span [xmin,xmax] of row y with a color or a pattern
+     * the span must already be clipped
+     * @return true if HIT and the span would draw
+     */
+    template<bool HIT>
+    bool drawSpanT(Coord::Pixel y, Coord::Pixel xmin, Coord::Pixel xmax, const ColorAndAlpha &color, const PatternSpec *pattern);
+    //the implementations of the primitives, see above for the template parameters
+    template<bool HIT>
+    void drawRectT(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color);
+    template<bool HIT, bool ALPHA, bool DASHED>
+    void drawLineT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const ColorAndAlpha &color, const Dash *dash, bool overlapMajor);
+    template<bool HIT>
+    void drawThickLineT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const ColorAndAlpha &color, bool useAlpha, const Dash *dash, unsigned int aThickness);
+    template<bool HIT>
+    void drawAaLineT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, ColorAndAlpha color, const Dash *dash);
+    //p0,p1 already mirrored to x major with p0.x < p1.x
+    template<bool HIT, bool SWAP>
+    void aaLineSteps(const Coord::PixelXy &p0, const Coord::PixelXy &p1, ColorAndAlpha color, const Dash *dash);
+    template<bool HIT>
+    void drawTriangleT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2, const ColorAndAlpha &color, const PatternSpec *pattern);
+    template<bool HIT>
+    void fillAllT(const ColorAndAlpha &color, const PatternSpec *pattern);
+    class Crossing{
+        public:
+        double x;
+        int dir;
+        Crossing(double cx, int d):x(cx),dir(d){}
+    };
+    //scratch buffers for drawPolygon, cleared but never freed
+    EdgeTable edgeTable;
+    std::vector<size_t> polygonActive;
+    std::vector<Crossing> polygonCrossings;
+    template<bool HIT>
+    void drawPolygonT(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern);
+    template<bool HIT>
+    void drawArcT(const Coord::PixelXy &center, const ColorAndAlpha &color, int radius, int radiusInner, double startAngle, double endAngle);
 };
 #endif
\ No newline at end of file
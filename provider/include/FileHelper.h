@@ -41,7 +41,12 @@ class InputStream{
     public:
     typedef std::shared_ptr<InputStream> Ptr;
         InputStream(int fd, size_t bufferSize=512);
-        ~InputStream();
+        /**
+         * stream over a memory mapped file
+         * takes ownership of the mapping
+         */
+        InputStream(char *mapping, size_t mappedSize);
+        virtual ~InputStream();
         /**
          * read data
          * return 0 either on eof or when in nonblocking mode and
@@ -50,19 +55,28 @@ class InputStream{
          * waitMillis: 0 - no wait, -1 wait forever - only for non blocking
          *             >=0 only read at most the requested amount, -1 - always fill buffer 
          */
-        ssize_t read(char *buffer,size_t maxSize, long waitMillis=-1);
+        virtual ssize_t read(char *buffer,size_t maxSize, long waitMillis=-1);
         int read();
-        void close();
-        size_t BytesRead();
-        bool IsOpen();
-        bool HasEof();
+        virtual void close();
+        virtual size_t BytesRead();
+        virtual bool IsOpen();
+        virtual bool HasEof();
         bool IsNonBlocking();
         /**
          * check if we can read at least one byte from the input
          * will only work if a buffer is set, otherwise an exception is thrown
          * if data already has been read it will return true immediately
          */
-        bool CheckRead(long waitMillis=-1);
+        virtual bool CheckRead(long waitMillis=-1);
+        bool IsMapped() const {return mapping != nullptr;}
+        /**
+         * zero copy read for mapped streams
+         * returns a pointer into the mapping and advances the stream
+         * the data is valid until the stream is closed
+         * @param available out: number of bytes available at the pointer (<= len)
+         * @return nullptr if not mapped
+         */
+        char * ReadMapped(size_t len, size_t &available);
     private:
         /**
          * internal read method
@@ -81,7 +95,13 @@ class InputStream{
         bool isNonBlocking=false;
         bool hasEof=false;
         bool isClosed=false;
+        char *mapping=nullptr;
+        size_t mappedSize=0;
     protected:
+        /**
+         * for derived streams that do not read from an fd
+         */
+        InputStream(){}
         TESTVIRT int _poll(struct pollfd *fds, nfds_t nfds, int timeout){
             return ::poll(fds,nfds,timeout);
         }
@@ -130,6 +150,11 @@ public:
     };
     static FileInfo getFileInfo(const String &path);
     static InputStream::Ptr openFileStream(const String &fileName, int bufferSize=512);
+    /**
+     * open a file as memory mapped stream (for sequential reading)
+     * falls back to a normal stream if the file cannot be mapped
+     */
+    static InputStream::Ptr openMappedFileStream(const String &fileName, int bufferSize=512);
 };
 
 
@@ -0,0 +1,76 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Level of detail geometry
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _GEOMETRYLOD_H
+#define _GEOMETRYLOD_H
+#include <vector>
+#include "Coordinates.h"
+
+/**
+ * helpers to build simplified geometries for low zoom levels
+ * level 0 is the finest, NUM_LEVELS-1 the coarsest
+ * a level is used for all tiles with a zoom <= LEVEL_ZOOM[level]
+ * and its geometry differs by at most half a pixel at this zoom
+ */
+class GeometryLod{
+    public:
+    static const constexpr int NUM_LEVELS=3;
+    static const constexpr uint32_t LEVEL_ZOOM[NUM_LEVELS]={14,11,8};
+    using Points=std::vector<Coord::WorldXy>;
+    /**
+     * @return the level to be used for a zoom, -1 for the full geometry
+     */
+    static int levelForZoom(uint32_t zoom){
+        int rt=-1;
+        for (int level=0;level<NUM_LEVELS;level++){
+            if (zoom <= LEVEL_ZOOM[level]) rt=level;
+        }
+        return rt;
+    }
+    /**
+     * the size of one pixel at the zoom of a level in world units
+     */
+    static Coord::World pixelSize(int level){
+        return ((Coord::World)1) << (Coord::COORD_ZOOM_LEVEL-LEVEL_ZOOM[level]+Coord::SUB_PIXEL_BITS);
+    }
+    /**
+     * Douglas-Peucker simplification of a line
+     * the first and the last point are always kept
+     * @param tolerance max distance of a removed point to the simplified line
+     */
+    static void simplifyLine(const Coord::WorldXy *points, uint32_t num, Coord::World tolerance, Points &out);
+    /**
+     * convert a triangle fan (6), strip (5) or list (4) into a triangle list
+     */
+    static void toTriangles(uint8_t type, const Points &points, Points &out);
+    /**
+     * snap the corners of a triangle list to a grid of gridSize
+     * and drop all triangles that become degenerated
+     * as shared corners are snapped the same way no gaps are introduced
+     */
+    static void snapTriangles(const Points &triangles, Coord::World gridSize, Points &out);
+};
+#endif
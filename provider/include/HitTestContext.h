@@ -0,0 +1,55 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Hit test drawing context
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _HITTESTCONTEXT_H
+#define _HITTESTCONTEXT_H
+#include "DrawingContext.h"
+
+/**
+ * a drawing context that does not draw
+ * it only checks if any primitive would draw a pixel (getDrawn)
+ * used for feature info where the context covers the click area
+ * the checks ignore colors, alpha and dashes
+ * there is no pixel buffer - pixel() and getBuffer() must not be used
+ */
+class HitTestContext : public DrawingContext{
+    public:
+    HitTestContext(int width, int height):DrawingContext(width,height,false){}
+    virtual void drawRect(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color) override;
+    virtual void drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const ColorAndAlpha &color, bool alpha = false, const Dash *dash = nullptr, bool overlapMajor=false) override;
+    virtual void drawThickLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, unsigned int aThickness,
+        ThicknessMode aThicknessMode=DrawingContext::LINE_THICKNESS_DRAW_CLOCKWISE) override;
+    virtual void drawAaLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, DrawingContext::ColorAndAlpha color, const Dash *dash = nullptr) override;
+    virtual void drawTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2, const ColorAndAlpha &color, const PatternSpec *pattern=nullptr) override;
+    virtual void fillAll(const ColorAndAlpha &color, const PatternSpec *pattern=nullptr) override;
+    virtual void drawPolygon(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern=nullptr) override;
+    virtual void drawSymbol(const Coord::PixelXy &p0 /*upper left*/, int width, int height, const ColorAndAlpha *buffer) override;
+    virtual void drawGlyph(const Coord::PixelXy &p0 /*upper left*/, int width, int height, const uint8_t *buffer, ColorAndAlpha c) override;
+    virtual void drawArc(const Coord::PixelXy &center, const ColorAndAlpha &color, int radius, int radiusInner = -1, double startAngle = 0, double endAngle = 360) override;
+    private:
+    bool hitsBox(const Coord::PixelXy &p0, int width, int height) const;
+};
+#endif
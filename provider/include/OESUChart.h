@@ -31,6 +31,7 @@
 #include "S52Rules.h"
 #include <unordered_set>
 #include "OcAllocator.h"
+#include "SpatialIndex.h"
 
 
 
@@ -38,6 +39,9 @@ class OESUChart : public Chart
 {
     std::unique_ptr<ocalloc::Pool> apool;
     ocalloc::PoolRef poolRef;
+    //additional pools for the parallel parts of prepareRender
+    //must survive the renderData
+    std::vector<std::unique_ptr<ocalloc::Pool>> partitionPools;
     ocalloc::Vector<S57Object::Ptr> s57Objects;
 
 public:
@@ -47,11 +51,47 @@ public:
         s52::RuleCreator ruleCreator;
         typedef ocalloc::Vector<S57Object::RenderObject::Ptr> RenderObjects;
         RenderObjects renderObjects;
+        //rule creators for the additional parts of a parallel prepare
+        std::vector<std::unique_ptr<s52::RuleCreator>> partitionCreators;
         double nextSafetyContour=1e6; //compute from all depth contures
+        /**
+         * the objects that become visible at one zoom level (SCAMIN)
+         * with a spatial index into renderObjects
+         */
+        class ZoomBucket{
+            public:
+            int minZoom=0;
+            int maxScale=0; //the largest max scale of all objects in the bucket
+            SpatialIndex index;
+            ZoomBucket(ocalloc::PoolRef p, int z):minZoom(z),index(p){}
+        };
+        //buckets by zoom, built at the end of prepareRender
+        std::vector<std::unique_ptr<ZoomBucket>> buckets;
+        int maxPixelMargin=0;
+        class PassRule{
+            public:
+            uint32_t pass;
+            const S57Object::RenderObject::DrawCommand *command;
+            PassRule(uint32_t p, const S57Object::RenderObject::DrawCommand *c):pass(p),command(c){}
+        };
+        //the draw commands of all objects with their render pass
+        //commands of object i are [passRuleStart[i],passRuleStart[i+1])
+        //in pass and render order
+        ocalloc::Vector<PassRule> passRules;
+        ocalloc::Vector<uint32_t> passRuleStart;
+        uint64_t passMask=0; //bit set for every pass with rules
         RenderData(ocalloc::PoolRef p,s52::S52Data::ConstPtr s52) : s52data(s52), 
-            renderObjects(p),ruleCreator(p,1)
+            renderObjects(p),ruleCreator(p,1),passRules(p),passRuleStart(p)
         {
         }
+        void buildIndex(ocalloc::PoolRef pool);
+        void buildPasses();
+        /**
+         * get the positions in renderObjects for all objects that could
+         * intersect the tile and are visible at scale, sorted ascending
+         * the caller still has to check with Intersects and shouldRenderScale
+         */
+        void findObjects(const Coord::PixelBox &pixelBox, const Coord::TileBox &tile, int scale, SpatialIndex::IdList &result) const;
         ~RenderData(){
             
         }
@@ -75,9 +115,14 @@ public:
     virtual ~OESUChart();
     OESUChart(const String &setKey, ChartType type, const String &fileName);
     virtual bool ReadChartStream(InputStream::Ptr input,s52::S52Data::ConstPtr s52data, bool headerOnly = false) override;
-    virtual bool PrepareRender(s52::S52Data::ConstPtr s52data) override;
+    /**
+     * min number of objects for each parallel part of prepareRender
+     */
+    static const constexpr size_t MIN_PARTITION_OBJECTS=2000;
+    virtual bool PrepareRender(s52::S52Data::ConstPtr s52data, WorkerPool::Ptr workers=WorkerPool::Ptr()) override;
     virtual RenderResult Render(int pass,RenderContext & context,DrawingContext &out, const Coord::TileBox &box) const override;
     virtual int getRenderPasses() const override;
+    virtual bool HasRenderPass(int pass) const override;
     virtual MD5Name GetMD5() const override;
     virtual bool IsIgnored() const override { return cellEdition == 0;}
     virtual void LogInfo(const String &prefix) const;
@@ -101,16 +146,40 @@ public:
 
 protected:
     bool setRigidFloat(const S57Object *obj); 
+    /**
+     * create the render objects for s57Objects [start,end)
+     * sorted by display priority
+     */
+    void prepareObjects(RenderData::RenderObjects &objects, size_t start, size_t end, 
+        s52::RuleCreator *creator,ocalloc::PoolRef pool,const s52::S52Data *s52data) const;
     int sencVersion = -1;
     std::unique_ptr<Coord::CombinedPoint> referencePoint;
     std::shared_ptr<RenderData> renderData;
     ocalloc::UnorderedSet<Coord::WorldXy,Coord::PointHash<Coord::World>> rigidAtons;
     ocalloc::UnorderedSet<Coord::WorldXy,Coord::PointHash<Coord::World>> floatAtons;
+    //the node tables are only used while reading
+    //they are dropped after buildLineGeometries
     VectorEdgeNodeTable edgeNodeTable;
     ConnectedNodeTable connectedNodeTable;
+    //all edge points referenced by lines, see S57Object::LineIndex
+    //must not be changed after buildLineGeometries
+    ocalloc::Vector<Coord::WorldXy> edgePoints;
+    //simplified edges for all GeometryLod levels, same rules as edgePoints
+    ocalloc::Vector<Coord::WorldXy> lodEdgePoints;
+    //the points of all area triangles
+    CompactGeometry areaGeometry;
     StringMap txtdscTable;
     uint16_t cellEdition=UINT16_MAX; //avoid ignore if there was no cell edition
+    /**
+     * resolve the lines of all objects, must be called once
+     * after all objects and vectors have been read
+     */
     void buildLineGeometries();
+    /**
+     * add the snapped triangle lists for the GeometryLod levels
+     * to all areas
+     */
+    void buildAreaLod();
     HeaderInfo headerInfo;
     virtual bool aboveV200() const {return sencVersion > 200;}
 };
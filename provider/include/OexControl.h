@@ -35,6 +35,7 @@
 #include "Timer.h"
 #include <memory>
 #include <atomic>
+#include <vector>
 class OexControl : public ItemStatus{
     public:
         DECL_EXC(AvException,OpenException)
@@ -67,14 +68,25 @@ class OexControl : public ItemStatus{
             bool forDongle=false;
         } FPR;
         virtual void ToJson(StatusStream &stream);
+        /**
+         * combined state of all instances:
+         * RUNNING if at least one instance is running
+         */
         OexState GetState();
         void Start();
         void Stop();
         void Restart(String reason);
         bool WaitForState(OexState state, long timeoutMillis);
-        static void Init(String progDir,String tempDir,StringVector additionalParameters);
+        /**
+         * @param numInstances the number of oexserverd processes to run
+         */
+        static void Init(String progDir,String tempDir,StringVector additionalParameters, int numInstances=1);
         static Ptr Instance();
-        TESTVIRT int OpenConnection(long timeoutMillis, bool ignoreState=false);
+        int GetNumInstances() const { return servers.size();}
+        TESTVIRT int OpenConnection(const String &socketAddress, long timeoutMillis);
+        /**
+         * send a command to the running instance with the least outstanding requests
+         */
         TESTVIRT InputStream::Ptr SendOexCommand(OexCommands cmd,const String &fileName, const String &key, long waitTime=DEFAULT_WAITTIME);
         TESTVIRT FPR GetFpr(long timeoutMillis,bool forDongle=false, bool alternative=false);
         TESTVIRT bool DonglePresent(long timeoutMillis=10000); 
@@ -87,45 +99,80 @@ class OexControl : public ItemStatus{
         //write saved log lines from oex to stdout
         void writeLog();
     private:
+        /**
+         * one supervised oexserverd process
+         */
+        class OexServer : public ItemStatus{
+            public:
+            using Ptr=std::shared_ptr<OexServer>;
+            OexServer(int index,const String &socketAddress);
+            OexState GetState();
+            OexState GetRequestedState();
+            bool SetState(OexState state,String error=String());
+            bool SetRequestedState(OexState state);
+            String GetLastError();
+            void addLog(const String &le);
+            void resetLog();
+            StringVector getLog();
+            void addLatency(int64_t micros);
+            virtual void ToJson(StatusStream &stream);
+            const int index;
+            const String socketAddress;
+            std::atomic<int> pid={-1};
+            std::atomic<int> outstanding={0}; //currently open requests
+            std::atomic<long> numRequests={0};
+            std::atomic<long> numErrors={0};
+            std::atomic<long> numPingErrors={0}; //failed availability checks, not counted in numErrors
+            std::atomic<int> numStarts={0};
+            private:
+            std::mutex mutex;
+            OexState _state=UNKNOWN;
+            OexState _requestedState=UNKNOWN;
+            String lastError;
+            StringVector oexLog;
+            int64_t latencySumMicros=0;
+            int64_t latencyMaxMicros=0;
+            long numLatencies=0;
+        };
         class Supervisor : public Thread{
             public:
-            Supervisor(OexControl::Ptr ctl);
+            Supervisor(OexControl::Ptr ctl,OexServer::Ptr server);
             virtual void run();
             void Pause();
             void Resume();
             private:
             bool paused=false;
             OexControl::Ptr control;
+            OexServer::Ptr server;
         };
+        class OexStream;
         typedef struct {
             unsigned char cmd=0;
             char fifo_name[256]={0};
             char senc_name[256]={0};
             char senc_key[512]={0};
         } OexMessage;
-        bool PingOex(long waitTime=DEFAULT_WAITTIME);
-        TESTVIRT InputStream::Ptr DoSendOexCommand(OexCommands cmd,const String &fileName, const String &key, long waitTime=DEFAULT_WAITTIME, bool ignoreState=false);
+        bool PingOex(OexServer::Ptr server, long waitTime=DEFAULT_WAITTIME);
+        /**
+         * select the running server with the least outstanding requests
+         * and count the request
+         */
+        OexServer::Ptr selectServer();
+        TESTVIRT InputStream::Ptr DoSendOexCommand(OexServer::Ptr server,OexCommands cmd,const String &fileName, const String &key, long waitTime=DEFAULT_WAITTIME);
         TESTVIRT String GetDongleNameInternal(long timeoutMillis=10000);
         OexControl(String progDir,String tempDir,StringVector additionalParameters);
         void StopServer(pid_t pid);
-        bool SetState(OexState state,String error=String());
-        bool SetRequestedState(OexState state);
+        void SetRequestedState(OexState state);
         long getNextTempIdx();
-        OexState GetRequestedState();
-        void addLog(const String &le);
-        void resetLog();
-        Supervisor *supervisor=NULL;
-        OexState _state=UNKNOWN;
-        OexState _requestedState=UNKNOWN;
+        std::vector<Supervisor *> supervisors;
+        std::vector<OexServer::Ptr> servers;
+        size_t nextServer=0;
         static Ptr _instance;
         String progDir;
         String tempDir;
-        StringVector oexLog;
         std::mutex mutex;
         StringVector additionalParameters;
-        String lastError;
         long tempDirIdx=0;
-        std::atomic<int> pid={-1};
         Timer::SteadyTimePoint lastDongleState;
         bool donglePresent=false;
         String dongleName="";
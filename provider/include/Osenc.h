@@ -29,6 +29,7 @@
 #include "Types.h"
 #include "Exception.h"
 #include "FileHelper.h"
+#include "Chart.h"
 
 //  OSENC V2 record definitions
 #define HEADER_SENC_VERSION             1
@@ -77,6 +78,95 @@ class IRecordBuffer{
     virtual const String & GetFileName()=0;
     virtual ~IRecordBuffer(){}
 };
+#define INITIAL_BUFFER_SIZE 256
+#define MAX_BUFFER_SIZE (40*1024*1024)
+/**
+ * buffer for reading one record
+ * for mapped streams it just points into the mapping
+ */
+class RecordBuffer: public IRecordBuffer{
+    uint32_t size=INITIAL_BUFFER_SIZE;
+    char *buffer=new char[INITIAL_BUFFER_SIZE];
+    char *current=buffer; //either buffer or a pointer into a mapped stream
+    uint32_t fill=0;
+    String fileName;
+    bool ensure(uint32_t newSize){
+        bool changed=false;
+        while (size < newSize){
+            size = size << 2;
+            changed=true;
+        }
+        if (changed){
+            delete[] buffer;
+            current=nullptr;
+            buffer=new (std::nothrow) char[size]; 
+            if (! buffer){
+                throw FileException(fileName,FMT("unable to allocated %d bytes for record buffer",newSize));
+            }
+            current=buffer;
+        }
+        return true;
+    }
+public:
+    RecordBuffer(const String &fileName){
+        this->fileName=fileName;
+    }
+    virtual ~RecordBuffer(){
+        delete []buffer;
+    }
+    virtual char * WriteToBuffer(InputStream::Ptr stream,uint32_t len) override{
+        fill=0;
+        current=buffer;
+        if (len == 0){
+            return buffer;
+        }
+        if (len > MAX_BUFFER_SIZE){
+            throw Chart::InvalidChartException(fileName, FMT("buffer size %d too big",len));
+        }
+        if (stream->IsMapped()){
+            //zero copy - just point into the mapping
+            size_t available=0;
+            char *data=stream->ReadMapped(len,available);
+            if (available == 0){
+                throw NoDataException(fileName,"no data read from buffer");
+            }
+            if (available < len){
+                throw NoDataException(fileName,FMT("unable to read %d bytes from stream, only got %d",len,available));
+            }
+            current=data;
+            fill=available;
+            return current;
+        }
+        ensure(len); //could reallocate buffer, updates current
+        ssize_t rd=stream->read(buffer,len);
+        if (rd == 0){
+            throw NoDataException(fileName,"no data read from buffer");
+        }
+        if (rd < len){
+            throw NoDataException(fileName,FMT("unable to read %d bytes from stream, only got %d",len,rd));
+        }
+        fill=rd;
+        return buffer;
+    }
+    virtual uint32_t GetFill() override {return fill;}
+    virtual char* GetBuffer()override { return current;}
+    uint32_t forward(InputStream::Ptr stream,uint32_t len){
+        uint32_t skipped=0;
+        while (skipped < len){
+            size_t toRead=len-skipped;
+            if (toRead > size) toRead=size;
+            ssize_t rd=stream->read(buffer,toRead);
+            if (rd <= 0){
+                return skipped;
+            }
+            skipped+=rd;
+        }
+        return skipped;    
+    }
+    virtual const String & GetFileName() override{
+        return fileName;
+    }
+};
 template<typename T, uint16_t Code>
 class OsencRecord{
     protected:
@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Packed R-tree
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _PACKEDRTREE_H
+#define _PACKEDRTREE_H
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include "Coordinates.h"
+#include "Exception.h"
+
+template<typename T>
+using PackedRTreeVector=std::vector<T>;
+
+/**
+ * summary for trees that only prune by extent
+ */
+class PackedRTreeNoSummary{
+    public:
+    template<typename T>
+    void add(const T &){}
+};
+
+/**
+ * a static packed R-tree (sort tile recursive) over world extents
+ * the tree is built once and can afterwards be queried from
+ * multiple threads
+ * ENTRY:  the indexed items
+ * TRAITS: static const Coord::Extent &extent(const ENTRY &)
+ *         using Summary=... - a class with add(const ENTRY &) and add(const Summary &)
+ *         that is kept for every node and can be used to prune the query
+ * VECTOR: the container template for entries and nodes
+ */
+template<typename ENTRY, typename TRAITS, template<typename> class VECTOR=PackedRTreeVector>
+class PackedRTree{
+    public:
+    static const constexpr uint32_t NODE_SIZE=16;
+    using Summary=typename TRAITS::Summary;
+    //inherit from the summary to avoid wasting space for an empty one
+    class Node : public Summary{
+        public:
+        Coord::Extent extent;
+        uint32_t first=0; //first child node or first entry for leaves
+        uint32_t count=0;
+    };
+    using EntryList=VECTOR<ENTRY>;
+    using NodeList=VECTOR<Node>;
+    PackedRTree(){}
+    /**
+     * the allocator is passed to the constructors of the vectors
+     */
+    template<typename ALLOC, typename=std::enable_if_t<! std::is_same<ALLOC,PackedRTree>::value>>
+    explicit PackedRTree(ALLOC &alloc):entries(alloc),nodes(alloc){}
+    /**
+     * add an entry, only valid before build
+     */
+    template<typename... Args>
+    void add(Args&&... args){
+        if (built) throw AvException("cannot add to an already built spatial index");
+        entries.emplace_back(std::forward<Args>(args)...);
+    }
+    void build(){
+        nodes.clear();
+        numLeaves=0;
+        built=true;
+        if (entries.empty()) return;
+        entries.shrink_to_fit();
+        strSort(entries.begin(),entries.end(),[](const ENTRY &e)->const Coord::Extent &{
+            return TRAITS::extent(e);
+        });
+        for (uint32_t i=0;i<entries.size();i+=NODE_SIZE){
+            Node node;
+            node.first=i;
+            node.count=std::min((uint32_t)entries.size()-i,NODE_SIZE);
+            for (uint32_t e=i;e<i+node.count;e++){
+                node.extent.extend(TRAITS::extent(entries[e]));
+                node.add(entries[e]);
+            }
+            nodes.push_back(node);
+        }
+        numLeaves=nodes.size();
+        uint32_t levelStart=0;
+        uint32_t levelEnd=nodes.size();
+        depth=1;
+        while ((levelEnd-levelStart) > 1){
+            //we can freely reorder the nodes of a level
+            //as long as they are not referenced by a parent
+            strSort(nodes.begin()+levelStart,nodes.begin()+levelEnd,[](const Node &n)->const Coord::Extent &{
+                return n.extent;
+            });
+            for (uint32_t i=levelStart;i<levelEnd;i+=NODE_SIZE){
+                Node node;
+                node.first=i;
+                node.count=std::min(levelEnd-i,NODE_SIZE);
+                for (uint32_t n=i;n<i+node.count;n++){
+                    node.extent.extend(nodes[n].extent);
+                    node.add((const Summary &)nodes[n]);
+                }
+                nodes.push_back(node);
+            }
+            levelStart=levelEnd;
+            levelEnd=nodes.size();
+            depth++;
+        }
+        nodes.shrink_to_fit();
+    }
+    /**
+     * call onEntry for all entries with an extent intersecting box
+     * in undefined order
+     * nodes (and all entries below them) are skipped if accept(const Summary &) returns false
+     */
+    template<typename ACCEPT, typename ONENTRY>
+    void query(const Coord::Extent &box, ACCEPT accept, ONENTRY onEntry) const{
+        if (nodes.empty() || ! box.valid) return;
+        //at most 8 levels for 32 bit ids, each level adds < NODE_SIZE entries
+        uint32_t stack[8*NODE_SIZE];
+        int stackSize=0;
+        stack[stackSize++]=nodes.size()-1;
+        while (stackSize > 0){
+            uint32_t idx=stack[--stackSize];
+            const Node &node=nodes[idx];
+            if (! node.extent.intersects(box)) continue;
+            if (! accept((const Summary &)node)) continue;
+            if (idx < numLeaves){
+                for (uint32_t e=node.first;e<node.first+node.count;e++){
+                    if (TRAITS::extent(entries[e]).intersects(box)){
+                        onEntry(entries[e]);
+                    }
+                }
+            }
+            else{
+                for (uint32_t n=node.first;n<node.first+node.count;n++){
+                    stack[stackSize++]=n;
+                }
+            }
+        }
+    }
+    size_t size() const { return entries.size();}
+    int getDepth() const { return depth;}
+    private:
+    EntryList entries;
+    NodeList nodes; //all levels, leaves first, root last
+    uint32_t numLeaves=0;
+    int depth=0;
+    bool built=false;
+    static inline int64_t centerX(const Coord::Extent &e){
+        return ((int64_t)e.xmin+(int64_t)e.xmax)/2;
+    }
+    static inline int64_t centerY(const Coord::Extent &e){
+        return ((int64_t)e.ymin+(int64_t)e.ymax)/2;
+    }
+    /**
+     * sort tile recursive ordering
+     * sort by x of the mid point, cut into vertical slices
+     * and sort every slice by y
+     * afterwards each run of NODE_SIZE items forms a node
+     */
+    template<typename T, typename EXTENT>
+    static void strSort(T begin, T end, EXTENT extent){
+        size_t num=end-begin;
+        if (num <= NODE_SIZE) return;
+        size_t numNodes=(num+NODE_SIZE-1)/NODE_SIZE;
+        size_t numSlices=std::ceil(std::sqrt((double)numNodes));
+        size_t sliceSize=numSlices*NODE_SIZE;
+        std::sort(begin,end,[&extent](const auto &a, const auto &b){
+            return centerX(extent(a)) < centerX(extent(b));
+        });
+        for (T slice=begin;slice < end;){
+            T sliceEnd=((size_t)(end-slice) > sliceSize)?slice+sliceSize:end;
+            std::sort(slice,sliceEnd,[&extent](const auto &a, const auto &b){
+                return centerY(extent(a)) < centerY(extent(b));
+            });
+            slice=sliceEnd;
+        }
+    }
+};
+#endif
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Prefetching input stream
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#ifndef _PREFETCHINPUTSTREAM_H
+#define _PREFETCHINPUTSTREAM_H
+#include <vector>
+#include <thread>
+#include <atomic>
+#include "FileHelper.h"
+#include "SimpleThread.h"
+
+/**
+ * an input stream that reads its source in a separate thread
+ * into a ring of chunks
+ * this way receiving (and decrypting in oexserverd) runs in parallel
+ * to parsing the data
+ * reads block until the buffer is filled, the source is at eof
+ * or waitMillis has passed (returning the bytes read so far)
+ */
+class PrefetchInputStream : public InputStream{
+    public:
+    using Ptr=std::shared_ptr<PrefetchInputStream>;
+    static const constexpr size_t CHUNK_SIZE=64*1024;
+    static const constexpr int NUM_CHUNKS=16;
+    PrefetchInputStream(InputStream::Ptr source, size_t chunkSize=CHUNK_SIZE, int numChunks=NUM_CHUNKS);
+    virtual ~PrefetchInputStream();
+    virtual ssize_t read(char *buffer,size_t maxSize, long waitMillis=-1) override;
+    virtual void close() override;
+    virtual size_t BytesRead() override;
+    virtual bool IsOpen() override;
+    virtual bool HasEof() override;
+    virtual bool CheckRead(long waitMillis=-1) override;
+    /**
+     * time spent in reading the source
+     */
+    int64_t GetTransferMicros() const {return transferMicros;}
+    /**
+     * time the consumer had to wait for data
+     */
+    int64_t GetWaitMicros() const {return waitMicros;}
+    private:
+    static const constexpr long READ_WAIT_MILLIS=100;
+    class Chunk{
+        public:
+        std::unique_ptr<char[]> data;
+        size_t fill=0;
+        size_t pos=0;
+    };
+    void                run();
+    InputStream::Ptr    source;
+    size_t              chunkSize;
+    std::vector<Chunk>  chunks;
+    size_t              readIdx=0;
+    size_t              writeIdx=0;
+    size_t              numFilled=0;
+    size_t              bytesRead=0;
+    bool                eof=false;
+    bool                stopped=false;
+    std::mutex          lock;
+    Condition           cond;
+    std::thread         reader;
+    std::atomic<int64_t> transferMicros={0};
+    std::atomic<int64_t> waitMicros={0};
+};
+#endif
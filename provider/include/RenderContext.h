@@ -34,6 +34,11 @@ class ChartRenderContext{
     public:
     virtual ~ChartRenderContext(){}
     using Ptr=std::shared_ptr<ChartRenderContext>;
+    /**
+     * can be used by the chart to let the renderer
+     * skip passes that have nothing to draw for this tile
+     */
+    virtual bool HasPass(int pass) const { return true;}
 };
 class RenderContext
 {
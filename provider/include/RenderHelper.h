@@ -52,16 +52,34 @@ public:
     static void renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContext &ctx,
         const Coord::PixelXy &start, const Coord::PixelXy &end, 
         const String &symbol);
-    static DrawingContext::PatternSpec *createPatternSpec(s52::SymbolPtr symbol,const Coord::TileBox &tile);       
+    static void renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContext &ctx,Coord::TileBox const &tile,
+        const Coord::WorldXy &start, const Coord::WorldXy &end, 
+        const s52::SymbolCache::Handle &symbol); 
+    static void renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContext &ctx,
+        const Coord::PixelXy &start, const Coord::PixelXy &end, 
+        const s52::SymbolCache::Handle &symbol);
+    /**
+     * the pattern for an area fill on this tile
+     * the texture is kept with the symbol, so the spec is only valid
+     * as long as the symbol is alive
+     * texture is nullptr if the symbol has no data
+     */
+    static DrawingContext::PatternSpec createPatternSpec(const s52::SymbolData &symbol,const Coord::TileBox &tile);       
+    using SoundingStyle=s52::SoundingStyle;
     template <typename LType>
     static void renderSounding(s52::S52Data::ConstPtr s52Data, DrawingContext &ctx, Coord::TileBox const &tile, const LType *soundings)
+    {
+        renderSounding(s52Data,s52Data->getSoundingStyle(),ctx,tile,soundings);
+    }
+    template <typename LType>
+    static void renderSounding(s52::S52Data::ConstPtr s52Data, const SoundingStyle &style, DrawingContext &ctx, Coord::TileBox const &tile, const LType *soundings)
     {
         // for now simplified approach:
         // just render a text
         // still misses special symbols!
-        FontManager::Ptr fm = s52Data->getFontManager(s52::S52Data::FONT_SOUND);
-        DrawingContext::ColorAndAlpha cDeep = s52Data->convertColor(s52Data->getColor("SNDG1"));
-        DrawingContext::ColorAndAlpha cShallow = s52Data->convertColor(s52Data->getColor("SNDG2"));
+        FontManager::Ptr fm = style.fm;
+        DrawingContext::ColorAndAlpha cDeep = style.cDeep;
+        DrawingContext::ColorAndAlpha cShallow = style.cShallow;
         double safetyDepth = s52Data->getSettings()->S52_MAR_SAFETY_CONTOUR;
         int asc = fm->getAscend();
         int cwidth = fm->getCharWidth('0');
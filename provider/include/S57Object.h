@@ -36,7 +36,10 @@
 #include "S52Data.h"
 #include "S52Rules.h"
 #include "OcAllocator.h"
+#include "CompactGeometry.h"
+#include "GeometryLod.h"
 #include "ObjectDescription.h"
+#include "RenderHelper.h"
 
 class S57BaseObject{
     public:
@@ -68,10 +71,71 @@ public:
         using StringTranslator=std::function<String(const String&)>;
         typedef ocalloc::Vector<const s52::Rule *> ARuleList;
         typedef ocalloc::Map<uint32_t, ARuleList> RuleMap;
+        /**
+         * a rule compiled for this object in prepareRender
+         * all names, colors and parameters are already resolved
+         * symbols, fonts and the sounding style are kept in tables of the S52Data,
+         * the command only stores the index
+         */
+        class DrawCommand{
+            public:
+            typedef enum : uint8_t{
+                C_NONE,
+                C_AREA,         //value: color
+                C_AREA_PATTERN, //value: symbol index
+                C_SYMBOL,       //value: symbol index
+                C_TEXT,         //value: text key, param: text group
+                C_SOUNDINGS,    //-
+                C_SOUNDING,     //depth
+                C_ARC,          //value: arc key
+                C_LINE,         //value: color, param: width, dash
+                C_SYMBOL_LINE   //value: symbol handle index
+            } Type;
+            typedef enum : uint8_t{
+                D_NONE,
+                D_DOTT,
+                D_DASH
+            } DashType;
+            uint32_t value=0;
+            float depth=0;
+            uint16_t param=0;
+            Type type=C_NONE;
+            uint8_t step=s52::RS_NONE;
+            DashType dash=D_NONE;
+        };
+        typedef ocalloc::Vector<DrawCommand> DrawCommands;
+        /**
+         * the commands of one step
+         */
+        class CommandRange{
+            public:
+            const DrawCommand *first=nullptr;
+            const DrawCommand *last=nullptr;
+            const DrawCommand *begin() const { return first;}
+            const DrawCommand *end() const { return last;}
+            bool empty() const { return first == last;}
+        };
         RenderObject(ocalloc::PoolRef p,S57Object::ConstPtr o);
-        void Render(RenderContext &, DrawingContext &ctx, Coord::TileBox const &tile, const s52::RenderStep &step) const;
-        void RenderSingleRule(RenderContext &, DrawingContext &ctx, Coord::TileBox const &tile, const s52::Rule *rule) const;
+        /**
+         * s52data must be the S52Data used for expand
+         * as the commands refer to its tables
+         */
+        void Render(RenderContext &, DrawingContext &ctx, Coord::TileBox const &tile, const s52::S52Data *s52data, const s52::RenderStep &step) const;
+        void RenderCommand(RenderContext &, DrawingContext &ctx, Coord::TileBox const &tile, const s52::S52Data *s52data, const DrawCommand &command) const;
+        /**
+         * the compiled commands of a step in the rule order within the step
+         */
+        CommandRange GetCommands(s52::RenderStep step) const;
         bool Intersects(const Coord::PixelBox &pixelExtent, Coord::TileBox const &tile) const;
+        /**
+         * the world extent used for the spatial index
+         * together with GetPixelMargin it covers everything Intersects considers
+         */
+        Coord::Extent GetIndexExtent() const;
+        /**
+         * the max number of pixels the object could extend beyond its index extent
+         */
+        int GetPixelMargin() const;
         void SetLUP(const s52::LUPrec *lup) { this->lup = lup; }
         int GetDisplayPriority() const
         {
@@ -84,67 +148,51 @@ public:
         s52::DisCat getDisplayCat() const;
         bool shouldRenderCat(const RenderSettings *rs) const; //check display category, muts be called after expand
         bool shouldRenderScale(const RenderSettings *rs,int scale) const;
+        /**
+         * the largest scale the object is rendered at (INT_MAX: all)
+         * shouldRenderScale is equivalent to scale <= GetMaxScale
+         */
+        int GetMaxScale(const RenderSettings *rs) const;
         bool hasRuleInStep(const s52::RenderStep &step) const{
-            auto &&it=stepRules.find(step);
-            return (it != stepRules.end());
+            return ! GetCommands(step).empty();
         }
         //get an object description
         //if the object would really render (could return empty)
         ObjectDescription::Ptr getObjectDescription(RenderContext &ctx, DrawingContext &draw,
-                const Coord::TileBox &box,bool overview, StringTranslator translator) const;
+                const Coord::TileBox &box,const s52::S52Data *s52data,bool overview, StringTranslator translator) const;
     protected:
         ocalloc::PoolRef pool;
         S57Object::ConstPtr object;
         const s52::LUPrec *lup = nullptr;
         RuleMap condRules; //late resolved conditional rules
-        RuleMap stepRules; //build a list of rules for each step in prepareRender
         Coord::PixelBox pixelExtent; //extent relative to the point for point objects
         int xmargin=0; //if we do not use a pixel extent we add this to the translated extent
         int ymargin=0; //to add some pixels around the extent when checking for render
         ocalloc::Map<uint32_t,s52::DisplayString> expandedTexts; //expanded texts for TE/TX
         ocalloc::Map<uint32_t,s52::Arc> arcs;
+        DrawCommands commands; //compiled at the end of expand, ordered by step
+        bool compileRule(const s52::S52Data *s52data, const s52::Rule *rule, DrawCommand &command) const;
         s52::DisCat displayCategory=s52::DisCat::UNDEFINED; //can be overwritten by special rule and will win against LUP cat
-        void addRuleToStep(const s52::Rule *rule){
-            int step=rule->getRenderStep();
-            auto clist=stepRules.find(step);
-            if (clist == stepRules.end()){
-                ARuleList steplist(pool);
-                steplist.push_back(rule);
-                stepRules.set(step,steplist);
-            }
-            else{
-                clist->second.push_back(rule);
-            }
-        }
     };
 
+    /**
+     * a triangle list of an area
+     * the points are stored in the CompactGeometry of the chart
+     */
     class VertexList
     {
 
     public:
-        using Ptr=std::shared_ptr<VertexList>;
+        static const constexpr uint32_t NO_LOD=UINT32_MAX;
         uint8_t type = 0;
-        int numAreaPoints = 0;
-        int idx = 0;
-        int capacity = 0;
-        ocalloc::Vector<Coord::WorldXy> points;
+        uint32_t numAreaPoints = 0;
+        uint32_t offset = 0; //offset in the geometry
         Coord::Extent extent;
-        VertexList(uint8_t t, int capacity, ocalloc::PoolRef p) : type(t),points(p) {
-            this->capacity=capacity;
-            points.reserve(capacity);
-        }
-        ~VertexList(){
-            
-        }
-        void add(Coord::WorldXy point)
-        {
-            if (numAreaPoints >= capacity)
-                throw InvalidDataException("cannot add point to area");
-            this->points.push_back(point);
-            this->extent.extend(point);
-            numAreaPoints++;
-        }
-    
+        //snapped triangle lists (type 4) for the GeometryLod levels
+        //NO_LOD: use the full list
+        uint32_t lodNumPoints[GeometryLod::NUM_LEVELS]={NO_LOD,NO_LOD,NO_LOD};
+        uint32_t lodOffset[GeometryLod::NUM_LEVELS]={0,0,0};
+        VertexList(uint8_t t, uint32_t o) : type(t), offset(o) {}
     };
 
     class Sounding: public Coord::WorldXy{
@@ -155,7 +203,7 @@ public:
         }
         float depth=0;
     };
-    typedef ocalloc::Vector<VertexList::Ptr> Area;
+    typedef ocalloc::Vector<VertexList> Area;
     class Soundings : public ocalloc::Vector<Sounding>{
         public:
         using base=ocalloc::Vector<Sounding>;
@@ -201,11 +249,23 @@ public:
         using SegmentIterator=std::function<void(Coord::WorldXy first, Coord::WorldXy last, bool isFirst)>;
         LineSegment startSegment;
         LineSegment endSegment;
-        ocalloc::Vector<Coord::WorldXy> *edgeNodes=nullptr;
-        bool hasPoints(){return startSegment.valid||endSegment.valid|| (edgeNodes && edgeNodes->size() >0);}
+        //span in the contiguous edge point array of the chart
+        const Coord::WorldXy *edgeNodes=nullptr;
+        uint32_t numEdgeNodes=0;
+        class EdgeSpan{
+            public:
+            const Coord::WorldXy *nodes=nullptr;
+            uint32_t num=0;
+        };
+        //simplified edges for the GeometryLod levels (first and last node unchanged)
+        EdgeSpan lod[GeometryLod::NUM_LEVELS];
+        bool hasPoints(){return startSegment.valid||endSegment.valid|| numEdgeNodes >0;}
         Coord::WorldXy firstPoint() const;
         Coord::WorldXy lastPoint() const;
-        void iterateSegments(SegmentIterator it, bool backward=false) const;
+        /**
+         * @param level the GeometryLod level, -1 for the full geometry
+         */
+        void iterateSegments(SegmentIterator it, bool backward=false, int level=-1) const;
     };
     /**
      * the polygon has the reference to the line segments that
@@ -231,13 +291,14 @@ public:
         Polygon(const S57Object *o, int s,int e, Winding w,bool complete=true):
             startIndex(s),endIndex(e),winding(w),isComplete(complete),obj(o){}
         bool pointInPolygon(const Coord::WorldXy &p) const;
-        void iterateSegments(LineIndex::SegmentIterator i,bool backwards=false) const;
+        void iterateSegments(LineIndex::SegmentIterator i,bool backwards=false, int level=-1) const;
 
     };
     
     using LineIndexes=ocalloc::Vector<LineIndex>;
     using Polygons=ocalloc::Vector<Polygon>;
     Area area;
+    const CompactGeometry *geometry=nullptr; //owned by the chart, holds the area points
     Soundings soundigs;
     LineIndexes lines;
     Polygons polygons;
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Vectorized span kernels
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _SPANKERNELS_H
+#define _SPANKERNELS_H
+#include <vector>
+#include <stdint.h>
+#include "Types.h"
+
+/**
+ * the inner loops of the drawing context working on
+ * one span (a row of pixels)
+ * there are several implementations (scalar, SSE2, AVX2, NEON)
+ * the best one available on the running cpu is selected at runtime
+ * all implementations give exactly the same results as blendPixel
+ */
+class SpanKernels{
+    public:
+    using ColorAndAlpha=uint32_t;
+    //fill num pixels with color
+    using FillFunction=void (*)(ColorAndAlpha *dst, int num, ColorAndAlpha color);
+    //blend color over num pixels
+    using BlendColorFunction=void (*)(ColorAndAlpha *dst, int num, ColorAndAlpha color);
+    //blend num source pixels over dst (symbol rows, pattern rows)
+    using BlendFunction=void (*)(ColorAndAlpha *dst, const ColorAndAlpha *src, int num);
+    //blend color with the alpha values from src over dst (glyphs)
+    using GlyphFunction=void (*)(ColorAndAlpha *dst, const uint8_t *src, int num, ColorAndAlpha color);
+    class Kernels{
+        public:
+        const char *name;
+        FillFunction fill;
+        BlendColorFunction blendColor;
+        BlendFunction blend;
+        GlyphFunction glyph;
+    };
+    /**
+     * the kernels to be used
+     */
+    static const Kernels *get();
+    /**
+     * all kernels that can run on this cpu, the scalar ones first
+     */
+    static std::vector<const Kernels *> available();
+    /**
+     * @return nullptr if not available
+     */
+    static const Kernels *find(const String &name);
+    /**
+     * blend src over dst (A over B)
+     */
+    static inline ColorAndAlpha blendPixel(ColorAndAlpha dst, ColorAndAlpha src){
+        //some initial checks to speed up for common cases
+        if (src == 0) return dst;
+        if (dst == 0) return src;
+        if ((src & 0xff000000) == 0xff000000) return src;
+        return blendImpl(dst,src);
+    }
+    static ColorAndAlpha blendImpl(ColorAndAlpha dst, ColorAndAlpha src);
+    //table for 255*256/x
+    static const uint32_t factors[256];
+};
+#endif
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Static spatial index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#ifndef _SPATIALINDEX_H
+#define _SPATIALINDEX_H
+#include <vector>
+#include "Coordinates.h"
+#include "OcAllocator.h"
+#include "PackedRTree.h"
+
+/**
+ * the spatial index over the objects of a chart
+ * the index is built once and can afterwards be queried from
+ * multiple threads
+ */
+class SpatialIndex{
+    public:
+    using IdList=std::vector<uint32_t>;
+    SpatialIndex(ocalloc::PoolRef pool);
+    /**
+     * add an entry, only valid before build
+     */
+    void add(const Coord::Extent &extent, uint32_t id);
+    void build();
+    /**
+     * find all ids with an extent intersecting box
+     * the ids are appended to result in undefined order
+     */
+    void query(const Coord::Extent &box, IdList &result) const;
+    size_t size() const { return tree.size();}
+    protected:
+    class Entry{
+        public:
+        Coord::Extent extent;
+        uint32_t id;
+        Entry(const Coord::Extent &e,uint32_t i):extent(e),id(i){}
+    };
+    class Traits{
+        public:
+        using Summary=PackedRTreeNoSummary;
+        static const Coord::Extent &extent(const Entry &e){ return e.extent;}
+    };
+    PackedRTree<Entry,Traits,ocalloc::Vector> tree;
+};
+#endif
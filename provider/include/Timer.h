@@ -131,6 +131,13 @@ public:
             if (setLast)
                 last = now;
         }
+        /**
+         * add an externally measured duration
+         */
+        void addValue(const String &e, int64_t micros, int idx = -1)
+        {
+            items.push_back(Entry(e, micros, idx));
+        }
         SteadyTimePoint current()
         {
             return last;
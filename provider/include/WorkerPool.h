@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Bounded worker pool
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#ifndef _WORKERPOOL_H
+#define _WORKERPOOL_H
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include "SimpleThread.h"
+#include "Types.h"
+#include "ItemStatus.h"
+
+/**
+ * a fixed number of threads working on a queue of tasks
+ */
+class WorkerPool : public ItemStatus{
+    public:
+    using Ptr=std::shared_ptr<WorkerPool>;
+    using Task=std::function<void(void)>;
+    WorkerPool(const String &name,int numThreads);
+    virtual ~WorkerPool();
+    /**
+     * queue a task, exceptions thrown by the task are logged
+     * tasks that never run (pool stopped) are destroyed without running,
+     * so cleanup can be done in the destructors of captured objects
+     * @return false if the pool is already stopped
+     */
+    bool            Submit(Task task);
+    /**
+     * run all tasks using the pool threads and the calling thread
+     * and wait until they are finished
+     * tasks not picked up by the pool (busy, stopped) are run by the caller
+     * the first exception thrown by a task is rethrown
+     */
+    void            RunAll(const std::vector<Task> &tasks);
+    /**
+     * stop all threads, queued tasks are dropped (destroyed without running)
+     */
+    void            Stop();
+    int             GetNumThreads() const {return numThreads;}
+    virtual void    ToJson(StatusStream &stream) override;
+    private:
+    class RunAllState;
+    void            run();
+    String          name;
+    int             numThreads;
+    std::mutex      lock;
+    Condition       waiter;
+    std::deque<Task> queue;
+    std::vector<std::thread> threads;
+    bool            stopped=false;
+    std::atomic<int> numRunning={0};
+    std::atomic<long> numDone={0};
+};
+#endif
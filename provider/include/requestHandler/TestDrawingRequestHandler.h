@@ -157,9 +157,8 @@ public:
             }
             if (StringHelper::startsWith(type,"symarea") && points.size()>=3){
                 if (symbol){
-                    DrawingContext::PatternSpec pattern(symbol->buffer.get()->data(),symbol->width,symbol->height);
-                    pattern.distance=symbol->minDist;
-                    pattern.stagger=symbol->stagger;
+                    DrawingContext::PatternTexture::ConstPtr texture=symbol->getPatternTexture();
+                    DrawingContext::PatternSpec pattern(texture.get());
                     for (int i=0;i<(points.size()-2);i+=3){
                         drawing->drawTriangle(points[i],points[i+1],points[i+2],color,&pattern);
                     }
@@ -30,14 +30,71 @@
 #include "S52Data.h"
 #include "tinyxml2.h"
 #include <memory>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include "SimpleThread.h"
+#include "ItemStatus.h"
 namespace s52
 {
     class RuleConditions;
+    /**
+     * cache for the output of conditional procedures
+     * the key is built from the inputs a procedure declares (see S52CondRules::cacheKey)
+     * it does not depend on a particular S52Data and is handed over
+     * to the next S52Data on settings changes
+     */
+    class CondRuleCache : public ItemStatus
+    {
+    public:
+        typedef std::shared_ptr<CondRuleCache> Ptr;
+        static const constexpr size_t MAX_ENTRIES = 100000;
+        bool get(const String &key, String &expanded);
+        void add(const String &key, const String &expanded);
+        virtual void ToJson(StatusStream &stream);
+
+    protected:
+        std::mutex lock;
+        std::unordered_map<String, String> cache;
+        std::atomic<long> hits = {0};
+        std::atomic<long> misses = {0};
+    };
     class S52CondRules
     {
     public:
         static String expand(const LUPrec *lup, const String &rule, const S52Data *s52data, const RuleConditions *conditions = NULL);
+        /**
+         * append the cache key for a conditional rule to key
+         * the key contains the rule and all inputs the procedure declares
+         * @return false if the result cannot be cached
+         */
+        static bool cacheKey(const LUPrec *lup, const String &rule, const S52Data *s52data, const RuleConditions *conditions, String &key);
 
+        /**
+         * the inputs a procedure depends on
+         * beside the rule string itself
+         */
+        class Inputs
+        {
+        public:
+            typedef enum
+            {
+                I_NONE = 0,
+                I_OBCL = 1 << 0,           // object class of the LUP
+                I_GEO = 1 << 1,            // geo primitive
+                I_FLOATING_BASE = 1 << 2,  // hasFloatingBase
+                I_NEXT_SAFETY = 1 << 3,    // next safety contour of the chart
+                I_FEATURE = 1 << 4,        // feature type code
+                S_SAFETY_CONTOUR = 1 << 5, // settings: safety contour
+                S_DEPTH_SHADES = 1 << 6,   // settings: two shades, shallow, deep contour
+                S_DEPTH_UNIT = 1 << 7,     // settings: depth unit
+                S_SYMBOL_SCALE = 1 << 8,   // settings: symbol scale
+                S_BOUNDARY_STYLE = 1 << 9  // settings: boundary style
+            } Flags;
+            int flags = I_NONE;
+            std::vector<uint16_t> attributes;
+            Inputs(int f = I_NONE, const std::vector<uint16_t> &a = std::vector<uint16_t>()) : flags(f), attributes(a) {}
+        };
     protected:
         class Rule
         {
@@ -52,10 +109,13 @@ namespace s52
                 T_STEP2  // depends on object
             } Type;
             Type type;
+            Inputs inputs;
             Rule(RuleFunction f, Type t = T_STEP2) : function(f), type(t) {}
+            Rule(RuleFunction f, const Inputs &i) : function(f), type(T_STEP2), inputs(i) {}
         };
         static Rule::Map rules;
+        static Rule::Map::const_iterator findRule(const String &rule);
     };
 }
 
-#endif
\ No newline at end of file
+#endif
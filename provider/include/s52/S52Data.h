@@ -38,11 +38,15 @@
 #include "FontManager.h"
 #include "OcAllocator.h"
 #include "S52SymbolCache.h"
+#include <unordered_map>
+#include <atomic>
+#include <functional>
 #include "StatusCollector.h"
 #include "RenderSettings.h"
 #include "MD5.h"
 namespace s52
 {       
+    class AttributeCondition;
     class Attribute{
         public:
         typedef enum{
@@ -109,6 +113,15 @@ namespace s52
          * compare with an attribute value from a lookup rule
         */
         bool equals(const String &os) const;
+        /**
+         * same as equals but with a pre-parsed LUP value
+         */
+        bool equals(const AttributeCondition &condition) const;
+        /**
+         * append type and value to a signature
+         * equal signatures will match the same LUP attributes
+         */
+        void addToSignature(String &signature) const;
 
         Type getType() const { return type;}
 
@@ -171,6 +184,24 @@ namespace s52
         }
     };
 
+    /**
+     * a LUP attribute value parsed when the rules are frozen
+     */
+    class AttributeCondition{
+        public:
+        typedef enum{
+            C_ANY,    //empty or " ": any value matches
+            C_ABSENT, //"?": the object must not have the attribute
+            C_VALUE
+        } Mode;
+        uint16_t id=0;
+        Mode mode=C_VALUE;
+        int iv=0;
+        double dv=0;
+        String sv;
+        AttributeCondition(uint16_t id,const String &value);
+    };
+
     typedef enum {
             RS_AREAS1=1, //AC rules only
             RS_AREASY=2,
@@ -199,6 +230,9 @@ namespace s52
                                   //  the PLIB file
         RuleList ruleList;        // rasterization rule list
         RenderStep step;          //one of RS_AREAS2,RS_LINES,RS_POINTS
+        std::vector<AttributeCondition> conditions; //parsed ATTCArray
+        bool conditionsParsed=false;
+        void parseConditions();
         int attributeMatch(const Attribute::Map *objectAttributes) const;
     };
     class LUPRecords : public std::vector<LUPrec> {
@@ -206,6 +240,27 @@ namespace s52
         using std::vector<LUPrec>::vector;
         using Ptr=std::shared_ptr<LUPRecords>;
     };
+    /**
+     * the LUP selection for one table and feature type
+     * built when the rules are frozen
+     * results are cached by the values of the attributes
+     * that are used in any of the LUPs
+     */
+    class LUPSelector{
+        public:
+        using Ptr=std::shared_ptr<LUPSelector>;
+        static const constexpr size_t MAX_CACHE_ENTRIES=4096;
+        LUPSelector(const LUPRecords &records);
+        const LUPrec *find(const Attribute::Map *attributes,bool &cacheHit);
+        private:
+        const LUPrec *noAttrMatch=nullptr; //first LUP without attributes
+        std::vector<const LUPrec*> candidates; //LUPs with attributes
+        std::vector<uint16_t> relevantIds;
+        std::mutex lock;
+        std::unordered_map<String,const LUPrec*> cache;
+        const LUPrec *compute(const Attribute::Map *attributes) const;
+        String signature(const Attribute::Map *attributes) const;
+    };
     
     class LUPMap: public std::map<uint16_t,LUPRecords::Ptr> {
         public:
@@ -289,6 +344,79 @@ namespace s52
         static constexpr const char * PR_CAT() { return "XC";} //display category
     };
 
+    /**
+     * the resolved font and colors for soundings
+     */
+    class SoundingStyle{
+        public:
+        FontManager::Ptr fm;
+        DrawingContext::ColorAndAlpha cDeep=0;
+        DrawingContext::ColorAndAlpha cShallow=0;
+    };
+
+    /**
+     * entries referenced by the compiled draw commands of the charts
+     * the commands only keep the index
+     * entries are only added and never moved, so readers
+     * can access an index they got from add without a lock
+     * the chunks double in size, so the table never runs full in practice
+     */
+    template<class K, class T>
+    class CommandTable{
+        public:
+        static const constexpr uint32_t NO_INDEX=UINT32_MAX;
+        static const constexpr uint32_t CHUNK_SIZE=1024; //size of the first chunk
+        static const constexpr uint32_t MAX_CHUNKS=22; //CHUNK_SIZE*(2^MAX_CHUNKS-1) < 2^32
+        static const constexpr uint64_t MAX_ENTRIES=((uint64_t)CHUNK_SIZE)*((((uint64_t)1) << MAX_CHUNKS)-1);
+        /**
+         * @return the index of the entry for key, NO_INDEX if the table is full
+         */
+        uint32_t add(const K &key, const T &value){
+            Synchronized l(lock);
+            auto it=indices.find(key);
+            if (it != indices.end()) return it->second;
+            uint32_t idx=num;
+            if (idx >= MAX_ENTRIES){
+                if (! fullReported){
+                    LOG_ERROR("command table full with %d entries, dropping further entries",idx);
+                    fullReported=true;
+                }
+                return NO_INDEX;
+            }
+            uint32_t chunkIdx;
+            uint32_t offset;
+            locate(idx,chunkIdx,offset);
+            std::unique_ptr<T[]> &chunk=chunks[chunkIdx];
+            if (! chunk) chunk.reset(new T[CHUNK_SIZE << chunkIdx]);
+            chunk[offset]=value;
+            indices[key]=idx;
+            num=idx+1;
+            return idx;
+        }
+        const T *get(uint32_t idx) const{
+            if (idx >= num) return nullptr;
+            uint32_t chunkIdx;
+            uint32_t offset;
+            locate(idx,chunkIdx,offset);
+            return &(chunks[chunkIdx][offset]);
+        }
+        uint32_t size() const{ return num;}
+        private:
+        //chunk k holds CHUNK_SIZE*2^k entries starting at CHUNK_SIZE*(2^k-1)
+        static inline void locate(uint32_t idx, uint32_t &chunkIdx, uint32_t &offset){
+            uint32_t n=idx/CHUNK_SIZE+1;
+            chunkIdx=31-__builtin_clz(n);
+            offset=idx-CHUNK_SIZE*((((uint32_t)1) << chunkIdx)-1);
+        }
+        std::mutex lock;
+        std::unordered_map<K,uint32_t> indices;
+        std::unique_ptr<T[]> chunks[MAX_CHUNKS];
+        std::atomic<uint32_t> num={0};
+        bool fullReported=false;
+    };
+
+    class CondRuleCache;
+    class RuleConditions;
     class S52Data : public StatusCollector
     {
     public:
@@ -310,8 +438,46 @@ namespace s52
         void addSymbol(const String &name, const SymbolPosition &symbol);
         void addVectorSymbol(const String &name, const VectorSymbol &symbol);
         void buildRules();
+        bool rulesFrozen() const { return froozenRules;}
+        static const constexpr size_t MAX_INTERNED_RULES=200000;
+        /**
+         * get a rule from the intern table, create it if not found
+         * the rules are shared by all charts using this S52Data
+         * @param interned false if the table is full
+         * @return the rule, nullptr if the rule is invalid
+         */
+        const Rule *internRule(const LUPrec *lup,RenderStep rs,const String &ruleStr,bool &interned) const;
+        static const constexpr size_t MAX_COND_RULE_LISTS=200000;
+        /**
+         * expand a conditional rule (CS(...)) using the cached rule lists
+         * the lists are keyed by the inputs of the procedure
+         * @return false if the rule cannot be handled from the cache
+         */
+        bool expandCondRule(const LUPrec *lup,const String &rule,const RuleConditions *conditions,std::function<void (const Rule *)> writer) const;
+        /**
+         * continue with the procedure results of a previous S52Data
+         * must be called before the S52Data is used
+         */
+        void shareCondCache(const S52Data &other);
         const SymbolPtr getSymbol(const String &name, int rotation=0, double scale=-1) const;
+        /**
+         * resolve a symbol name once to get rotated symbols later on without
+         * a name lookup
+         */
+        SymbolCache::Handle getSymbolHandle(const String &name) const;
+        const SymbolPtr getSymbol(const SymbolCache::Handle &handle, int rotation=0, double scale=-1) const;
         String checkSymbol(const String &name) const;
+        static const constexpr uint32_t NO_COMMAND_INDEX=UINT32_MAX;
+        /**
+         * symbols and symbol handles for the compiled draw commands
+         * the commands only store the index (NO_COMMAND_INDEX if the table is full)
+         * the entries are kept as long as this S52Data
+         */
+        uint32_t getCommandSymbolIndex(SymbolPtr symbol) const;
+        const SymbolData *getCommandSymbol(uint32_t index) const;
+        uint32_t getCommandSymbolHandleIndex(const String &name) const;
+        const SymbolCache::Handle *getCommandSymbolHandle(uint32_t index) const;
+        const SoundingStyle &getSoundingStyle() const { return soundingStyle;}
         TESTVIRT MD5Name getMD5() const;
         TESTVIRT int getSequence() const;
         TESTVIRT RenderSettings::ConstPtr getSettings() const { return renderSettings;}
@@ -323,6 +489,10 @@ namespace s52
             FONT_SOUND=1
         };
         FontManager::Ptr getFontManager(FontType type, int size=16) const;
+        /**
+         * the font manager for draw commands, resolved in init
+         */
+        const FontManager::Ptr &getCommandFont(FontType type) const { return commandFonts[type];}
         /**
          * convert sounding if the attrid matches
          * 0 - always convert
@@ -342,6 +512,27 @@ namespace s52
         typedef std::map<String,SymbolPosition> SymbolMap;
         ColorTables colorTables;
         LUPTables lupTables;
+        //selectors by table and feature type, see selectorKey
+        std::unordered_map<uint32_t,LUPSelector::Ptr> lupSelectors;
+        static uint32_t selectorKey(const LUPname &name,uint16_t featureTypeCode){
+            return (((uint32_t)name) << 16) | featureTypeCode;
+        }
+        mutable std::mutex internLock;
+        mutable std::unordered_map<String,const Rule*> internedRules; //key: step + rule string
+        mutable std::atomic<long> internHits={0};
+        using CondRuleList=std::vector<const Rule*>;
+        std::shared_ptr<CondRuleCache> condCache;
+        mutable std::mutex condLock;
+        mutable std::unordered_map<String,CondRuleList> condRuleLists; //key: step + S52CondRules::cacheKey
+        mutable std::atomic<long> condHits={0};
+        mutable std::atomic<long> condMisses={0};
+        /**
+         * intern all rules of a rule string
+         * @return false if the intern table is full
+         */
+        bool internRules(const LUPrec *lup,RenderStep rs,const String &ruleStr,CondRuleList &rules) const;
+        mutable std::atomic<long> lupCacheHits={0};
+        mutable std::atomic<long> lupCacheMisses={0};
         RenderSettings::ConstPtr renderSettings;
         SymbolMap symbolMap;
         void createRulesForLup(LUPrec &lup);
@@ -351,6 +542,10 @@ namespace s52
         using FontManagers=std::map<int,FontManager::Ptr>;
         FontManagers fontManagers;
         SymbolCache::Ptr symbolCache;
+        mutable CommandTable<const SymbolData*,SymbolPtr> commandSymbols;
+        mutable CommandTable<String,SymbolCache::Handle> commandSymbolHandles;
+        FontManager::Ptr commandFonts[2];
+        SoundingStyle soundingStyle;
         virtual bool LocalJson(StatusStream &stream);
         int sequence=0;
         FontFileHolder::Ptr fontFile;
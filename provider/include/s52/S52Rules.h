@@ -128,7 +128,18 @@ namespace s52
                 ruleList.push_back(rt);
                 return rt;    
             }
+            /**
+             * create the rules from a rule string
+             * once the rules of s52data are frozen the rules are taken from
+             * the s52data intern table, this creator is only used if the table is full
+             * conditional rules are expanded from the cached rule lists of s52data
+             */
             void rulesFromString(const LUPrec *lup,const String &ruleStr,const S52Data *s52data,std::function<void (const s52::Rule *)>,bool tryExpansion,const RuleConditions *conditions=NULL);
+            /**
+             * create a single rule (no expansion of conditional rules)
+             * @return nullptr for invalid rules
+             */
+            const Rule *createRule(const LUPrec *lup, RenderStep rs, const String &ruleStr,const S52Data *s52data);
     };
 
     template<s52::RuleType id>
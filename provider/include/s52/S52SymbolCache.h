@@ -74,9 +74,47 @@ namespace s52{
             if (buffer){
                 rt+=buffer->size()*sizeof(DrawingContext::ColorAndAlpha);
             }
+            auto texture=std::atomic_load(&pattern.texture);
+            if (texture){
+                rt+=texture->numBytes();
+            }
             return rt;
         }
+        /**
+         * get the pattern texture for area fills
+         * it is created on first use and kept with the symbol
+         * (i.e. until the settings change)
+         */
+        DrawingContext::PatternTexture::ConstPtr getPatternTexture() const{
+            DrawingContext::PatternTexture::ConstPtr rt=std::atomic_load(&pattern.texture);
+            if (rt || ! buffer) return rt;
+            DrawingContext::PatternTexture::ConstPtr created=std::make_shared<DrawingContext::PatternTexture>(buffer->data(),width,height,minDist,stagger);
+            //only the first thread stores its texture and accounts for it
+            if (! std::atomic_compare_exchange_strong(&pattern.texture,&rt,created)) return rt;
+            if (memCounter) *memCounter+=created->numBytes();
+            return created;
+        }
         DataPtr buffer;
+        using MemCounter=std::shared_ptr<std::atomic<uint64_t>>;
+        /**
+         * the memory usage of the owning cache
+         * textures are created after the symbol has been added
+         * so we count them when creating them
+         */
+        MemCounter memCounter;
+        private:
+        /**
+         * copies of a symbol (rotate, scale) get their own data
+         * so never copy the texture
+         */
+        class TextureHolder{
+            public:
+            DrawingContext::PatternTexture::ConstPtr texture; //only access via the atomic functions
+            TextureHolder(){}
+            TextureHolder(const TextureHolder &){}
+            TextureHolder & operator=(const TextureHolder &){ texture.reset(); return *this;}
+        };
+        mutable TextureHolder pattern;
     };
     using SymbolPtr=std::shared_ptr<SymbolData>;
     //-- SYMBOLISATION MODULE STRUCTURE -----------------------------
@@ -150,7 +188,19 @@ namespace s52{
         };
         public:
         using Ptr=std::shared_ptr<SymbolCache>;
+        /**
+         * a resolved symbol name
+         * allows to get (rotated) symbols without looking up the name again
+         */
+        class Handle{
+            friend class SymbolCache;
+            SymbolBase::Ptr base;
+            public:
+            bool valid() const { return (bool)base;}
+        };
         SymbolPtr getSymbol(const String &name,GetColorFunction colorGet, int rotation=0,double scale=-1);
+        Handle getHandle(const String &name);
+        SymbolPtr getSymbol(const Handle &handle,GetColorFunction colorGet, int rotation=0,double scale=-1);
         String checkSymbol(const String &name);
         bool fillRasterSymbol(const String &name,const SymbolPosition &position, PngReader *reader, double scale);
         bool fillVectorSymbol(const String &name,const VectorSymbol &position,double scale);
@@ -163,7 +213,7 @@ namespace s52{
         std::mutex lock;
         BaseMap baseMap;
         std::atomic<uint32_t> symbolEntries={0};
-        std::atomic<uint64_t> memUsage={0};
+        SymbolData::MemCounter memUsage=std::make_shared<std::atomic<uint64_t>>(0);
     };
 
 }
@@ -27,6 +27,7 @@
 #include "ChartCache.h"
 #include "Logger.h"
 #include "SystemHelper.h"
+#include "PrefetchInputStream.h"
 #include <algorithm>
 
 ChartCache::ChartCache(IChartFactory::Ptr factory, long loadWaitMillis)
@@ -179,6 +180,12 @@ Chart::ConstPtr ChartCache::LoadInternal(s52::S52Data::ConstPtr s52data,ChartSet
     }
     LOG_INFO("load chart for render %s", fileName.c_str());
     InputStream::Ptr chartStream = factory->OpenChartStream(chart, chartSet, fileName);
+    PrefetchInputStream::Ptr prefetch;
+    if (chartStream && ! chartStream->IsMapped()){
+        //overlap receiving the data with parsing
+        prefetch=std::make_shared<PrefetchInputStream>(chartStream);
+        chartStream=prefetch;
+    }
     bool readResult = chart->ReadChartStream(chartStream, s52data, false);
     chart->LogInfo("readChartStream");
     if (!readResult)
@@ -187,8 +194,15 @@ Chart::ConstPtr ChartCache::LoadInternal(s52::S52Data::ConstPtr s52data,ChartSet
         throw AvException(FMT("unable to read chart from stream %s", fileName));
     }
     measure.add("read");
+    if (prefetch){
+        prefetch->close();
+        measure.addValue("transfer",prefetch->GetTransferMicros());
+        measure.addValue("readWait",prefetch->GetWaitMicros());
+        prefetch.reset();
+    }
+    chartStream.reset();
     LOG_DEBUG("chart %s prepare render", chart->GetFileName());
-    chart->PrepareRender(s52data);
+    chart->PrepareRender(s52data,prepareWorkers);
     chart->LogInfo("prepareRender");
     measure.add("prepare");
     UpdateChart(s52data, chartSetKey, fileName, chart);
@@ -76,11 +76,11 @@ InputStream::Ptr ChartFactory::OpenChartStream(Chart::ConstPtr chart,
                 }
                 OexControl::OexCommands command=headerOnly?chart->OpenHeaderCmd():chart->OpenFullCmd();
                 if (command == OexControl::CMD_UNKNOWN){
-                    return FileHelper::openFileStream(fileName,4096);    
+                    return FileHelper::openMappedFileStream(fileName,4096);    
                 }
                 String key=chartSet->GetChartKey(chart->GetType(), fileName);
                 if (! testKey.empty() && key == testKey ){
-                    return FileHelper::openFileStream(fileName,4096);
+                    return FileHelper::openMappedFileStream(fileName,4096);
                 }
                 LOG_DEBUG("opening chart stream for %s with key %s",fileName.c_str(),key.c_str());
                 return oexcontrol->SendOexCommand(command,fileName,key);
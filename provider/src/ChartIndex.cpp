@@ -0,0 +1,63 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Chart Index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "ChartIndex.h"
+#include <algorithm>
+
+ChartIndex::ChartIndex(const std::vector<ChartInfo::Ptr> &charts){
+    size_t order=0;
+    for (const auto &info : charts){
+        order++;
+        if (!info || !info->IsValid() || info->IsIgnored()) continue;
+        Coord::Extent extent=info->GetExtent();
+        //HasTile would never return those
+        if (!extent.valid || info->GetNativeScale() <= 0) continue;
+        tree.add(extent,info->GetNativeScale(),order,info);
+    }
+    tree.build();
+}
+
+WeightedChartList ChartIndex::Find(const Coord::Extent &extent, double minScale, double maxScale) const{
+    WeightedChartList rt;
+    std::vector<const Entry*> found;
+    tree.query(extent,[minScale,maxScale](const ScaleRange &range){
+        return range.maxScale >= minScale && range.minScale < maxScale;
+    },[&found,minScale,maxScale](const Entry &entry){
+        if (entry.scale < minScale || entry.scale >= maxScale) return;
+        found.push_back(&entry);
+    });
+    //keep the order of the chart list to get the same results
+    //as a linear search
+    std::sort(found.begin(),found.end(),[](const Entry *a, const Entry *b){
+        return a->order < b->order;
+    });
+    rt.reserve(found.size());
+    for (const auto &entry : found){
+        rt.push_back(ChartInfoWithScale(entry->scale,entry->info));
+    }
+    return rt;
+}
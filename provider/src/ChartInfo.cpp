@@ -44,6 +44,7 @@ static const double WGSinvf                           = 298.257223563;       /*
 
 
 ZoomLevelScales::ZoomLevelScales(double scaleLevel) {
+    this->scaleLevel=scaleLevel;
     double resolution=BASE_MPP * scaleLevel;
     //OpenCPN uses some correction for the major axis
     //this is no big problem anyway but we like to be consistent
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Persistent chart header index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "ChartInfoCache.h"
+#include "FileHelper.h"
+#include "Logger.h"
+#include "StringHelper.h"
+#include <fstream>
+#include <cstring>
+
+static const char MAGIC[4]={'A','V','C','I'};
+
+template<typename T>
+static void writeValue(std::ostream &stream, const T &v){
+    stream.write((const char *)&v,sizeof(T));
+}
+template<typename T>
+static bool readValue(std::istream &stream, T &v){
+    stream.read((char *)&v,sizeof(T));
+    return stream.gcount() == sizeof(T);
+}
+
+ChartInfoCache::ChartInfoCache(const String &fileName):fileName(fileName){}
+
+bool ChartInfoCache::Read(){
+    entries.clear();
+    std::ifstream stream(fileName,std::ios::binary);
+    if (! stream.is_open()){
+        LOG_DEBUG("chart info cache %s not found",fileName);
+        return false;
+    }
+    char magic[sizeof(MAGIC)];
+    uint32_t version=0;
+    uint32_t num=0;
+    stream.read(magic,sizeof(magic));
+    if (stream.gcount() != sizeof(magic) || memcmp(magic,MAGIC,sizeof(MAGIC)) != 0 ||
+        ! readValue(stream,version) || version != VERSION || ! readValue(stream,num)){
+        LOG_ERROR("invalid chart info cache %s, ignoring",fileName);
+        return false;
+    }
+    for (uint32_t i=0;i<num;i++){
+        uint32_t nameLen=0;
+        if (! readValue(stream,nameLen) || nameLen > 4096){
+            LOG_ERROR("invalid entry %d in chart info cache %s, ignoring",i,fileName);
+            entries.clear();
+            return false;
+        }
+        String name(nameLen,' ');
+        stream.read(&name[0],nameLen);
+        Entry entry;
+        uint8_t flags=0;
+        bool ok=stream.gcount() == nameLen &&
+            readValue(stream,entry.type) &&
+            readValue(stream,entry.fileSize) &&
+            readValue(stream,entry.fileTime) &&
+            readValue(stream,entry.nativeScale) &&
+            readValue(stream,entry.extent.xmin) &&
+            readValue(stream,entry.extent.xmax) &&
+            readValue(stream,entry.extent.ymin) &&
+            readValue(stream,entry.extent.ymax) &&
+            readValue(stream,flags);
+        if (! ok){
+            LOG_ERROR("invalid entry %d in chart info cache %s, ignoring",i,fileName);
+            entries.clear();
+            return false;
+        }
+        entry.extent.valid=true;
+        entry.softUnder=(flags & 1) != 0;
+        entry.ignore=(flags & 2) != 0;
+        entries[name]=entry;
+    }
+    LOG_INFO("read %d entries from chart info cache %s",(int)entries.size(),fileName);
+    return true;
+}
+
+bool ChartInfoCache::Write(const ChartSet::InfoList &charts){
+    String tmp=fileName+".tmp";
+    FileHelper::unlink(tmp);
+    std::ofstream stream(tmp,std::ios::binary);
+    if (! stream.is_open()){
+        LOG_ERROR("unable to open chart info cache %s for writing",tmp);
+        return false;
+    }
+    uint32_t num=0;
+    for (auto &&info:charts){
+        if (info && info->IsValid()) num++;
+    }
+    stream.write(MAGIC,sizeof(MAGIC));
+    writeValue(stream,VERSION);
+    writeValue(stream,num);
+    for (auto &&info:charts){
+        if (! info || ! info->IsValid()) continue;
+        String name=info->GetFileName();
+        Coord::Extent extent=info->GetExtent();
+        writeValue(stream,(uint32_t)name.size());
+        stream.write(name.c_str(),name.size());
+        writeValue(stream,(int32_t)info->GetType());
+        writeValue(stream,(int64_t)info->GetFileSize());
+        writeValue(stream,(int64_t)info->GetFileTime());
+        writeValue(stream,(int32_t)info->GetNativeScale());
+        writeValue(stream,extent.xmin);
+        writeValue(stream,extent.xmax);
+        writeValue(stream,extent.ymin);
+        writeValue(stream,extent.ymax);
+        uint8_t flags=(info->HasSoftUnder()?1:0) | (info->IsIgnored()?2:0);
+        writeValue(stream,flags);
+    }
+    stream.close();
+    if (stream.fail()){
+        LOG_ERROR("unable to write chart info cache %s",tmp);
+        FileHelper::unlink(tmp);
+        return false;
+    }
+    if (! FileHelper::rename(tmp,fileName)){
+        LOG_ERROR("unable to rename chart info cache from %s to %s",tmp,fileName);
+        return false;
+    }
+    LOG_INFO("written %d entries to chart info cache %s",(int)num,fileName);
+    return true;
+}
+
+ChartInfo::Ptr ChartInfoCache::Find(const String &chartFile) const{
+    auto it=entries.find(chartFile);
+    if (it == entries.end()) return ChartInfo::Ptr();
+    const Entry &entry=it->second;
+    ChartInfo::Ptr rt=std::make_shared<ChartInfo>((Chart::ChartType)entry.type,chartFile,
+        entry.nativeScale,entry.extent,entry.fileSize,entry.fileTime,entry.softUnder,entry.ignore);
+    if (! rt->VerifyChartFileName(chartFile)) return ChartInfo::Ptr();
+    return rt;
+}
@@ -40,20 +40,30 @@
 #define CS_INFOKEY "chartSets"
 #define S52_INFOKEY "s52data"
 ChartManager::ChartManager( FontFileHolder::Ptr f, IBaseSettings::ConstPtr bs, RenderSettings::ConstPtr rs,IChartFactory::Ptr chartFactory, 
-        String s57dataDir, unsigned int memLimitKb,int numOpeners) {
+        String s57dataDir, unsigned int memLimitKb,int numOpeners, int numReaders) {
     this->fontFile=f;        
     this->s57Dir=s57dataDir;
     this->baseSettings=bs;
     this->numOpeners=numOpeners; 
     state=STATE_INIT;
     numRead=0;
+    planCache=std::make_shared<CoveragePlanCache>(MAX_COVERAGE_PLANS);
+    AddItem("coveragePlans",planCache);
+    publishSets();
     maxPrefillPerSet=0;
     maxPrefillZoom=0;
     buildS52Data(rs);
     this->chartFactory=chartFactory;
     chartCache=std::make_shared<ChartCache>(chartFactory);
     chartCache->SetMemoryLimit(memLimitKb);
+    //the opener thread works on a prepare as well
+    int numPrepare=(int)std::thread::hardware_concurrency()-1;
+    prepareWorkers=std::make_shared<WorkerPool>("prepareWorkers",numPrepare);
+    AddItem("prepareWorkers",prepareWorkers);
+    chartCache->SetPrepareWorkers(prepareWorkers);
     chartCache->StartOpeners(numOpeners);
+    readers=std::make_shared<WorkerPool>("chartReaders",numReaders);
+    AddItem("chartReaders",readers);
     houseKeeper=std::make_shared<HouseKeeper>(chartCache,10000);
     houseKeeper->start();
 }
@@ -154,25 +164,15 @@ ChartManager::TryResult ChartManager::TryOpenChart(const String &chartFile){
 }
 
 Chart::ConstPtr ChartManager::OpenChart(const String &setName, const String &chartName, bool doWait){
-    ChartSet::Ptr chartSet;
-    {
-        Synchronized locker(lock);
-        auto it=chartSets.find(setName);
-        if (it == chartSets.end()) throw AvException(FMT("unknown chart set %s",setName));
-        chartSet=it->second;
-    }
+    ChartSet::Ptr chartSet=findSet(setName);
+    if (! chartSet) throw AvException(FMT("unknown chart set %s",setName));
     String fileName=FileHelper::concatPath(chartSet->info->dirname,chartName);
     Chart::ConstPtr rt=chartCache->GetChart(s52data,chartSet,fileName,doWait);
     return rt;
 }
 bool ChartManager::CloseChart(const String &setName, const String &chartName){
-    ChartSet::Ptr chartSet;
-    {
-        Synchronized locker(lock);
-        auto it=chartSets.find(setName);
-        if (it == chartSets.end()) throw AvException(FMT("unknown chart set %s",setName));
-        chartSet=it->second;
-    }
+    ChartSet::Ptr chartSet=findSet(setName);
+    if (! chartSet) throw AvException(FMT("unknown chart set %s",setName));
     String fileName=FileHelper::concatPath(chartSet->info->dirname,chartName);
     return chartCache->CloseChart(setName,fileName) != 0;
 }
@@ -222,67 +222,154 @@ bool ChartManager::HandleChart(const String &chartFile,ChartSet::Ptr set){
     return false;
     
 }
-ChartSet::Ptr ChartManager::ParseChartDir(const String &dir, bool canDelete)
+ChartManager::ParseJob::Ptr ChartManager::StartParseChartDir(const String &dir, bool canDelete, ParseJob::DoneFunction onDone)
 {
     LOG_INFO("parsing chart dir %s", dir);
     if (!FileHelper::exists(dir, true))
     {
         LOG_INFO("chart dir %s not found", dir);
-        return ChartSet::Ptr();
+        return ParseJob::Ptr();
     }
-    int rt = 0;
-    int all=0;
+    ParseJob::Ptr job=std::make_shared<ParseJob>();
+    job->dir=dir;
+    job->onDone=onDone;
     String key=KeyFromChartDir(dir);
-    ChartSet::Ptr chartSet=CreateChartSet(dir,canDelete);
+    job->set=CreateChartSet(dir,canDelete);
+    String cacheFile;
+    {
+        Synchronized l(lock);
+        cacheFile=ChartInfoCacheFile(key);
+    }
+    if (! cacheFile.empty()){
+        job->infoCache=std::make_shared<ChartInfoCache>(cacheFile);
+        job->infoCache->Read();
+    }
+    StringVector toRead;
     for (auto && chartFile : FileHelper::listDir(dir)){
-        all++;
-        if(HandleChart(chartFile,chartSet)) rt++;
+        job->numFiles++;
+        if (job->infoCache){
+            ChartInfo::Ptr cached=job->infoCache->Find(chartFile);
+            if (cached){
+                job->set->AddChart(cached);
+                LOG_DEBUG("adding chart %s from info cache",cached->ToString());
+                job->fromCache++;
+                job->numAdded++;
+                continue;
+            }
+        }
+        toRead.push_back(chartFile);
+    }
+    if (toRead.empty()){
+        FinishParseChartDir(job);
+        return job;
+    }
+    /**
+     * counts down the pending charts when the read task is gone
+     * this way we also finish if a task throws or is dropped
+     * (pool stopped or not able to queue)
+     */
+    class PendingGuard{
+        ChartManager *manager;
+        ParseJob::Ptr job;
+        public:
+        using Ptr=std::shared_ptr<PendingGuard>;
+        PendingGuard(ChartManager *m, ParseJob::Ptr j):manager(m),job(j){}
+        ~PendingGuard(){
+            if (--(job->pending) != 0) return;
+            try{
+                manager->FinishParseChartDir(job);
+            }catch (std::exception &e){
+                LOG_ERROR("unable to finish parsing %s: %s",job->dir,e.what());
+            }catch (...){
+                LOG_ERROR("unable to finish parsing %s",job->dir);
+            }
+        }
+    };
+    //set pending before submitting to avoid finishing early
+    job->pending=toRead.size();
+    for (auto && chartFile : toRead){
+        PendingGuard::Ptr guard=std::make_shared<PendingGuard>(this,job);
+        bool queued=readers->Submit([this,job,chartFile,guard](){
+            if (HandleChart(chartFile,job->set)) job->numAdded++;
+        });
+        if (! queued){
+            LOG_ERROR("unable to queue chart %s",chartFile);
+        }
     }
-    LOG_INFO("parsed %d/%d charts from %s",rt,all,dir);
-    return chartSet;
+    return job;
+}
+
+void ChartManager::FinishParseChartDir(ParseJob::Ptr job){
+    int numAdded=job->numAdded;
+    if (job->infoCache && (job->fromCache != numAdded || job->infoCache->GetNumEntries() != (size_t)job->fromCache)){
+        job->infoCache->Write(job->set->GetCharts());
+    }
+    LOG_INFO("parsed %d/%d charts from %s, %d from info cache",numAdded,job->numFiles,job->dir,job->fromCache);
+    if (job->onDone) job->onDone(job);
+}
+
+int ChartManager::ActivateChartSet(ChartSet::Ptr chartSet){
+    Synchronized l(lock);
+    chartSet->SetReady();
+    int numInSet=chartSet->GetNumCharts();
+    int numCharts=numRead;
+    auto existing=chartSets.find(chartSet->GetKey());
+    if (existing != chartSets.end() ){
+        numCharts-=existing->second->GetNumCharts();
+        if (numCharts < 0) numCharts=0;
+        RemoveItem(CS_INFOKEY,existing->second);
+    }
+    chartSets[chartSet->GetKey()]=chartSet;
+    AddItem(CS_INFOKEY,chartSet,true);
+    numRead=numCharts+numInSet;
+    computeActiveSets();
+    publishSets();
+    LOG_INFO("chart set %s ready with %d charts",chartSet->GetKey(),numInSet);
+    return numInSet;
 }
 
 int ChartManager::ReadChartDirs(const StringVector &dirsAndFiles,bool canDelete ){
-    int numHandled=0;
-    std::vector<ChartSet::Ptr> parsedSets;
+    class Waiter{
+        public:
+        std::mutex lock;
+        Condition cond;
+        int open=0;
+        int numHandled=0;
+        Waiter():cond(lock){}
+    };
+    std::shared_ptr<Waiter> waiter=std::make_shared<Waiter>();
+    ParseJob::DoneFunction onDone=[this,waiter](ParseJob::Ptr job){
+        int numInSet=ActivateChartSet(job->set);
+        Synchronized l(waiter->lock);
+        waiter->numHandled+=numInSet;
+        waiter->open--;
+        waiter->cond.notifyAll(l);
+    };
     for (auto && chartDir : dirsAndFiles){
         if (FileHelper::exists(chartDir,true)) {
             //directory
-            ChartSet::Ptr chartSet=ParseChartDir(chartDir,canDelete);
-            if (! chartSet){
+            {
+                Synchronized l(waiter->lock);
+                waiter->open++;
+            }
+            ParseJob::Ptr job=StartParseChartDir(chartDir,canDelete,onDone);
+            if (! job){
                 LOG_INFOC("unable to parse %s, skipping",chartDir);
+                Synchronized l(waiter->lock);
+                waiter->open--;
                 continue;
             }
-            int numInSet=chartSet->GetNumCharts();
-            numHandled+=numInSet;
-            parsedSets.push_back(chartSet);
-            
         } else {
             LOG_ERROR("can only handle chart directories, not files: %s",chartDir);
         }
     }
-    {
-        Synchronized l(lock);
-        int numCharts=numRead;
-        for (auto && chartSet : parsedSets){
-            chartSet->SetReady();
-            auto existing=chartSets.find(chartSet->GetKey());
-            if (existing != chartSets.end() ){
-                numCharts-=existing->second->GetNumCharts();
-                if (numCharts < 0) numCharts=0;
-                RemoveItem(CS_INFOKEY,existing->second);
-            }
-            chartSets[chartSet->GetKey()]=chartSet;
-            AddItem(CS_INFOKEY,chartSet,true);
-
-        }
-        numRead=numCharts+numHandled;
-        computeActiveSets();
-    }    
-    return numHandled;
+    Synchronized l(waiter->lock);
+    while (waiter->open > 0){
+        waiter->cond.wait(l);
+    }
+    return waiter->numHandled;
 }
 
-
 //we have: <system name>-<chart code>-<year>-<edition>
 //new scheme <system name>-<chart code>-<year>/<edition>-<update>
 class NameAndVersion{
@@ -430,7 +517,10 @@ bool ChartManager::DeleteChartSet(const String &key)
     }
     RemoveItem(CS_INFOKEY, it->second);
     chartSets.erase(it);
+    String cacheFile=ChartInfoCacheFile(key);
+    if (! cacheFile.empty()) FileHelper::unlink(cacheFile);
     computeActiveSets();
+    publishSets();
     chartCache->CloseBySet(key);
     if (setChanged)
         setChanged(key);
@@ -448,9 +538,9 @@ int ChartManager::ReadChartsInitial(const StringVector &dirs,bool canDelete){
 
 
 int ChartManager::GetNumCharts(){
-    Synchronized locker(lock);
+    ChartSetMapConstPtr sets=getSets();
     int rt=0;
-    for (auto it=chartSets.begin();it != chartSets.end();it++){
+    for (auto it=sets->begin();it != sets->end();it++){
         rt+=it->second->GetNumValidCharts();
     }
     return rt;
@@ -471,11 +561,24 @@ unsigned long ChartManager::GetMaxCacheSizeKb(){
 
 
 ChartSet::Ptr ChartManager::GetChartSet(String key){
-    Synchronized locker(lock);
-    ChartSetMap::iterator it=chartSets.find(key);
-    if (it == chartSets.end()) return ChartSet::Ptr();
+    return findSet(key);
+}
+
+ChartSetMapConstPtr ChartManager::getSets() const{
+    return std::atomic_load(&publishedSets);
+}
+ChartSet::Ptr ChartManager::findSet(const String &key) const{
+    ChartSetMapConstPtr sets=getSets();
+    auto it=sets->find(key);
+    if (it == sets->end()) return ChartSet::Ptr();
     return it->second;
 }
+void ChartManager::publishSets(){
+    std::atomic_store(&publishedSets,ChartSetMapConstPtr(std::make_shared<ChartSetMap>(chartSets)));
+    //plans are checked against the set sequence anyway
+    //but we do not need to keep outdated ones
+    planCache->Clear();
+}
 
 class Coverage{
     uint8_t *points=NULL;
@@ -518,53 +621,108 @@ class Coverage{
         }
 };
 
-static void fillChartList(WeightedChartList &chartList,ChartSet::Ptr chartSet,const Coord::TileBox &tileBox)
+static void fillChartList(WeightedChartList &chartList,ChartIndex::ConstPtr index,const Coord::TileBox &tileBox, double minScale, double maxScale)
 {
     Coord::World expand=Coord::pixelToWorld(50, tileBox.zoom);
     //expand our search box by 50px
     //to render texts, symbols and lights that have their center
     //in a different tile
     Coord::Extent tileExt=tileBox.getExpanded(expand,expand);    
-    WeightedChartList found=chartSet->FindChartForTile(tileExt);
+    WeightedChartList found=index->Find(tileExt,minScale,maxScale);
     for (auto it=found.begin();it != found.end();it++){
         it->tile=tileBox;
         chartList.add(*it);
     }
 }
-ChartSet::ExtentList ChartManager::GetChartSetExtents(const String &chartSetKey, bool includeSet)
+ChartSet::ExtentList::ConstPtr ChartManager::GetChartSetExtents(const String &chartSetKey, bool includeSet)
 {
-    ChartSet::ExtentList rt;
-    Synchronized l(lock);
-    auto it = chartSets.find(chartSetKey);
-    if (it == chartSets.end())
+    ChartSet::Ptr set=findSet(chartSetKey);
+    if (! set)
     {
         throw AvException("unknown chart set " + chartSetKey);
     }
+    ChartSet::Snapshot::ConstPtr snapshot=set->GetSnapshot();
+    if (! snapshot){
+        return std::make_shared<ChartSet::ExtentList>();
+    }
     if (includeSet){
-        rt.push_back(it->second->GetExtent().extent);
+        return snapshot->extents;
     }
-    it->second->FillChartExtents(rt);
+    auto rt=std::make_shared<ChartSet::ExtentList>();
+    set->FillChartExtents(*rt);
+    return rt;
+}
+
+std::shared_ptr<const ZoomLevelScales> ChartManager::getZoomLevelScales(double scaleLevel){
+    std::shared_ptr<const ZoomLevelScales> rt=std::atomic_load(&zoomLevelScales);
+    if (rt && rt->GetScaleLevel() == scaleLevel) return rt;
+    rt=std::make_shared<const ZoomLevelScales>(scaleLevel);
+    std::atomic_store(&zoomLevelScales,rt);
     return rt;
 }
 
 WeightedChartList ChartManager::FindChartsForTile(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, bool allLower){
+    return GetCoveragePlan(renderSettingsPtr,tile,allLower)->charts;
+}
+
+CoveragePlan::ConstPtr ChartManager::GetCoveragePlan(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, bool allLower){
+    //no lock here - we work on the published snapshots
+    ChartSet::Ptr set=findSet(tile.chartSetKey);
+    if (! set)
+    {
+        throw RenderException(tile,"unknown chart set");
+    }
+    ChartSet::Snapshot::ConstPtr snapshot=set->GetSnapshot();
+    if (!set->IsActive() || ! snapshot)
+    {
+        throw RenderException(tile,FMT("chart set not active, state=%d,num=%d",(int)(set->GetState()),set->GetNumValidCharts()));
+    }
+    CoveragePlanCache::Key key(tile,allLower);
+    CoveragePlan::ConstPtr rt=planCache->Get(key,snapshot->sequence,renderSettingsPtr->GetMD5());
+    if (rt) return rt;
+    auto plan=std::make_shared<CoveragePlan>();
+    plan->setSequence=snapshot->sequence;
+    plan->settingsMd5=renderSettingsPtr->GetMD5();
+    plan->extents=snapshot->extents;
+    plan->charts=computeChartsForTile(renderSettingsPtr,tile,snapshot->index,allLower);
+    planCache->Add(key,plan);
+    return plan;
+}
+
+WeightedChartList ChartManager::computeChartsForTile(RenderSettings::ConstPtr renderSettingsPtr,const TileInfo &tile, ChartIndex::ConstPtr index, bool allLower){
     LOG_DEBUG("findChartsForTile %s",tile.ToString());
     //add some border to the extent to potentially pick up
     //charts that have lights/symbols that we should draw partially
     Coord::TileBox tileBox=Coord::tileToBox(tile);
+    const RenderSettings * renderSettings=renderSettingsPtr.get(); //fast access
+    //find the wanted zoom levels
+    //min zoom gives us the zoom we use to display bigger scale charts (i.e. charts belonging to lower zoom levels)
+    int minZoom=allLower?-1:tile.zoom-renderSettings->overZoom;
+    if (minZoom < -1) minZoom=-1;
+    int requestedZoom=tile.zoom;
+    if (requestedZoom > MAX_ZOOM) requestedZoom=MAX_ZOOM;
+    //maxUnder gives the zoom we used to display better (higher zoom, smaller scale charts)
+    //if we did not already fully cover
+    int maxUnder=tile.zoom+renderSettings->underZoom;
+    int maxSoftUnder=maxUnder+renderSettings->softUnderZoom;
+    std::shared_ptr<const ZoomLevelScales> scalesPtr=getZoomLevelScales(renderSettings->scale);
+    const ZoomLevelScales &scales=*scalesPtr;
+    //the scales for a zoom level are all scales with
+    //scale <= scales[zoom] && scale > scales[zoom+1]
+    //maxzscale is the maximum scale we allow at all - ignore all with a scale >= maxzscale
+    //if minzoom is < 0 we allow all scales
+    double maxzScale=(minZoom<0)?std::numeric_limits<double>().max():scales.GetScaleForZoom(minZoom);
+    //start scale is the upper limit for all scales that we consider (<=)
+    //being part of the requested zoom level or higher zoom level
+    double startScaleUpper=scales.GetScaleForZoom(requestedZoom); //Scale that we start detecting coverage (including)
+    double startScaleLower=scales.GetScaleForZoom(requestedZoom+1); //Scale that we start detecting coverage (excluding) 
+    //minuScale is the minimum scale we accept at all
+    double minuScale=(maxUnder >= MAX_ZOOM)?0:scales.GetScaleForZoom(maxUnder+1);
+    double minSoftUScale=(maxSoftUnder >= MAX_ZOOM)?0:scales.GetScaleForZoom(maxSoftUnder+1);
     WeightedChartList rt;
     {
-        Synchronized l(lock);
-        auto it = chartSets.find(tile.chartSetKey);
-        if (it == chartSets.end())
-        {
-            throw RenderException(tile,"unknown chart set");
-        }
-        if (!it->second->IsActive())
-        {
-            throw RenderException(tile,FMT("chart set not active, state=%d,num=%d",(int)(it->second->GetState()),it->second->GetNumValidCharts()));
-        }
-        fillChartList(rt,it->second, tileBox);
+        //the chart index already drops everything outside [minSoftUScale,maxzScale)
+        fillChartList(rt,index, tileBox,minSoftUScale,maxzScale);
         //try a shifted tileBox
         //this will handle charts corssing +/- 180° (or being close to...)
         //see comments in Coordinates.h
@@ -574,10 +732,10 @@ WeightedChartList ChartManager::FindChartsForTile(RenderSettings::ConstPtr rende
         size_t direct=rt.size(); 
         if (tileBox.xmin < 0){
             //shift up
-            fillChartList(rt,it->second, tileBox.getShifted(tileBox.limits.worldShift(),0));
+            fillChartList(rt,index, tileBox.getShifted(tileBox.limits.worldShift(),0),minSoftUScale,maxzScale);
         }
         else{
-            fillChartList(rt,it->second, tileBox.getShifted(- tileBox.limits.worldShift(),0));
+            fillChartList(rt,index, tileBox.getShifted(- tileBox.limits.worldShift(),0),minSoftUScale,maxzScale);
         }
         if (rt.size() != direct){
             LOG_DEBUG("added %d shifted charts for tile %s",(rt.size()-direct),tileBox.toString());
@@ -586,7 +744,6 @@ WeightedChartList ChartManager::FindChartsForTile(RenderSettings::ConstPtr rende
     if (rt.size() == 0){
         return rt;
     }
-    const RenderSettings * renderSettings=renderSettingsPtr.get(); //fast access
     //sort list by scale
     std::sort(rt.begin(),rt.end(),[](ChartInfoWithScale first, ChartInfoWithScale second){
         if (first.info->IsOverlay() != second.info->IsOverlay() ){
@@ -594,41 +751,18 @@ WeightedChartList ChartManager::FindChartsForTile(RenderSettings::ConstPtr rende
         }
         return (first.scale > second.scale);
     });
-    //find the wanted zoom levels
-    //min zoom gives us the zoom we use to display bigger scale charts (i.e. charts belonging to lower zoom levels)
-    int minZoom=allLower?-1:tile.zoom-renderSettings->overZoom;
-    if (minZoom < -1) minZoom=-1;
-    int requestedZoom=tile.zoom;
-    if (requestedZoom > MAX_ZOOM) requestedZoom=MAX_ZOOM;
-    //maxUnder gives the zoom we used to display better (higher zoom, smaller scale charts)
-    //if we did not already fully cover
-    int maxUnder=tile.zoom+renderSettings->underZoom;
-    int maxSoftUnder=maxUnder+renderSettings->softUnderZoom;
-    ZoomLevelScales scales(renderSettings->scale); //TODO: keep this
-    //the scales for a zoom level are all scales with
-    //scale <= scales[zoom] && scale > scales[zoom+1]
-    //maxzscale is the maximum scale we allow at all - ignore all with a scale >= maxzscale
-    //if minzoom is < 0 we allow all scales
-    double maxzScale=(minZoom<0)?std::numeric_limits<double>().max():scales.GetScaleForZoom(minZoom);
-    //start scale is the upper limit for all scales that we consider (<=)
-    //being part of the requested zoom level or higher zoom level
-    double startScaleUpper=scales.GetScaleForZoom(requestedZoom); //Scale that we start detecting coverage (including)
-    double startScaleLower=scales.GetScaleForZoom(requestedZoom+1); //Scale that we start detecting coverage (excluding) 
-    //minuScale is the minimum scale we accept at all
-    double minuScale=(maxUnder >= MAX_ZOOM)?0:scales.GetScaleForZoom(maxUnder+1);
-    double minSoftUScale=(maxSoftUnder >= MAX_ZOOM)?0:scales.GetScaleForZoom(maxSoftUnder+1);
     const int MAX_SOFT_UNDER_CHARTS=4;  //avoid too many charts to be opend for the tile
                                         //we just keep this number of the highest scale charts
     int numSoftUnder=0;
     //first remove everything outside minZoom, maxSoftUnder/maxUnder
     avnav::erase_if(rt,[&numSoftUnder,maxzScale,minSoftUScale,minuScale](const ChartInfoWithScale &it){ 
+        if (it.scale < minSoftUScale) return true;
+        if (it.scale >= maxzScale) return true;
         if (it.scale < minuScale){
             if (! it.info->HasSoftUnder()) return true;
             numSoftUnder++;
             if (numSoftUnder > MAX_SOFT_UNDER_CHARTS) return true;
         }
-        if (it.scale < minSoftUScale) return true;
-        if (it.scale >= maxzScale) return true;
         return false;
     });
     //mark all the charts that we only picked for featureInfo
@@ -755,6 +889,8 @@ bool ChartManager::UpdateSettings(IBaseSettings::ConstPtr bs, RenderSettings::Co
 bool ChartManager::Stop(){
     LOG_INFO("stopping chart manager");
     houseKeeper->stop();
+    readers->Stop();
+    prepareWorkers->Stop();
     chartCache->CloseAllCharts();
     LOG_INFO("stopping chart manager done");
     return true;
@@ -785,14 +921,9 @@ Chart::ConstPtr ChartManager::OpenChart(s52::S52Data::ConstPtr s52data,ChartInfo
     Chart::ConstPtr chart;
     if (!chartInfo) return chart;
     if (!chartInfo->IsValid()) return chart;
-    ChartSet::Ptr set;
-    {
-        Synchronized l(lock);
-        auto it=chartSets.find(chartInfo->GetChartSetKey());
-        if (it == chartSets.end()){
-            throw FileException(chartInfo->GetFileName(),"no chart set found");
-        }
-        set=it->second;
+    ChartSet::Ptr set=findSet(chartInfo->GetChartSetKey());
+    if (! set){
+        throw FileException(chartInfo->GetFileName(),"no chart set found");
     }
     try
     {
@@ -819,170 +950,15 @@ String ChartManager::GetCacheFileName(const String &fileName){
 }
 
 
-bool ChartManager::WriteChartInfoCache(const String &configFile){
-    LOG_INFO("writing chart info cache");   
-    ChartSetMap::iterator it;
-    int numWritten=0;
-#if 0
-    for (it=chartSets.begin();it != chartSets.end();it++){
-        ChartSet *set=it->second;
-        if (!set->IsEnabled()) continue;
-        if (set->DisabledByErrors()) continue; //if the set has errors we always will reparse
-        LOG_DEBUG("writing chart info cache entry for set %s",set->GetKey());
-        config->SetPath(wxT("/")+set->GetKey());
-        config->Write("token",set->GetSetToken());
-        ChartList::InfoList::iterator cit;
-        ChartList::InfoList charts=set->GetAllCharts();
-        for (cit=charts.begin();cit!=charts.end();cit++){
-            ChartInfo *info=(*cit);
-            LOG_DEBUG("writing chart info cache entry for %s",info->GetFileName());
-            config->SetPath(wxT("/")+set->GetKey());
-            config->SetPath(GetCacheFileName(info->GetFileName()));
-            config->Write("valid",info->IsValid());
-            if (info->IsValid()) {
-                config->Write("scale", info->GetNativeScale());
-                ExtentPI extent = info->GetExtent();
-                config->Write("slat", extent.SLAT);
-                config->Write("wlon", extent.WLON);
-                config->Write("nlat", extent.NLAT);
-                config->Write("elon", extent.ELON);
-            }
-            numWritten++;
-        }
-    }
-    config->Flush();
-#endif
-    LOG_INFO("written %d chart info cache entries",numWritten);
-    return true;
-}
-bool ChartManager::ReadChartInfoCache(const String &configFile){
-    LOG_INFO("reading chart info cache");
-    bool rt=false;
-#if 0
-    if (config == NULL){
-        LOG_ERROR(wxT("chart cache file not open in read chart info cache"));
-        return true;
-    }
-    ChartSetMap::iterator it;
-    //we read in 2 rounds
-    //first we only check if we can find all, in the second we really set the 
-    //infos
-    //this way we can safely read the charts completely if we fail in the first round
-    for (int round = 0; round <= 1; round++) {
-        for (it = chartSets.begin(); it != chartSets.end(); it++) {
-            ChartSet *set = it->second;
-            if (!set->IsEnabled()) continue;
-            if (round >= 1  && set->IsParsing()) continue; //no need to try this again
-            ChartSet::CandidateList::iterator cit;
-            ChartSet::CandidateList charts = set->GetCandidates();
-            config->SetPath(wxT("/")+set->GetKey());
-            if (! config->HasEntry("token")){
-                LOG_ERROR("missing entry token for chart set %s in chart info cache",set->GetKey());
-                set->StartParsing();
-                rt=true;
-                continue;
-            }
-            String cacheToken;
-            cacheToken=config->Read("token","");
-            if (cacheToken != set->GetSetToken()){
-                LOG_ERROR("set token has changed for set %s (cache=%s,current=%s)",
-                        set->GetKey(),
-                        cacheToken,set->GetSetToken()
-                        );
-                set->StartParsing();
-                rt=true;
-                continue;
-            }
-            for (cit = charts.begin(); cit != charts.end(); cit++) {
-                ChartSet::ChartCandidate candidate = (*cit);
-                ExtensionList::iterator it=extensions->find(candidate.extension);
-                if (it == extensions->end()){
-                    LOG_ERROR(wxT("unknown extension for chart file %s when reading chart info cache, skip"),candidate.fileName);
-                    continue;
-                }
-                LOG_DEBUG("reading chart info cache entry for %s round %d", candidate.fileName,round);
-                config->SetPath(wxT("/") + set->GetKey());
-                config->SetPath(GetCacheFileName(candidate.fileName));
-                if (! config->HasEntry("valid")){
-                    LOG_ERROR("missing valid entry for %s in chart info cache", candidate.fileName);
-                    set->StartParsing();
-                    rt=true;
-                    break;
-                }
-                bool valid=false;
-                config->Read("valid",&valid);
-                if (valid) {
-                    if (!config->HasEntry("scale")) {
-                        LOG_ERROR("missing scale entry for %s in chart info cache", candidate.fileName);
-                        set->StartParsing();
-                        rt=true;
-                        break;                     
-                    }
-                    if (!config->HasEntry("slat")) {
-                        LOG_ERROR("missing slat entry for %s in chart info cache", candidate.fileName);
-                        set->StartParsing();
-                        rt=true;
-                        break;                        
-                    }
-                    if (!config->HasEntry("wlon")) {
-                        LOG_ERROR("missing wlon entry for %s in chart info cache", candidate.fileName);
-                        set->StartParsing();
-                        rt=true;
-                        break;                    
-                    }
-                    if (!config->HasEntry("nlat")) {
-                        LOG_ERROR("missing nlat entry for %s in chart info cache", candidate.fileName);
-                        set->StartParsing();
-                        rt=true;
-                        break; 
-                    }
-                    if (!config->HasEntry("elon")) {
-                        LOG_ERROR("missing elon entry for %s in chart info cache", candidate.fileName);
-                        set->StartParsing();
-                        rt=true;
-                        break;
-                    }
-                }
-                if (round != 1) continue;
-                ChartInfo *info=new ChartInfo(it->second.classname,candidate.fileName);
-                if (valid){
-                    long nativeScale = -1;
-                    config->Read("scale", &nativeScale);
-                    ExtentPI extent;
-                    config->Read("slat", &extent.SLAT);
-                    config->Read("wlon", &extent.WLON);
-                    config->Read("nlat", &extent.NLAT);
-                    config->Read("elon", &extent.ELON);
-                    info->FromCache(nativeScale,extent);
-                    numRead++;
-                }
-                else {
-                    LOG_ERROR(wxT("adding invalid chart entry %s to set %s"),candidate.fileName,set->GetKey());
-                    set->AddError(candidate.fileName);
-                }
-                set->AddChart(info);
-            }
-        }
-    }
-    int numParsing=0;
-    for (it=chartSets.begin();it != chartSets.end();it++){
-        if (it->second->IsParsing()){
-            numParsing++;
-            continue;
-        }
-        it->second->SetZoomLevels();
-        if (it->second->IsEnabled()) it->second->SetReady();
-    }
-    if (! rt) state=STATE_READY;
-    LOG_INFO(String::Format("read %d chart info cache entries, %d sets still need parsing",numRead,numParsing));
-#endif    
-    return rt;
+void ChartManager::SetChartInfoCacheDir(const String &dir){
+    Synchronized l(lock);
+    chartInfoCacheDir=dir;
 }
 
 ChartSetInfoList ChartManager::ListChartSets(){
     ChartSetInfoList rt;
-    Synchronized l(lock);
-    for (auto it=chartSets.begin();it != chartSets.end();it++){
+    ChartSetMapConstPtr sets=getSets();
+    for (auto it=sets->begin();it != sets->end();it++){
         if (!it->second->IsActive() || it->second->DisabledByErrors()) continue;
         rt.push_back(it->second->info);
     }
@@ -990,12 +966,11 @@ ChartSetInfoList ChartManager::ListChartSets(){
 }
 
 String ChartManager::GetChartSetSequence(const String &chartSetKey){
-    Synchronized l(lock);
-    auto it=chartSets.find(chartSetKey);
-    if (it == chartSets.end()) return "";
+    ChartSet::Ptr set=findSet(chartSetKey);
+    if (! set) return "";
     s52::S52Data::ConstPtr s52data=GetS52Data();
-    if (!s52data) return it->second->GetSetToken();
-    return s52data->getMD5().ToString()+"-"+it->second->GetSetToken();
+    if (!s52data) return set->GetSetToken();
+    return s52data->getMD5().ToString()+"-"+set->GetSetToken();
 }
 
 int ChartManager::RemoveUnverified()
@@ -1017,15 +992,40 @@ int ChartManager::RemoveUnverified()
         {
             chartSets.erase(*it);
         }
+        publishSets();
     }
     // outside lock
     for (auto it = setsToRemove.begin(); it != setsToRemove.end(); it++)
     {
         chartCache->CloseBySet(*it);
     }
+    RemoveUnknownChartInfoCaches();
     return setsToRemove.size();
 }
 
+String ChartManager::ChartInfoCacheFile(const String &setKey){
+    if (chartInfoCacheDir.empty()) return String();
+    return FileHelper::concatPath(chartInfoCacheDir,setKey+ChartInfoCache::EXTENSION);
+}
+
+void ChartManager::RemoveUnknownChartInfoCaches(){
+    String cacheDir;
+    std::set<String> known;
+    {
+        Synchronized l(lock);
+        cacheDir=chartInfoCacheDir;
+        for (auto it=chartSets.begin();it != chartSets.end();it++){
+            known.insert(it->first);
+        }
+    }
+    if (cacheDir.empty()) return;
+    for (auto && cacheFile : FileHelper::listDir(cacheDir,String("*")+ChartInfoCache::EXTENSION)){
+        if (known.find(FileHelper::fileName(cacheFile,true)) != known.end()) continue;
+        LOG_INFO("removing chart info cache %s of an unknown chart set",cacheFile);
+        FileHelper::unlink(cacheFile);
+    }
+}
+
 void ChartManager::HouseKeeper::run(){
     while(true){
         if(waitMillis(intervallMs)) break;
@@ -1062,12 +1062,15 @@ bool ChartManager::buildS52Data(RenderSettings::ConstPtr s){
             RemoveItem(S52_INFOKEY);
         }
         s52::S52Data::Ptr newS52Data=std::make_shared<s52::S52Data>(s,fontFile,sequence); 
+        //procedure results only depend on the settings they declare
+        if (s52data) newS52Data->shareCondCache(*s52data);
         LOG_INFO("building s52 data with dir %s",s57Dir);
         newS52Data->init(s57Dir);
         s52data=newS52Data;
         AddItem(S52_INFOKEY,s52data);
     }
     if (hasOld && chartCache) chartCache->CloseByMD5(oldMd5);
+    if (planCache) planCache->Clear();
     if (settingsChanged){
         settingsChanged(s52data);
     } 
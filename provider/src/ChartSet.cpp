@@ -55,7 +55,7 @@ const String ChartSet::GetKey() const
 
 void ChartSet::SetReopenStatus(String fileName, bool ok)
 {
-    Synchronized l(lock);
+    //atomics only - called on the render path
     if (!ok)
     {
         reopenOk = 0;
@@ -140,7 +140,11 @@ void ChartSet::SetReady()
     Synchronized l(lock);
     if (state != STATE_DISABLED)
         state = STATE_READY;
+    //charts are added in parallel - keep the order (and the hash) stable
+    std::sort(chartList.begin(), chartList.end(), [](const ChartInfo::Ptr &a, const ChartInfo::Ptr &b)
+              { return a->GetFileName() < b->GetFileName(); });
     computeHash();
+    publish();
 }
 
 void ChartSet::AddChart(ChartInfo::Ptr info)
@@ -190,6 +194,8 @@ void ChartSet::AddChart(ChartInfo::Ptr info)
     {
         computeHash();
     }
+    //charts are added while parsing a directory
+    //we publish once in SetReady when the parse has finished
 
     if (info->IsValid())
     {
@@ -202,6 +208,9 @@ void ChartSet::AddChart(ChartInfo::Ptr info)
 }
 ChartSet::ExtentInfo ChartSet::GetExtent()
 {
+    Snapshot::ConstPtr current = GetSnapshot();
+    if (current)
+        return current->extent;
     Synchronized l(lock);
     ExtentInfo rt;
     rt.extent = boundings;
@@ -211,12 +220,17 @@ ChartSet::ExtentInfo ChartSet::GetExtent()
 }
 void ChartSet::FillChartExtents(ChartSet::ExtentList &extents)
 {
-    Synchronized l(lock);
-    extents.setHash=hash.ToString();
-    for (const auto &info : chartList)
-    {
-        extents.push_back(info->GetExtent());
-    }
+    Snapshot::ConstPtr current = GetSnapshot();
+    if (!current)
+        return;
+    extents.setHash = current->extents->setHash;
+    extents.setSequence = current->extents->setSequence;
+    //skip the set extent
+    extents.insert(extents.end(), current->extents->begin() + 1, current->extents->end());
+}
+ChartSet::Snapshot::ConstPtr ChartSet::GetSnapshot() const
+{
+    return std::atomic_load(&snapshot);
 }
 
 size_t ChartSet::GetNumCharts()
@@ -224,6 +238,11 @@ size_t ChartSet::GetNumCharts()
     Synchronized l(lock);
     return chartList.size();
 }
+ChartSet::InfoList ChartSet::GetCharts()
+{
+    Synchronized l(lock);
+    return chartList;
+}
 int ChartSet::RemoveUnverified()
 {
     Synchronized l(lock);
@@ -232,6 +251,7 @@ int ChartSet::RemoveUnverified()
     if (rt > 0)
     {
         computeHash();
+        publish();
     }
     if (rt > 0)
     {
@@ -240,27 +260,18 @@ int ChartSet::RemoveUnverified()
     return rt;
 }
 
-WeightedChartList ChartSet::FindChartForTile(const Coord::Extent &tileExtent)
+WeightedChartList ChartSet::FindChartForTile(const Coord::Extent &tileExtent, double minScale, double maxScale)
 {
-    Synchronized l(lock);
-    WeightedChartList rt;
-    for (auto &&info : chartList)
-    {
-        if (!info->IsValid() || info->IsIgnored())
-        {
-            continue;
-        }
-        int scale = (info->HasTile(tileExtent));
-        if (scale > 0)
-        {
-            ChartInfoWithScale winfo(scale, info);
-            rt.push_back(winfo);
-        }
-    }
-    return rt;
+    Snapshot::ConstPtr current = GetSnapshot();
+    if (!current)
+        return WeightedChartList();
+    return current->index->Find(tileExtent, minScale, maxScale);
 }
 String ChartSet::GetSetToken()
 {
+    Snapshot::ConstPtr current = GetSnapshot();
+    if (current)
+        return current->hash;
     Synchronized l(lock);
     return hash.ToString();
 }
@@ -329,4 +340,31 @@ void ChartSet::computeHash()
     numIgnoredCharts = newIgored;
     numValidCharts = newValid;
     numCharts=chartList.size();
-}
\ No newline at end of file
+}
+/**
+ * lock must already been held
+ */
+void ChartSet::publish()
+{
+    static std::atomic<int> snapshotSequence = {0};
+    auto next = std::make_shared<Snapshot>();
+    next->sequence = ++snapshotSequence;
+    next->index = std::make_shared<ChartIndex>(chartList);
+    next->hash = hash.ToString();
+    auto extents = std::make_shared<ExtentList>();
+    extents->setHash = next->hash;
+    extents->setSequence = next->sequence;
+    extents->reserve(chartList.size() + 1);
+    extents->push_back(boundings);
+    for (const auto &info : chartList)
+    {
+        extents->push_back(info->GetExtent());
+    }
+    next->extents = extents;
+    next->extent.extent = boundings;
+    next->extent.maxScale = maxScale;
+    next->extent.minScale = minScale;
+    LOG_DEBUG("published snapshot for %s with %d charts, index depth %d",
+              GetKey(), next->index->GetNumCharts(), next->index->GetDepth());
+    std::atomic_store(&snapshot, Snapshot::ConstPtr(next));
+}
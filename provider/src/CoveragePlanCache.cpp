@@ -0,0 +1,91 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Coverage Plan Cache
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "CoveragePlanCache.h"
+
+CoveragePlanCache::CoveragePlanCache(size_t maxEntries){
+    maxPerShard=maxEntries/NUM_SHARDS;
+    if (maxPerShard < 1) maxPerShard=1;
+}
+
+CoveragePlanCache::Shard & CoveragePlanCache::getShard(const Key &key){
+    return shards[KeyHash{}(key) % NUM_SHARDS];
+}
+
+CoveragePlan::ConstPtr CoveragePlanCache::Get(const Key &key, int setSequence, const MD5Name &settingsMd5){
+    Shard &shard=getShard(key);
+    {
+        Synchronized l(shard.lock);
+        auto it=shard.plans.find(key);
+        if (it != shard.plans.end() &&
+            it->second->setSequence == setSequence &&
+            it->second->settingsMd5 == settingsMd5){
+            numHits++;
+            return it->second;
+        }
+    }
+    numMisses++;
+    return CoveragePlan::ConstPtr();
+}
+
+void CoveragePlanCache::Add(const Key &key, CoveragePlan::ConstPtr plan){
+    if (! plan) return;
+    Shard &shard=getShard(key);
+    Synchronized l(shard.lock);
+    auto it=shard.plans.find(key);
+    if (it != shard.plans.end()){
+        //outdated entry, keep the position in the eviction order
+        it->second=plan;
+        return;
+    }
+    while (shard.order.size() >= maxPerShard){
+        shard.plans.erase(shard.order.front());
+        shard.order.pop_front();
+    }
+    shard.plans[key]=plan;
+    shard.order.push_back(key);
+}
+
+void CoveragePlanCache::Clear(){
+    for (auto &shard:shards){
+        Synchronized l(shard.lock);
+        shard.plans.clear();
+        shard.order.clear();
+    }
+}
+
+void CoveragePlanCache::ToJson(StatusStream &stream){
+    int numEntries=0;
+    for (auto &shard:shards){
+        Synchronized l(shard.lock);
+        numEntries+=shard.plans.size();
+    }
+    stream["numEntries"]=numEntries;
+    stream["maxEntries"]=(int)(maxPerShard*NUM_SHARDS);
+    stream["hits"]=(int)numHits;
+    stream["misses"]=(int)numMisses;
+}
@@ -30,6 +30,7 @@
 #include <memory.h>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
 #include "Logger.h"
 namespace extthick{
     //based on http://kt8216.unixcab.org/murphy/index.html
@@ -306,35 +307,6 @@ pbuffer_t* draw_varthick_line
 
 };
 
-DrawingContext::ColorAndAlpha DrawingContext::alphaImpl(DrawingContext::ColorAndAlpha dst, const DrawingContext::ColorAndAlpha &src){
-    // A over B (A: src, B: dst)
-        // https://de.wikipedia.org/wiki/Alpha_Blending
-        // https://stackoverflow.com/questions/1102692/how-to-alpha-blend-rgba-unsigned-byte-color-fast
-        // https://arxiv.org/pdf/2202.02864.pdf
-        ColorAndAlpha aA = (src & 0xFF000000) >> 24;
-        if (aA == 255 ) return src;
-        ColorAndAlpha aB = (dst & 0xFF000000) >> 24;
-        if (aB == 0)
-            return src;
-        if (aA == 0) return dst;
-        ColorAndAlpha bF=(((255-aA)*aB) + (1<<7)) >> 8;
-        ColorAndAlpha anew = aA+bF;
-        ColorAndAlpha f=factors[anew];
-        const int shifts[3]={0,8,16};
-        ColorAndAlpha rt= (anew << 24);
-        for (int i=0;i<3;i++){
-            ColorAndAlpha c=((src >> shifts[i]) &0xff)*f*aA;
-            c+=((dst >> shifts[i])&0xff)*f*bF;
-            c+=1<<15; //+0.5 for better rounding
-            c=c>>16;
-            if (c > 255){
-                c=255;
-            }
-            rt|=c << shifts[i];
-        }
-        return rt;
-}
-
 DrawingContext::ColorAndAlpha DrawingContext::convertColor(uint8_t r, uint8_t g, uint8_t b, uint8_t alpha)
 {
     ColorAndAlpha rt = alpha;
@@ -347,14 +319,21 @@ DrawingContext::ColorAndAlpha DrawingContext::convertColor(uint8_t r, uint8_t g,
     return rt;
 }
 DrawingContext::DrawingContext(int width, int height)
+    : DrawingContext(width, height, true)
+{
+}
+DrawingContext::DrawingContext(int width, int height, bool withBuffer)
 {
     this->hasDrawn = false;
     this->width = width;
     this->height = height;
-    this->bufSize = width * height;
+    this->bufSize = withBuffer ? width * height : 0;
     this->linelen = width;
-    this->buffer = std::make_unique<ColorAndAlpha[]>(this->bufSize);
-    reset();
+    if (withBuffer)
+    {
+        this->buffer = std::make_unique<ColorAndAlpha[]>(this->bufSize);
+        reset();
+    }
 }
 static inline Coord::Pixel limit(Coord::Pixel v, Coord::Pixel max)
 {
@@ -366,10 +345,11 @@ static inline Coord::Pixel limit(Coord::Pixel v, Coord::Pixel max)
 }
 void DrawingContext::setPix(int x, int y, ColorAndAlpha color)
 {
-    setPixInt(x, y, color);
+    setPixInt<false, false>(x, y, color);
 }
 
-void DrawingContext::drawRect(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color)
+template<bool HIT>
+void DrawingContext::drawRectT(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color)
 {
     x0 = limit(x0, width);
     x1 = limit(x1, width);
@@ -379,25 +359,23 @@ void DrawingContext::drawRect(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1,
     y1 = limit(y1, height);
     if (y0 > y1)
         std::swap(y0, y1);
+    hasDrawn=true;
+    if (HIT) return;
     ColorAndAlpha *start = buffer.get() + y0 * linelen + x0;
-    ColorAndAlpha *vp = start;
     for (int y = y0; y <= y1; y++)
     {
-        vp = start;
-        for (int x = x0; x <= x1; x++)
-        {
-            *vp = color;
-            vp++;
-            hasDrawn=true;
-            if (checkOnly) return;
-        }
+        kernels->fill(start, x1 - x0 + 1, color);
         start += linelen;
     }
 }
+void DrawingContext::drawRect(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color)
+{
+    drawRectT<false>(x0, y0, x1, y1, color);
+}
 void DrawingContext::reset(ColorAndAlpha pattern)
 {
     ColorAndAlpha *p = buffer.get();
-    ColorAndAlpha *pe = buffer.get() + width * height;
+    ColorAndAlpha *pe = buffer.get() + bufSize;
     while (p < pe)
     {
         *p = pattern;
@@ -416,22 +394,23 @@ Black Book, but has been optimized to work with 32-bit
 fixed-point arithmetic
 
 */
-void DrawingContext::drawAaLine(const Coord::PixelXy &pp0, const Coord::PixelXy &pp1, DrawingContext::ColorAndAlpha color, const DrawingContext::Dash *dash)
+template<bool HIT>
+void DrawingContext::drawAaLineT(const Coord::PixelXy &pp0, const Coord::PixelXy &pp1, DrawingContext::ColorAndAlpha color, const DrawingContext::Dash *dash)
 {
     if (pp0.y == pp1.y)
     {
-        drawHLine(pp0.y, pp0.x, pp1.x, color, true);
+        if (HIT) drawLineT<true, false, false>(pp0, pp1, color, dash, false);
+        else drawHLine(pp0.y, pp0.x, pp1.x, color, true);
         return;
     }
     if (pp0.x == pp1.x)
     {
-        drawVLine(pp0.x, pp0.y, pp1.y, color,true);
+        if (HIT) drawLineT<true, false, false>(pp0, pp1, color, dash, false);
+        else drawVLine(pp0.x, pp0.y, pp1.y, color,true);
         return;
     }
     Coord::PixelXy p0=pp0;
     Coord::PixelXy p1=pp1;
-    Coord::Pixel xx0, yy0,y0p1;
-    
     // TODO: range check
     int32_t dx = std::abs(p0.x - p1.x);
     int32_t dy = std::abs(p0.y - p1.y);
@@ -443,12 +422,20 @@ void DrawingContext::drawAaLine(const Coord::PixelXy &pp0, const Coord::PixelXy
         steep = true;
         std::swap(p0.x, p0.y);
         std::swap(p1.x, p1.y);
-        std::swap(dx,dy);
     }
     if (p0.x > p1.x)
     {
         std::swap(p0, p1);
     }
+    if (steep) aaLineSteps<HIT, true>(p0, p1, color, dash);
+    else aaLineSteps<HIT, false>(p0, p1, color, dash);
+}
+template<bool HIT, bool SWAP>
+void DrawingContext::aaLineSteps(const Coord::PixelXy &p0, const Coord::PixelXy &p1, DrawingContext::ColorAndAlpha color, const DrawingContext::Dash *dash)
+{
+    Coord::Pixel xx0, yy0,y0p1;
+    int32_t dx = p1.x - p0.x;
+    int32_t dy = std::abs(p0.y - p1.y);
     int32_t dx2 = dx << 1;
     int32_t dy2 = dy << 1;
     int32_t stepy=1;
@@ -470,8 +457,8 @@ void DrawingContext::drawAaLine(const Coord::PixelXy &pp0, const Coord::PixelXy
      */
     DashHandler dh(dash);
     if (dh.shouldDraw(p0.x, p0.y)){
-        setPixAlpha(p0.x, p0.y, color, steep);
-        if (checkOnly && hasDrawn) return;
+        setPixAlpha<SWAP, HIT>(p0.x, p0.y, color);
+        if (HIT && hasDrawn) return;
     }
 
     yy0 = p0.y;
@@ -504,17 +491,22 @@ void DrawingContext::drawAaLine(const Coord::PixelXy &pp0, const Coord::PixelXy
         //after a step the weight must be minimal, increasing
         //towards the next step
         if (dh.shouldDraw(xx0,y0p1)){
-            setPixWeight(xx0, yy0, color, 255-weight, steep);
-            setPixWeight(xx0, y0p1, color, weight, steep);
+            setPixWeight<SWAP, HIT>(xx0, yy0, color, 255-weight);
+            setPixWeight<SWAP, HIT>(xx0, y0p1, color, weight);
         }
-        if (checkOnly && hasDrawn) return;
+        if (HIT && hasDrawn) return;
     }
     if (dh.shouldDraw(p1.x,p1.y)){
-        setPixAlpha(p1.x, p1.y, color, steep);
+        setPixAlpha<SWAP, HIT>(p1.x, p1.y, color);
     }
 }
+void DrawingContext::drawAaLine(const Coord::PixelXy &pp0, const Coord::PixelXy &pp1, DrawingContext::ColorAndAlpha color, const DrawingContext::Dash *dash)
+{
+    drawAaLineT<false>(pp0, pp1, color, dash);
+}
 
-void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext::ColorAndAlpha &color, int radius, int radiusInner, double start, double end)
+template<bool HIT>
+void DrawingContext::drawArcT(const Coord::PixelXy &center, const DrawingContext::ColorAndAlpha &color, int radius, int radiusInner, double start, double end)
 {
     /*
      * Sanity check radius
@@ -529,7 +521,7 @@ void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext:
      */
     if (radius == 0)
     {
-        setPixInt(center.x, center.y, color);
+        setPixInt<false, HIT>(center.x, center.y, color);
         return;
     }
     bool drawFull = false;
@@ -715,22 +707,22 @@ void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext:
 
                 // always check if we're drawing a certain octant before adding a pixel to that octant.
                 if (drawoct & 4)
-                    setPixInt(xmcx, ypcy, color);
+                    setPixInt<false, HIT>(xmcx, ypcy, color);
                 if (drawoct & 2)
-                    setPixInt(xpcx, ypcy, color);
+                    setPixInt<false, HIT>(xpcx, ypcy, color);
                 if (drawoct & 32)
-                    setPixInt(xmcx, ymcy, color);
+                    setPixInt<false, HIT>(xmcx, ymcy, color);
                 if (drawoct & 64)
-                    setPixInt(xpcx, ymcy, color);
+                    setPixInt<false, HIT>(xpcx, ymcy, color);
             }
             else
             {
                 if (drawoct & 96)
-                    setPixInt(center.x, ymcy, color);
+                    setPixInt<false, HIT>(center.x, ymcy, color);
                 if (drawoct & 6)
-                    setPixInt(center.x, ypcy, color);
+                    setPixInt<false, HIT>(center.x, ypcy, color);
             }
-            if (checkOnly && hasDrawn) return;
+            if (HIT && hasDrawn) return;
             xpcy = center.x + cy;
             xmcy = center.x - cy;
             if (cx > 0 && cx != cy)
@@ -738,22 +730,22 @@ void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext:
                 ypcx = center.y + cx;
                 ymcx = center.y - cx;
                 if (drawoct & 8)
-                    setPixInt(xmcy, ypcx, color);
+                    setPixInt<false, HIT>(xmcy, ypcx, color);
                 if (drawoct & 1)
-                    setPixInt(xpcy, ypcx, color);
+                    setPixInt<false, HIT>(xpcy, ypcx, color);
                 if (drawoct & 16)
-                    setPixInt(xmcy, ymcx, color);
+                    setPixInt<false, HIT>(xmcy, ymcx, color);
                 if (drawoct & 128)
-                    setPixInt(xpcy, ymcx, color);
+                    setPixInt<false, HIT>(xpcy, ymcx, color);
             }
             else if (cx == 0)
             {
                 if (drawoct & 24)
-                    setPixInt(xmcy, center.y, color);
+                    setPixInt<false, HIT>(xmcy, center.y, color);
                 if (drawoct & 129)
-                    setPixInt(xpcy, center.y, color);
+                    setPixInt<false, HIT>(xpcy, center.y, color);
             }
-            if (checkOnly && hasDrawn) return;
+            if (HIT && hasDrawn) return;
             if (!drawFull)
             {
                 /*
@@ -798,8 +790,13 @@ void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext:
         radius--;
     } while (radiusInner >= 0 && radius >= radiusInner && radius > 0);
 }
+void DrawingContext::drawArc(const Coord::PixelXy &center, const DrawingContext::ColorAndAlpha &color, int radius, int radiusInner, double start, double end)
+{
+    drawArcT<false>(center, color, radius, radiusInner, start, end);
+}
 
-void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, bool overlap){
+template<bool HIT, bool ALPHA, bool DASHED>
+void DrawingContext::drawLineT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, const DrawingContext::Dash *dash, bool overlap){
     //see https://stackoverflow.com/questions/40884680/how-to-use-bresenhams-line-drawing-algorithm-with-clipping
     //sort by y
     Coord::Pixel x1=p0.x;
@@ -807,18 +804,25 @@ void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1
     Coord::Pixel x2=p1.x;
     Coord::Pixel y2 = p1.y;
     //Vertical line
-    ColorAndAlpha *dst=buffer.get();
-    ColorAndAlpha *start=dst;
-    ColorAndAlpha *end=start+(width*height);
     if (x1 == x2)
     {
-        drawVLine(x1,y1,y2,color,useAlpha,dash);
+        if (HIT){
+            if (x1 >= 0 && x1 < width && std::max(y1,y2) >= 0 && std::min(y1,y2) < height) hasDrawn=true;
+        }
+        else{
+            vLine<ALPHA,DASHED>(x1,y1,y2,color,dash);
+        }
         return;
     }
     //Horizontal line
     if (y1 == y2)
     {
-        drawHLine(y1,x1,x2,color,useAlpha,dash);
+        if (HIT){
+            if (y1 >= 0 && y1 < height && std::max(x1,x2) >= 0 && std::min(x1,x2) < width) hasDrawn=true;
+        }
+        else{
+            hLine<ALPHA,DASHED>(y1,x1,x2,color,dash);
+        }
         return;
     }
     //sort by y
@@ -919,7 +923,6 @@ void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1
             }
         }
     }
-    dst=buffer.get()+y*linelen+x;
     if (y < 0){
         int dummy=1;
     }
@@ -930,21 +933,21 @@ void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1
     else{
         if (x2 < 0) x2=0;
     }
+    if (y <= y2  &&
+           ((sign_x > 0 && x <= x2) || (sign_x < 0 && x >= x2))){
+        hasDrawn=true;
+        if (HIT) return;
+    }
+    //no buffer access before this point - a HitTestContext has none
+    ColorAndAlpha *start=buffer.get();
+    ColorAndAlpha *end=start+(width*height);
+    ColorAndAlpha *dst=start+y*linelen+x;
     while (y <= y2  &&
            ((sign_x > 0 && x <= x2) || (sign_x < 0 && x >= x2)))
     {
-        hasDrawn=true;
-        if (checkOnly) return;
-        if (dh.shouldDraw(x, y))
+        if (!DASHED || dh.shouldDraw(x, y))
         {
-            if (useAlpha)
-            {
-                *dst = alpha(*dst, color);
-            }
-            else
-            {
-                *dst = color;
-            }
+            putPixel<ALPHA>(dst, color);
         }
         Coord::Pixel lastx=x;
         Coord::Pixel lasty=y;
@@ -971,19 +974,24 @@ void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1
                 md -= offsets[i];
                 if (md >= start & md < end)
                 {
-                    if (useAlpha)
-                    {
-                        *md = alpha(*md, color);
-                    }
-                    else
-                    {
-                        *md = color;
-                    }
+                    putPixel<ALPHA>(md, color);
                 }
             }
         }
     }
 }
+void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, bool overlap){
+    if (useAlpha)
+    {
+        if (dash) drawLineT<false, true, true>(p0, p1, color, dash, overlap);
+        else drawLineT<false, true, false>(p0, p1, color, dash, overlap);
+    }
+    else
+    {
+        if (dash) drawLineT<false, false, true>(p0, p1, color, dash, overlap);
+        else drawLineT<false, false, false>(p0, p1, color, dash, overlap);
+    }
+}
 /**
  * taken from https://github.com/ArminJo/STMF3-Discovery-Demos/blob/master/lib/graphics/src/thickLine.cpp.
  *            https://github.com/ArminJo/STMF3-Discovery-Demos/blob/master/lib/BlueDisplay/LocalGUI/ThickLine.hpp
@@ -993,17 +1001,23 @@ void DrawingContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1
  * The code is bigger and more complicated than drawThickLineSimple() but it tends to be faster, since drawing a pixel is often a slow operation.
  * aThicknessMode can be one of LINE_THICKNESS_MIDDLE, LINE_THICKNESS_DRAW_CLOCKWISE, LINE_THICKNESS_DRAW_COUNTERCLOCKWISE
  */
-void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, unsigned int aThickness,
-        DrawingContext::ThicknessMode aThicknessMode) {       
+template<bool HIT>
+void DrawingContext::drawThickLineT(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, unsigned int aThickness) {
     Coord::Pixel i, tDeltaX, tDeltaY, tDeltaXTimes2, tDeltaYTimes2, tError, tStepX, tStepY;
     Coord::PixelXy pstart=p0;
     Coord::PixelXy pend=p1;
 
+    //the hit test ignores alpha and dashes
+    auto line=[this,&color,useAlpha,dash](const Coord::PixelXy &lp0, const Coord::PixelXy &lp1, bool overlap){
+        if (HIT) drawLineT<true, false, false>(lp0, lp1, color, dash, overlap);
+        else drawLine(lp0, lp1, color, useAlpha, dash, overlap);
+    };
     if (aThickness <= 1) {
-        drawLine(p0,p1,color,useAlpha,dash);
+        line(p0,p1,false);
         return;
     }
-    if (extThickLine){
+    if (extThickLine && !HIT){
+        //the hit test uses the simple algorithm below as it does not draw
         extthick::draw_varthick_line(this,color,p0.x,p0.y,p1.x,p1.y,aThickness);
         return; 
     }
@@ -1076,8 +1090,8 @@ void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelX
             tError += tDeltaYTimes2;
         }
         // draw start line. We can alternatively use drawLineOverlap(aXStart, aYStart, aXEnd, aYEnd, LINE_OVERLAP_NONE, aColor) here.
-        drawLine(pstart, pend, color,useAlpha,dash);
-        if (checkOnly && hasDrawn) return;
+        line(pstart, pend, false);
+        if (HIT && hasDrawn) return;
         // draw aThickness number of lines
         tError = tDeltaYTimes2 - tDeltaX;
         for (i = aThickness; i > 1; i--) {
@@ -1111,8 +1125,8 @@ void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelX
                 tOverlap = true;
             }
             tError += tDeltaYTimes2;
-            drawLine(pstart, pend, color,useAlpha,dash,tOverlap);
-            if (checkOnly && hasDrawn) return;
+            line(pstart, pend, tOverlap);
+            if (HIT && hasDrawn) return;
         }
     } else {
         // the other octant 2, 4, 6, 8 (between 45 and 90, 135 and 180, ... degree)
@@ -1135,8 +1149,8 @@ void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelX
             tError += tDeltaXTimes2;
         }
         //draw start line
-        drawLine(pstart,pend,color,useAlpha,dash);
-        if (checkOnly && hasDrawn) return;
+        line(pstart, pend, false);
+        if (HIT && hasDrawn) return;
         // draw aThickness number of lines
         tError = tDeltaXTimes2 - tDeltaY;
         for (i = aThickness; i > 1; i--) {
@@ -1150,11 +1164,15 @@ void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelX
                 tOverlap = true;
             }
             tError += tDeltaXTimes2;
-            drawLine(pstart, pend,color,useAlpha,dash,tOverlap);
-            if (checkOnly && hasDrawn) return;
+            line(pstart, pend, tOverlap);
+            if (HIT && hasDrawn) return;
         }
     }
 }
+void DrawingContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, unsigned int aThickness,
+        DrawingContext::ThicknessMode aThicknessMode) {
+    drawThickLineT<false>(p0, p1, color, useAlpha, dash, aThickness);
+}
 
 class SBresenHam
 {
@@ -1232,18 +1250,12 @@ void DrawingContext::drawSymbol(const Coord::PixelXy &p0 /*upper left*/,int swid
     int ymin=std::max(0,p0.y);
     int ymax=std::min(p0.y+sheight,height);
     int xmax=std::min(p0.x+swidth,width);
+    if (xmax <= xmin || ymax <= ymin) return;
+    hasDrawn=true;
     ColorAndAlpha *dstLine=buffer.get()+ymin*linelen+xmin;
     const ColorAndAlpha *srcLine=sbuf+(ymin-p0.y)*swidth+(xmin-p0.x);
     for (int y=ymin;y<ymax;y++){
-        const ColorAndAlpha *src=srcLine;
-        ColorAndAlpha *dst=dstLine;
-        for (int x=xmin;x<xmax;x++){
-            *dst=alpha(*dst,*src);
-            hasDrawn=true;
-            if (checkOnly) return;
-            dst++;
-            src++;
-        }
+        kernels->blend(dstLine,srcLine,xmax-xmin);
         srcLine+=swidth;
         dstLine+=linelen;
     }
@@ -1255,30 +1267,94 @@ void DrawingContext::drawGlyph(const Coord::PixelXy &p0 /*baseline left*/,int sw
     int ymin=std::max(0,p0.y);
     int ymax=std::min(p0.y+sheight,height);
     int xmax=std::min(p0.x+swidth,width);
+    if (xmax <= xmin || ymax <= ymin) return;
+    hasDrawn=true;
     ColorAndAlpha *dstLine=buffer.get()+ymin*linelen+xmin;
     const uint8_t *srcLine=sbuf+(ymin-p0.y)*swidth+(xmin-p0.x);
     for (int y=ymin;y<ymax;y++){
-        const uint8_t *src=srcLine;
-        ColorAndAlpha *dst=dstLine;
-        for (int x=xmin;x<xmax;x++){
-            
-            ColorAndAlpha dc=c & 0xffffff;
-            dc|=((ColorAndAlpha)(*src)) << 24;
-            *dst=alpha(*dst,dc);
-            hasDrawn=true;
-            if (checkOnly) return;
-            dst++;
-            src++;
-        }
+        kernels->glyph(dstLine,srcLine,xmax-xmin,c);
         srcLine+=swidth;
         dstLine+=linelen;
     }
 }
-void DrawingContext::drawTriangle(const Coord::PixelXy &p00, const Coord::PixelXy &p10, const Coord::PixelXy &p20, const ColorAndAlpha &color,const PatternSpec *pattern)
+DrawingContext::PatternTexture::PatternTexture(const ColorAndAlpha *symbol, int w, int h, int distance, bool stagger)
+{
+    if (symbol == nullptr || w <= 0 || h <= 0) return;
+    if (distance < 0) distance=0;
+    int xRaster=w+distance;
+    int yRaster=h+distance;
+    int numRows=stagger?2:1;
+    width=xRaster;
+    height=yRaster*numRows;
+    buffer.resize(width*height,0);
+    rows.resize(height);
+    for (int symbolRow=0;symbolRow<numRows;symbolRow++){
+        int shift=symbolRow*(xRaster/2);
+        for (int sy=0;sy<h;sy++){
+            ColorAndAlpha *dst=buffer.data()+(symbolRow*yRaster+sy)*width;
+            Row &row=rows[symbolRow*yRaster+sy];
+            const ColorAndAlpha *src=symbol+sy*w;
+            bool wrapped=false;
+            for (int sx=0;sx<w;sx++){
+                if (src[sx] == 0) continue;
+                int tx=(sx+shift)%width;
+                dst[tx]=src[sx];
+                if (row.last < row.first){
+                    row.first=tx;
+                    row.last=tx;
+                    continue;
+                }
+                if (tx < row.first){
+                    //wrapped around at the texture end
+                    wrapped=true;
+                }
+                if (tx > row.last) row.last=tx;
+            }
+            if (wrapped){
+                row.first=0;
+                row.last=width-1;
+            }
+        }
+    }
+}
+template<bool HIT>
+bool DrawingContext::drawSpanT(Coord::Pixel y, Coord::Pixel xmin, Coord::Pixel xmax, const ColorAndAlpha &color, const PatternSpec *pattern)
+{
+    if (pattern == nullptr){
+        hasDrawn=true;
+        if (HIT) return true;
+        kernels->fill(buffer.get() + y * linelen + xmin, xmax - xmin + 1, color);
+        return false;
+    }
+    const PatternTexture *texture=pattern->texture;
+    if (texture == nullptr || texture->width <= 0 || texture->height <= 0) return false;
+    Coord::Pixel ty = (y + pattern->yoffset) % texture->height;
+    if (ty < 0) ty+=texture->height;
+    const PatternTexture::Row &row=texture->rows[ty];
+    if (row.last < row.first) return false;
+    const ColorAndAlpha *psrc= texture->buffer.data()+ty*texture->width;
+    ColorAndAlpha *ptr = HIT ? nullptr : buffer.get() + y * linelen;
+    Coord::Pixel tx = (xmin + pattern->xoffset) % texture->width;
+    if (tx < 0) tx+=texture->width;
+    Coord::Pixel x=xmin;
+    while (x <= xmax){
+        //blend the used part of the texture row, wrap around at the texture end
+        Coord::Pixel start=std::max(tx,row.first);
+        Coord::Pixel end=std::min(row.last,tx+xmax-x);
+        if (start <= end){
+            hasDrawn=true;
+            if (HIT) return true;
+            kernels->blend(ptr+x+start-tx,psrc+start,end-start+1);
+        }
+        x+=texture->width-tx;
+        tx=0;
+    }
+    return false;
+}
+template<bool HIT>
+void DrawingContext::drawTriangleT(const Coord::PixelXy &p00, const Coord::PixelXy &p10, const Coord::PixelXy &p20, const ColorAndAlpha &color,const PatternSpec *pattern)
 {
     numTriangles++;
-    Coord::Pixel pxRaster=pattern?pattern->width+pattern->distance:0;
-    Coord::Pixel pyRaster=pattern?pattern->height+pattern->distance:0;
     Coord::Box<Coord::Pixel> extent;
     Coord::PixelXy p0 = p00;
     Coord::PixelXy p1 = p10;
@@ -1286,7 +1362,12 @@ void DrawingContext::drawTriangle(const Coord::PixelXy &p00, const Coord::PixelX
     extent.extend(p0);
     extent.extend(p1);
     extent.extend(p2);
-    //TODO: normalize! extent
+    if (extent.xmax < 0 || extent.xmin >= width || extent.ymax < 0 || extent.ymin >= height){
+        //completely outside - no need to set up the edges
+        triUnhitCount++;
+        return;
+    }
+    triHitCount++;
     if (p0.y > p1.y)
         std::swap(p0, p1);
     if (p0.y > p2.y)
@@ -1340,51 +1421,164 @@ void DrawingContext::drawTriangle(const Coord::PixelXy &p00, const Coord::PixelX
             std::swap(xmin, xmax);
         if (xmax >= 0 && xmin < width)
         {
-            // draw line
             xmin = std::max(0, xmin);
             xmax = std::min(width - 1, xmax);
-            if (pattern == nullptr){
-                ColorAndAlpha *ptr = buffer.get() + y * linelen + xmin;
-                for (Coord::Pixel x = xmin; x <= xmax; x++)
-                {
-                    hasDrawn=true;
-                    if (checkOnly) return;
-                    *ptr = color;
-                    ptr++;
-                }
+            if (drawSpanT<HIT>(y, xmin, xmax, color, pattern)) return;
+        }
+    }
+    return;
+}
+void DrawingContext::drawTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2, const ColorAndAlpha &color,const PatternSpec *pattern)
+{
+    drawTriangleT<false>(p0, p1, p2, color, pattern);
+}
+/**
+ * edge function for the corner check
+ * >0 if p is left of a->b
+ */
+static inline int64_t edgeSide(const Coord::PixelXy &a, const Coord::PixelXy &b, int64_t px, int64_t py){
+    return ((int64_t)b.x - a.x) * (py - a.y) - ((int64_t)b.y - a.y) * (px - a.x);
+}
+bool DrawingContext::coversAll(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2) const
+{
+    int64_t orientation=edgeSide(p0,p1,p2.x,p2.y);
+    if (orientation == 0) return false;
+    const int64_t corners[4][2]={{-1,-1},{width,-1},{-1,height},{width,height}};
+    for (int i=0;i<4;i++){
+        int64_t x=corners[i][0];
+        int64_t y=corners[i][1];
+        int64_t e0=edgeSide(p0,p1,x,y);
+        int64_t e1=edgeSide(p1,p2,x,y);
+        int64_t e2=edgeSide(p2,p0,x,y);
+        if (orientation > 0){
+            if (e0 <= 0 || e1 <= 0 || e2 <= 0) return false;
+        }
+        else{
+            if (e0 >= 0 || e1 >= 0 || e2 >= 0) return false;
+        }
+    }
+    return true;
+}
+template<bool HIT>
+void DrawingContext::fillAllT(const ColorAndAlpha &color, const PatternSpec *pattern)
+{
+    fillCount++;
+    for (Coord::Pixel y=0;y<height;y++){
+        if (drawSpanT<HIT>(y, 0, width-1, color, pattern)) return;
+    }
+}
+void DrawingContext::fillAll(const ColorAndAlpha &color, const PatternSpec *pattern)
+{
+    fillAllT<false>(color, pattern);
+}
+
+void DrawingContext::EdgeTable::addEdge(const Coord::PixelXy &p0, const Coord::PixelXy &p1)
+{
+    extent.extend(p0);
+    extent.extend(p1);
+    if (p0.y == p1.y) return;
+    Edge edge;
+    const Coord::PixelXy &top=(p0.y < p1.y)?p0:p1;
+    const Coord::PixelXy &bottom=(p0.y < p1.y)?p1:p0;
+    edge.dir=(p0.y < p1.y)?1:-1;
+    edge.ymin=top.y;
+    edge.ymax=bottom.y;
+    edge.x0=top.x;
+    edge.y0=top.y;
+    edge.dxdy=(double)(bottom.x-top.x)/(double)(bottom.y-top.y);
+    edges.push_back(edge);
+}
+void DrawingContext::EdgeTable::addTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2)
+{
+    int64_t orientation=((int64_t)p1.x-p0.x)*((int64_t)p2.y-p0.y)-((int64_t)p1.y-p0.y)*((int64_t)p2.x-p0.x);
+    if (orientation == 0) return;
+    if (orientation > 0){
+        addEdge(p0,p1);
+        addEdge(p1,p2);
+        addEdge(p2,p0);
+    }
+    else{
+        addEdge(p0,p2);
+        addEdge(p2,p1);
+        addEdge(p1,p0);
+    }
+}
+template<bool HIT>
+void DrawingContext::drawPolygonT(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern)
+{
+    numPolygons++;
+    if (table.edges.empty()) return;
+    const Coord::Box<Coord::Pixel> &extent=table.extent;
+    if (extent.xmax < 0 || extent.xmin >= width || extent.ymax < 0 || extent.ymin >= height) return;
+    std::vector<EdgeTable::Edge> &edges=table.edges;
+    std::sort(edges.begin(),edges.end(),[](const EdgeTable::Edge &a, const EdgeTable::Edge &b){
+        return a.ymin < b.ymin;
+    });
+    std::vector<size_t> &active=polygonActive;
+    std::vector<Crossing> &crossings=polygonCrossings;
+    active.clear();
+    size_t next=0;
+    Coord::Pixel ymin = std::max(0, extent.ymin);
+    Coord::Pixel ymax = std::min(height - 1, extent.ymax);
+    for (Coord::Pixel y = ymin; y <= ymax; y++)
+    {
+        //update the active edges
+        while (next < edges.size() && edges[next].ymin <= y){
+            if (edges[next].ymax > y) active.push_back(next);
+            next++;
+        }
+        avnav::erase_if(active,[&edges,y](size_t idx){
+            return edges[idx].ymax <= y;
+        });
+        if (active.empty()){
+            if (next >= edges.size()) break;
+            continue;
+        }
+        crossings.clear();
+        for (size_t idx:active){
+            crossings.push_back(Crossing(edges[idx].xAt(y),edges[idx].dir));
+        }
+        std::sort(crossings.begin(),crossings.end(),[](const Crossing &a, const Crossing &b){
+            return a.x < b.x;
+        });
+        //walk the crossings, merge adjacent spans
+        int winding=0;
+        bool hasSpan=false;
+        Coord::Pixel spanStart=0;
+        Coord::Pixel spanEnd=0;
+        Coord::Pixel start=0;
+        for (const auto &crossing:crossings){
+            int before=winding;
+            winding+=crossing.dir;
+            if (before == 0 && winding != 0){
+                start=(Coord::Pixel)std::floor(crossing.x+0.5);
+                continue;
             }
-            else{
-                if (pyRaster > 0 && pxRaster > 0)
-                {
-                    Coord::Pixel patterny = (y + pattern->yoffset) % pyRaster;
-                    if (patterny < pattern->height && patterny >= 0)
-                    {
-                        Coord::Pixel pxOffset = 0;
-                        if (pattern->stagger)
-                        {
-                            if (((y + pattern->yoffset) / pyRaster) & 1) //shift pattern in every second row
-                            {
-                                pxOffset=pxRaster/2;
-                            }
-                        }
-                        const ColorAndAlpha *psrc= pattern->buffer+patterny*pattern->width;
-                        ColorAndAlpha *ptr = buffer.get() + y * linelen;
-                        for (Coord::Pixel x=xmin;x <= xmax; x++){
-                            Coord::Pixel patternx= (x+pattern->xoffset+pxOffset)%pxRaster;
-                            if (patternx < pattern->width && patternx >= 0){
-                                ColorAndAlpha *target = ptr + x;
-                                ColorAndAlpha src= *(psrc+patternx);
-                                hasDrawn=true;
-                                *target=alpha(*target,src);
-                                if (checkOnly) return;
-                            }
-                        }
-                    }
-                }
+            if (before == 0 || winding != 0) continue;
+            Coord::Pixel end=(Coord::Pixel)std::floor(crossing.x+0.5);
+            if (end < 0 || start >= width) continue;
+            Coord::Pixel xmin=std::max(0,start);
+            Coord::Pixel xmax=std::min(width-1,end);
+            if (hasSpan && xmin <= (spanEnd+1)){
+                spanEnd=std::max(spanEnd,xmax);
+                continue;
+            }
+            if (hasSpan){
+                if (drawSpanT<HIT>(y,spanStart,spanEnd,color,pattern)) return;
             }
+            spanStart=xmin;
+            spanEnd=xmax;
+            hasSpan=true;
+        }
+        if (hasSpan){
+            if (drawSpanT<HIT>(y,spanStart,spanEnd,color,pattern)) return;
         }
     }
-    return;
+}
+
+void DrawingContext::drawPolygon(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern)
+{
+    drawPolygonT<false>(table, color, pattern);
 }
 
 String DrawingContext::getStatistics() const
@@ -1399,271 +1593,23 @@ String DrawingContext::getStatistics() const
             out << "(" << (int)(triHitCount * 100 / (triHitCount + triUnhitCount)) << ")";
         }
     }
+    out << " skippedLists=" << listSkipCount << " fills=" << fillCount;
+    out << " polygons=" << numPolygons;
     return out.str();
 }
 
 
+//the variants used by the HitTestContext
+template void DrawingContext::drawRectT<true>(Coord::Pixel, Coord::Pixel, Coord::Pixel, Coord::Pixel, ColorAndAlpha);
+template void DrawingContext::drawLineT<true, false, false>(const Coord::PixelXy &, const Coord::PixelXy &, const ColorAndAlpha &, const Dash *, bool);
+template void DrawingContext::drawThickLineT<true>(const Coord::PixelXy &, const Coord::PixelXy &, const ColorAndAlpha &, bool, const Dash *, unsigned int);
+template void DrawingContext::drawAaLineT<true>(const Coord::PixelXy &, const Coord::PixelXy &, ColorAndAlpha, const Dash *);
+template void DrawingContext::drawTriangleT<true>(const Coord::PixelXy &, const Coord::PixelXy &, const Coord::PixelXy &, const ColorAndAlpha &, const PatternSpec *);
+template void DrawingContext::fillAllT<true>(const ColorAndAlpha &, const PatternSpec *);
+template void DrawingContext::drawPolygonT<true>(EdgeTable &, const ColorAndAlpha &, const PatternSpec *);
+template void DrawingContext::drawArcT<true>(const Coord::PixelXy &, const ColorAndAlpha &, int, int, double, double);
+
 DrawingContext *DrawingContext::create(int width, int height)
 {
     return new DrawingContext(width, height);
 }
-
-DrawingContext::ColorAndAlpha DrawingContext::factors[256]={
-    //table for 255*256/x
-    1, //never used
-    65280,
-    32640,
-    21760,
-    16320,
-    13056,
-    10880,
-    9325,
-    8160,
-    7253,
-    6528,
-    5934,
-    5440,
-    5021,
-    4662,
-    4352,
-    4080,
-    3840,
-    3626,
-    3435,
-    3264,
-    3108,
-    2967,
-    2838,
-    2720,
-    2611,
-    2510,
-    2417,
-    2331,
-    2251,
-    2176,
-    2105,
-    2040,
-    1978,
-    1920,
-    1865,
-    1813,
-    1764,
-    1717,
-    1673,
-    1632,
-    1592,
-    1554,
-    1518,
-    1483,
-    1450,
-    1419,
-    1388,
-    1360,
-    1332,
-    1305,
-    1280,
-    1255,
-    1231,
-    1208,
-    1186,
-    1165,
-    1145,
-    1125,
-    1106,
-    1088,
-    1070,
-    1052,
-    1036,
-    1020,
-    1004,
-    989,
-    974,
-    960,
-    946,
-    932,
-    919,
-    906,
-    894,
-    882,
-    870,
-    858,
-    847,
-    836,
-    826,
-    816,
-    805,
-    796,
-    786,
-    777,
-    768,
-    759,
-    750,
-    741,
-    733,
-    725,
-    717,
-    709,
-    701,
-    694,
-    687,
-    680,
-    672,
-    666,
-    659,
-    652,
-    646,
-    640,
-    633,
-    627,
-    621,
-    615,
-    610,
-    604,
-    598,
-    593,
-    588,
-    582,
-    577,
-    572,
-    567,
-    562,
-    557,
-    553,
-    548,
-    544,
-    539,
-    535,
-    530,
-    526,
-    522,
-    518,
-    514,
-    510,
-    506,
-    502,
-    498,
-    494,
-    490,
-    487,
-    483,
-    480,
-    476,
-    473,
-    469,
-    466,
-    462,
-    459,
-    456,
-    453,
-    450,
-    447,
-    444,
-    441,
-    438,
-    435,
-    432,
-    429,
-    426,
-    423,
-    421,
-    418,
-    415,
-    413,
-    410,
-    408,
-    405,
-    402,
-    400,
-    398,
-    395,
-    393,
-    390,
-    388,
-    386,
-    384,
-    381,
-    379,
-    377,
-    375,
-    373,
-    370,
-    368,
-    366,
-    364,
-    362,
-    360,
-    358,
-    356,
-    354,
-    352,
-    350,
-    349,
-    347,
-    345,
-    343,
-    341,
-    340,
-    338,
-    336,
-    334,
-    333,
-    331,
-    329,
-    328,
-    326,
-    324,
-    323,
-    321,
-    320,
-    318,
-    316,
-    315,
-    313,
-    312,
-    310,
-    309,
-    307,
-    306,
-    305,
-    303,
-    302,
-    300,
-    299,
-    298,
-    296,
-    295,
-    294,
-    292,
-    291,
-    290,
-    288,
-    287,
-    286,
-    285,
-    283,
-    282,
-    281,
-    280,
-    278,
-    277,
-    276,
-    275,
-    274,
-    273,
-    272,
-    270,
-    269,
-    268,
-    267,
-    266,
-    265,
-    264,
-    263,
-    262,
-    261,
-    260,
-    259,
-    258,
-    257,
-    256
-};
@@ -38,6 +38,7 @@
 #include <dirent.h>
 #include <fnmatch.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 
 #include <sstream>
 #include <filesystem.hpp>
@@ -209,9 +210,43 @@ InputStream::Ptr FileHelper::openFileStream(const String &fileName, int bufferSi
     return std::make_shared<InputStream>(fd,bufferSize);
 }
 
+InputStream::Ptr FileHelper::openMappedFileStream(const String &fileName, int bufferSize){
+    if (fileName.empty()) throw AvException("filename is empty for open");
+    int fd=::open(fileName.c_str(),O_RDONLY);
+    if (fd < 0){
+        throw AvException(FMT("unable to open file %s:%s",fileName.c_str(),SystemHelper::sysError().c_str()));
+    }
+    struct stat64 data;
+    if (fstat64(fd,&data) == 0 && data.st_size > 0){
+        //private writable mapping: readers may modify the data in place
+        void *mapping=::mmap(NULL,data.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+        if (mapping != MAP_FAILED){
+            ::close(fd);
+            ::madvise(mapping,data.st_size,MADV_SEQUENTIAL);
+            return std::make_shared<InputStream>((char *)mapping,(size_t)data.st_size);
+        }
+        LOG_DEBUG("unable to map %s:%s, using normal read",fileName,SystemHelper::sysError());
+    }
+    return std::make_shared<InputStream>(fd,bufferSize);
+}
+
 InputStream::~InputStream(){
     close();
 }
+InputStream::InputStream(char *mapping, size_t mappedSize){
+    this->mapping=mapping;
+    this->mappedSize=mappedSize;
+}
+char * InputStream::ReadMapped(size_t len, size_t &available){
+    available=0;
+    if (! mapping) return nullptr;
+    available=mappedSize-bytesRead;
+    if (available > len) available=len;
+    char *rt=mapping+bytesRead;
+    bytesRead+=available;
+    if (bytesRead >= mappedSize) hasEof=true;
+    return rt;
+}
 InputStream::InputStream(int fd, size_t bufferSize){
     this->fd=fd;
     this->bufferSize=bufferSize;
@@ -242,6 +277,11 @@ ssize_t InputStream::read(char *buffer,size_t maxSize, long waitMillis){
     if (isClosed){
         return 0;
     }
+    if (mapping){
+        char *data=ReadMapped(maxSize,bRet);
+        if (bRet > 0) memcpy(buffer,data,bRet);
+        return bRet;
+    }
     if (bytesInBuffer > 0){
         size_t toCopy=(maxSize <= bytesInBuffer)?maxSize:bytesInBuffer;
         memcpy(buffer,this->buffer.get(),toCopy);
@@ -341,7 +381,13 @@ int InputStream::read(){
 }
 void InputStream::close(){
     if (isClosed) return;
-    ::close(fd);
+    if (mapping){
+        ::munmap(mapping,mappedSize);
+        mapping=nullptr;
+    }
+    else if (fd >= 0){
+        ::close(fd);
+    }
     isClosed=true;
 }
 size_t InputStream::BytesRead(){
@@ -358,6 +404,8 @@ bool InputStream::IsNonBlocking(){
 }
 bool InputStream::CheckRead(long waitMillis)
 {
+    if (mapping)
+        return bytesRead < mappedSize;
     if (bytesRead > 0 || bytesInBuffer > 0)
         return true;
     if (bufferSize < 1)
@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Level of detail geometry
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include "GeometryLod.h"
+#include <cmath>
+
+constexpr uint32_t GeometryLod::LEVEL_ZOOM[];
+
+static double squaredDistance(const Coord::WorldXy &p, const Coord::WorldXy &a, const Coord::WorldXy &b){
+    double dx=(double)b.x-(double)a.x;
+    double dy=(double)b.y-(double)a.y;
+    double px=(double)p.x-(double)a.x;
+    double py=(double)p.y-(double)a.y;
+    double len=dx*dx+dy*dy;
+    if (len <= 0) return px*px+py*py;
+    double t=(px*dx+py*dy)/len;
+    if (t < 0) t=0;
+    if (t > 1) t=1;
+    double ex=px-t*dx;
+    double ey=py-t*dy;
+    return ex*ex+ey*ey;
+}
+
+void GeometryLod::simplifyLine(const Coord::WorldXy *points, uint32_t num, Coord::World tolerance, Points &out){
+    out.clear();
+    if (num <= 2){
+        out.insert(out.end(),points,points+num);
+        return;
+    }
+    double limit=(double)tolerance*(double)tolerance;
+    std::vector<bool> keep(num,false);
+    keep[0]=true;
+    keep[num-1]=true;
+    std::vector<std::pair<uint32_t,uint32_t>> stack;
+    stack.push_back(std::make_pair(0,num-1));
+    while (! stack.empty()){
+        auto range=stack.back();
+        stack.pop_back();
+        double maxDist=-1;
+        uint32_t maxIdx=0;
+        for (uint32_t i=range.first+1;i<range.second;i++){
+            double dist=squaredDistance(points[i],points[range.first],points[range.second]);
+            if (dist > maxDist){
+                maxDist=dist;
+                maxIdx=i;
+            }
+        }
+        if (maxDist > limit){
+            keep[maxIdx]=true;
+            if ((maxIdx-range.first) > 1) stack.push_back(std::make_pair(range.first,maxIdx));
+            if ((range.second-maxIdx) > 1) stack.push_back(std::make_pair(maxIdx,range.second));
+        }
+    }
+    for (uint32_t i=0;i<num;i++){
+        if (keep[i]) out.push_back(points[i]);
+    }
+}
+
+void GeometryLod::toTriangles(uint8_t type, const Points &points, Points &out){
+    out.clear();
+    switch(type){
+        case 6: // PTG_TRIANGLE_FAN
+            for (size_t i=2;i<points.size();i++){
+                out.push_back(points[0]);
+                out.push_back(points[i-1]);
+                out.push_back(points[i]);
+            }
+            break;
+        case 5: // PTG_TRIANGLE_STRIP
+            for (size_t i=2;i<points.size();i++){
+                out.push_back(points[i-2]);
+                out.push_back(points[i-1]);
+                out.push_back(points[i]);
+            }
+            break;
+        case 4: // PTG_TRIANGLES
+            for (size_t i=0;(i+2)<points.size();i+=3){
+                out.push_back(points[i]);
+                out.push_back(points[i+1]);
+                out.push_back(points[i+2]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static inline Coord::World snap(Coord::World v, Coord::World gridSize){
+    int64_t half=gridSize/2;
+    int64_t rt=(int64_t)std::floor(((double)v+half)/gridSize)*gridSize;
+    if (rt > INT32_MAX) rt-=gridSize;
+    if (rt < INT32_MIN) rt+=gridSize;
+    return (Coord::World)rt;
+}
+
+void GeometryLod::snapTriangles(const Points &triangles, Coord::World gridSize, Points &out){
+    out.clear();
+    for (size_t i=0;(i+2)<triangles.size();i+=3){
+        Coord::WorldXy p[3];
+        for (int k=0;k<3;k++){
+            p[k]=Coord::WorldXy(snap(triangles[i+k].x,gridSize),snap(triangles[i+k].y,gridSize));
+        }
+        int64_t cross=((int64_t)p[1].x-p[0].x)*((int64_t)p[2].y-p[0].y)-
+            ((int64_t)p[1].y-p[0].y)*((int64_t)p[2].x-p[0].x);
+        if (cross == 0) continue;
+        out.push_back(p[0]);
+        out.push_back(p[1]);
+        out.push_back(p[2]);
+    }
+}
@@ -0,0 +1,74 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Hit test drawing context
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include "HitTestContext.h"
+
+//once we have a hit there is no need to check further primitives
+//until the caller resets the drawn flag
+void HitTestContext::drawRect(Coord::Pixel x0, Coord::Pixel y0, Coord::Pixel x1, Coord::Pixel y1, ColorAndAlpha color){
+    if (hasDrawn) return;
+    drawRectT<true>(x0,y0,x1,y1,color);
+}
+void HitTestContext::drawLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const ColorAndAlpha &color, bool alpha, const Dash *dash, bool overlapMajor){
+    if (hasDrawn) return;
+    drawLineT<true,false,false>(p0,p1,color,dash,overlapMajor);
+}
+void HitTestContext::drawThickLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const DrawingContext::ColorAndAlpha &color, bool useAlpha, const DrawingContext::Dash *dash, unsigned int aThickness,
+        ThicknessMode aThicknessMode){
+    if (hasDrawn) return;
+    drawThickLineT<true>(p0,p1,color,useAlpha,dash,aThickness);
+}
+void HitTestContext::drawAaLine(const Coord::PixelXy &p0, const Coord::PixelXy &p1, DrawingContext::ColorAndAlpha color, const Dash *dash){
+    if (hasDrawn) return;
+    drawAaLineT<true>(p0,p1,color,dash);
+}
+void HitTestContext::drawTriangle(const Coord::PixelXy &p0, const Coord::PixelXy &p1, const Coord::PixelXy &p2, const ColorAndAlpha &color, const PatternSpec *pattern){
+    if (hasDrawn) return;
+    drawTriangleT<true>(p0,p1,p2,color,pattern);
+}
+void HitTestContext::fillAll(const ColorAndAlpha &color, const PatternSpec *pattern){
+    if (hasDrawn) return;
+    fillAllT<true>(color,pattern);
+}
+void HitTestContext::drawPolygon(EdgeTable &table, const ColorAndAlpha &color, const PatternSpec *pattern){
+    if (hasDrawn) return;
+    drawPolygonT<true>(table,color,pattern);
+}
+bool HitTestContext::hitsBox(const Coord::PixelXy &p0, int swidth, int sheight) const{
+    if (p0.x >= width || p0.y >= height) return false;
+    if ((p0.x + swidth) <= 0 || (p0.y + sheight) <= 0) return false;
+    return swidth > 0 && sheight > 0;
+}
+void HitTestContext::drawSymbol(const Coord::PixelXy &p0, int swidth, int sheight, const ColorAndAlpha *sbuf){
+    if (hitsBox(p0,swidth,sheight)) hasDrawn=true;
+}
+void HitTestContext::drawGlyph(const Coord::PixelXy &p0, int swidth, int sheight, const uint8_t *sbuf, ColorAndAlpha c){
+    if (hitsBox(p0,swidth,sheight)) hasDrawn=true;
+}
+void HitTestContext::drawArc(const Coord::PixelXy &center, const ColorAndAlpha &color, int radius, int radiusInner, double startAngle, double endAngle){
+    if (hasDrawn) return;
+    drawArcT<true>(center,color,radius,radiusInner,startAngle,endAngle);
+}
@@ -26,84 +26,20 @@
  */
 #include "Chart.h"
 #include "OESUChart.h"
+#include "ChartInfo.h"
 #include "FileHelper.h"
 #include "Logger.h"
 #include <algorithm>
 #include <cmath>
 #include <map>
+#include <array>
 #include <unordered_set>
+#include <unordered_map>
+#include <limits>
 #include "Osenc.h"
 #include "generated/S57ObjectClasses.h"
 #include "generated/S57AttributeIds.h"
 
-#define INITIAL_BUFFER_SIZE 256
-#define MAX_BUFFER_SIZE (40*1024*1024)
-class RecordBuffer: public IRecordBuffer{
-    uint32_t size=INITIAL_BUFFER_SIZE;
-    char *buffer=new char[INITIAL_BUFFER_SIZE];
-    uint32_t fill=0;
-    String fileName;
-    bool ensure(uint32_t newSize){
-        bool changed=false;
-        while (size < newSize){
-            size = size << 2;
-            changed=true;
-        }
-        if (changed){
-            delete[] buffer;
-            buffer=new (std::nothrow) char[size]; 
-            if (! buffer){
-                throw FileException(fileName,FMT("unable to allocated %d bytes for record buffer",newSize));
-            }
-        }
-        return true;
-    }
-public:
-    RecordBuffer(const String &fileName){
-        this->fileName=fileName;
-    }
-    virtual ~RecordBuffer(){
-        delete []buffer;
-    }
-    virtual char * WriteToBuffer(InputStream::Ptr stream,uint32_t len) override{
-        fill=0;
-        if (len == 0){
-            return buffer;
-        }
-        if (len > MAX_BUFFER_SIZE){
-            throw Chart::InvalidChartException(fileName, FMT("buffer size %d too big",len));
-        }
-        ensure(len);
-        ssize_t rd=stream->read(buffer,len);
-        if (rd == 0){
-            throw NoDataException(fileName,"no data read from buffer");
-        }
-        if (rd < len){
-            throw NoDataException(fileName,FMT("unable to read %d bytes from stream, only got %d",len,rd));
-        }
-        fill=rd;
-        return buffer;
-    }
-    virtual uint32_t GetFill() override {return fill;}
-    virtual char* GetBuffer()override { return buffer;}
-    uint32_t forward(InputStream::Ptr stream,uint32_t len){
-        uint32_t skipped=0;
-        while (skipped < len){
-            size_t toRead=len-skipped;
-            if (toRead > size) toRead=size;
-            ssize_t rd=stream->read(buffer,toRead);
-            if (rd <= 0){
-                return skipped;
-            }
-            skipped+=rd;
-        }
-        return skipped;    
-    }
-    virtual const String & GetFileName() override{
-        return fileName;
-    }
-};
-
 OESUChart::OESUChart(const String &setKey, ChartType type, const String &fileName)
         :Chart(setKey,type,fileName),
         apool(ocalloc::makePool(FileHelper::fileName(fileName,false))),
@@ -113,6 +49,9 @@ OESUChart::OESUChart(const String &setKey, ChartType type, const String &fileNam
         floatAtons(poolRef),
         connectedNodeTable(poolRef),
         edgeNodeTable(poolRef),
+        edgePoints(poolRef),
+        lodEdgePoints(poolRef),
+        areaGeometry(poolRef),
         txtdscTable(poolRef)
         {
         }
@@ -120,7 +59,7 @@ OESUChart::OESUChart(const String &setKey, ChartType type, const String &fileNam
 template<class BT, bool hasScale>
 void parseAreaRecord(BT &reader,S57Object *currentObject,
     bool versionAbove200,
-    ocalloc::PoolRef poolRef,
+    CompactGeometry &geometry,
     const Coord::WorldXy &refPoint,
     double scale=1
     ){
@@ -132,6 +71,7 @@ void parseAreaRecord(BT &reader,S57Object *currentObject,
     ext.s_lat=p->extent_s_lat;
     currentObject->extent=ext.toWorld();
     currentObject->geoPrimitive=s52::GEO_AREA;
+    currentObject->geometry=&geometry;
     reader.SetBufferPointer(offsetof(typename BT::Type,payLoad));
     //OSenc.cpp#2773
     //skip pointcounts
@@ -141,22 +81,25 @@ void parseAreaRecord(BT &reader,S57Object *currentObject,
         reader.GetFromBuffer(&triType,1,"triType");
         uint32_t numberVertices=0;
         reader.GetFromBuffer(&numberVertices, 1,"numberVertices");
-        Coord::Extent ext;
         reader.skipDouble(4); //vert extent
-        S57Object::VertexList::Ptr vertexList=ocalloc::allocate_shared<S57Object::VertexList>(poolRef,triType,numberVertices,poolRef);
+        S57Object::VertexList vertexList(triType,geometry.startSequence());
         for (int vidx=0;vidx < numberVertices;vidx++){
             float tmp[2];
             reader.GetFromBuffer(&tmp[0],2,"Vertice");
+            Coord::WorldXy point;
             if constexpr(hasScale){
-                vertexList->add(Coord::worldFromSM(tmp[0]/scale,tmp[1]/scale,refPoint));
+                point=Coord::worldFromSM(tmp[0]/scale,tmp[1]/scale,refPoint);
             } else{
-                vertexList->add(Coord::worldFromSM(tmp[0],tmp[1],refPoint));
+                point=Coord::worldFromSM(tmp[0],tmp[1],refPoint);
             }
+            geometry.add(point);
+            vertexList.extent.extend(point);
+            vertexList.numAreaPoints++;
         }
-        currentObject->area.push_back(vertexList);
-        if (vertexList->points.size() > 0){
-            currentObject->extent.extend(vertexList->extent);
+        if (vertexList.numAreaPoints > 0){
+            currentObject->extent.extend(vertexList.extent);
         }
+        currentObject->area.push_back(vertexList);
     }
     int stride=versionAbove200?4:3;
     for (uint32_t i=0;i<p->edgeVector_count;i++){
@@ -306,6 +249,15 @@ bool OESUChart::ReadChartStream(InputStream::Ptr input,s52::S52Data::ConstPtr s5
                 }
             }
             //normal end - unable to read header
+            if (! headerOnly){
+                if (currentObject){
+                    s57Objects.push_back(currentObject);
+                    currentObject.reset();
+                }
+                buildLineGeometries();
+                buildAreaLod();
+                areaGeometry.finish();
+            }
             return true;
         } catch (FileException &f){
             throw;
@@ -382,6 +334,7 @@ bool OESUChart::ReadChartStream(InputStream::Ptr input,s52::S52Data::ConstPtr s5
                     llref,
                     Coord::latLonToWorld(llref)
                 );
+                areaGeometry.setOrigin(referencePoint->worldPoint);
                 extent=LLBox.toWorld();
                 if (extent.xmax < extent.xmin){
                     LOG_ERROR("invalid chart extent in %s: latlon=%s, world=%s",
@@ -472,7 +425,7 @@ bool OESUChart::ReadChartStream(InputStream::Ptr input,s52::S52Data::ConstPtr s5
                 }
                 if (! referencePoint) throw InvalidChartException(fileName,"area record before extent record");
                 OSENC_RecordAreaGeometry reader(&buffer);
-                parseAreaRecord<OSENC_RecordAreaGeometry,false>(reader,currentObject.get(),aboveV200(),poolRef,referencePoint->worldPoint);  
+                parseAreaRecord<OSENC_RecordAreaGeometry,false>(reader,currentObject.get(),aboveV200(),areaGeometry,referencePoint->worldPoint);  
             }
             break;
             case OSENC_RecordExtAreaGeometry::code():
@@ -485,7 +438,7 @@ bool OESUChart::ReadChartStream(InputStream::Ptr input,s52::S52Data::ConstPtr s5
                 auto record=reader.GetBuffer();
                 double scale=record->scaleFactor;
                 if (std::abs(scale) < 1e-5) scale=1;
-                parseAreaRecord<OSENC_RecordExtAreaGeometry,true>(reader,currentObject.get(),aboveV200(),poolRef,referencePoint->worldPoint,scale);  
+                parseAreaRecord<OSENC_RecordExtAreaGeometry,true>(reader,currentObject.get(),aboveV200(),areaGeometry,referencePoint->worldPoint,scale);  
             }
             break;
             case OSENC_RecordMultiPointGeometry::code():
@@ -692,6 +645,49 @@ static void addPolygonToObject(CurrentPolygon *polygon,S57Object *object){
 void OESUChart::buildLineGeometries(){
     //must be called when all objects and vectors are read
     //refer to AssembleLineGeometry in eSENCChart.cpp
+    //we copy all referenced edges into one contiguous array
+    //and only keep the spans in the lines
+    using EdgeSpan=std::pair<uint32_t,uint32_t>; //offset, num
+    std::unordered_map<int,EdgeSpan> edgeSpans;
+    size_t numEdgePoints=0;
+    for (auto it=s57Objects.begin();it!=s57Objects.end();it++){
+        for (const auto &line:(*it)->lines){
+            if (edgeSpans.find(line.vectorEdge) != edgeSpans.end()) continue;
+            auto edgeNodes=edgeNodeTable.find(line.vectorEdge);
+            if (edgeNodes == edgeNodeTable.end()) continue;
+            uint32_t num=edgeNodes->second.points.size();
+            edgeSpans[line.vectorEdge]=EdgeSpan(numEdgePoints,num);
+            numEdgePoints+=num;
+        }
+    }
+    edgePoints.clear();
+    edgePoints.resize(numEdgePoints);
+    for (const auto &[edge,span]:edgeSpans){
+        auto edgeNodes=edgeNodeTable.find(edge);
+        std::copy(edgeNodes->second.points.begin(),edgeNodes->second.points.end(),edgePoints.begin()+span.first);
+    }
+    //simplified edges, only stored if they really have less points
+    //spans with num == 0 use the full edge
+    using LodSpans=std::array<EdgeSpan,GeometryLod::NUM_LEVELS>;
+    std::unordered_map<int,LodSpans> lodSpans;
+    lodEdgePoints.clear();
+    GeometryLod::Points simplified;
+    for (const auto &[edge,span]:edgeSpans){
+        if (span.second <= 2) continue;
+        LodSpans spans;
+        bool hasLod=false;
+        for (int level=0;level<GeometryLod::NUM_LEVELS;level++){
+            spans[level]=EdgeSpan(0,0);
+            GeometryLod::simplifyLine(edgePoints.data()+span.first,span.second,
+                GeometryLod::pixelSize(level)/2,simplified);
+            if (simplified.size() >= span.second) continue;
+            spans[level]=EdgeSpan(lodEdgePoints.size(),simplified.size());
+            lodEdgePoints.insert(lodEdgePoints.end(),simplified.begin(),simplified.end());
+            hasLod=true;
+        }
+        if (hasLod) lodSpans[edge]=spans;
+    }
+    lodEdgePoints.shrink_to_fit();
     for (auto it=s57Objects.begin();it!=s57Objects.end();it++){
         S57Object *obj=(*it).get();
         if (obj->lines.size() < 1) continue;
@@ -699,15 +695,28 @@ void OESUChart::buildLineGeometries(){
         for (auto line=obj->lines.begin();line != obj->lines.end();line++){
             auto firstConPoint=connectedNodeTable.find(line->first);
             auto lastConPoint=connectedNodeTable.find(line->endNode);
-            auto edgeNodes=edgeNodeTable.find(line->vectorEdge);
-            if (edgeNodes != edgeNodeTable.end()){
-                //we are sure that the edge nodes are not changed any more
-                //so we can safely get pointers to them
-                line->edgeNodes=&(edgeNodes->second.points);
-                for (auto it=edgeNodes->second.points.begin();
-                        it != edgeNodes->second.points.end();it++){
-                            obj->extent.extend(*it);
-                        }
+            auto span=edgeSpans.find(line->vectorEdge);
+            const Coord::WorldXy *edgeNodes=nullptr;
+            uint32_t numEdgeNodes=0;
+            if (span != edgeSpans.end() && span->second.second > 0){
+                //edgePoints is not changed any more
+                //so we can safely get pointers to it
+                edgeNodes=edgePoints.data()+span->second.first;
+                numEdgeNodes=span->second.second;
+                line->edgeNodes=edgeNodes;
+                line->numEdgeNodes=numEdgeNodes;
+                auto lod=lodSpans.find(line->vectorEdge);
+                if (lod != lodSpans.end()){
+                    for (int level=0;level<GeometryLod::NUM_LEVELS;level++){
+                        const EdgeSpan &lodSpan=lod->second[level];
+                        if (lodSpan.second == 0) continue;
+                        line->lod[level].nodes=lodEdgePoints.data()+lodSpan.first;
+                        line->lod[level].num=lodSpan.second;
+                    }
+                }
+                for (uint32_t i=0;i<numEdgeNodes;i++){
+                    obj->extent.extend(edgeNodes[i]);
+                }
             }
             if (firstConPoint == connectedNodeTable.end()){
                 int debug=1;
@@ -715,11 +724,11 @@ void OESUChart::buildLineGeometries(){
             }
             if (firstConPoint != connectedNodeTable.end()){
                 obj->extent.extend(firstConPoint->second);
-                if (edgeNodes != edgeNodeTable.end() && edgeNodes->second.points.size() > 0){
+                if (numEdgeNodes > 0){
                     line->startSegment.start=firstConPoint->second;
                     line->startSegment.end=line->forward?
-                        edgeNodes->second.points[0]:
-                        edgeNodes->second.points[edgeNodes->second.points.size()-1];
+                        edgeNodes[0]:
+                        edgeNodes[numEdgeNodes-1];
                     line->startSegment.valid=true;    
                 }
             }
@@ -729,11 +738,11 @@ void OESUChart::buildLineGeometries(){
             }
             if (lastConPoint != connectedNodeTable.end() && firstConPoint != connectedNodeTable.end()){
                 obj->extent.extend(lastConPoint->second);
-                if (edgeNodes != edgeNodeTable.end() && edgeNodes->second.points.size() > 0){
+                if (numEdgeNodes > 0){
                     line->endSegment.end=lastConPoint->second;
                     line->endSegment.start=line->forward?
-                        edgeNodes->second.points[edgeNodes->second.points.size()-1]:
-                        edgeNodes->second.points[0];
+                        edgeNodes[numEdgeNodes-1]:
+                        edgeNodes[0];
                     line->endSegment.valid=true;
                 }
                 else{
@@ -779,6 +788,9 @@ void OESUChart::buildLineGeometries(){
             polygon.reset();
         }
     }
+    //the node tables are not needed any more
+    edgeNodeTable.clear();
+    connectedNodeTable.clear();
 }
 
 static std::unordered_set<uint16_t> BOYS({
@@ -819,37 +831,61 @@ bool OESUChart::setRigidFloat(const S57Object *obj){
 OESUChart::~OESUChart(){
     int x=1;
 }
-bool OESUChart::PrepareRender(s52::S52Data::ConstPtr s52data){
-    LOG_DEBUG("%s: prepareRender",fileName);
-    if (! s52data) throw FileException(fileName,"s52data not set in prepareRender");
-    //TEMP - can already been done after loading
-    buildLineGeometries();
-    //currently we cannot recreate the render data as our allocator is 
-    //bound to the chart and we are unable to drop the render data allone
-    //additionally we have to ensure that only on thread at a time
-    //is working with our allocator any way
-    renderData=ocalloc::allocate_shared_pool<RenderData>(poolRef,s52data);
-    RenderSettings::ConstPtr rs=s52data->getSettings();
-    s52::LUPname boundaryStyle=rs->nBoundaryStyle;
-    s52::LUPname symbolStyle=rs->nSymbolStyle;
-    //compute the best matching safety contour
-    //see eSencChart::BuildDepthContourArray
-    double safetyDepth=rs->S52_MAR_SAFETY_CONTOUR;
-    for (auto it=s57Objects.begin();it != s57Objects.end();it++){
-        if ((*it)->featureTypeCode==S57ObjectClasses::DEPCNT){
-            double valdco=1e6;
-            if ((*it)->attributes.getDouble(S57AttrIds::VALDCO,valdco)){
-                if (valdco >= safetyDepth && valdco < renderData->nextSafetyContour){
-                    renderData->nextSafetyContour=valdco;
+static bool compareRenderObjects(const S57Object::RenderObject::Ptr &left,const S57Object::RenderObject::Ptr &right){
+    return left->GetDisplayPriority() < right->GetDisplayPriority();
+}
+void OESUChart::buildAreaLod(){
+    //as we append to the geometry while reading from it
+    //we first copy the points of a vertex list
+    GeometryLod::Points points;
+    GeometryLod::Points triangles;
+    GeometryLod::Points snapped;
+    for (auto it=s57Objects.begin();it!=s57Objects.end();it++){
+        S57Object *obj=(*it).get();
+        for (auto &vit:obj->area){
+            if (vit.numAreaPoints < 3) continue;
+            points.clear();
+            CompactGeometry::Reader reader(areaGeometry,vit.offset);
+            for (uint32_t i=0;i<vit.numAreaPoints;i++){
+                points.push_back(reader.next());
+            }
+            GeometryLod::toTriangles(vit.type,points,triangles);
+            //the levels are stored as plain triangles (3 points each)
+            //while fans and strips need about one point per triangle
+            //so we compare the stored points, not the triangles
+            uint32_t limit=vit.numAreaPoints;
+            int last=-1;
+            for (int level=0;level<GeometryLod::NUM_LEVELS;level++){
+                GeometryLod::snapTriangles(triangles,GeometryLod::pixelSize(level),snapped);
+                //only worth it if we save at least a quarter of the points
+                if (snapped.size()*4 > (size_t)limit*3){
+                    if (last >= 0){
+                        //not much better than the finer level - share it
+                        vit.lodOffset[level]=vit.lodOffset[last];
+                        vit.lodNumPoints[level]=vit.lodNumPoints[last];
+                    }
+                    continue;
                 }
+                vit.lodOffset[level]=areaGeometry.startSequence();
+                for (const auto &p:snapped) areaGeometry.add(p);
+                vit.lodNumPoints[level]=snapped.size();
+                limit=snapped.size();
+                last=level;
             }
         }
     }
-    for (auto it=s57Objects.begin();it != s57Objects.end();it++){
+}
+void OESUChart::prepareObjects(RenderData::RenderObjects &objects, size_t start, size_t end, 
+        s52::RuleCreator *creator,ocalloc::PoolRef pool,const s52::S52Data *s52data) const{
+    RenderSettings::ConstPtr rs=s52data->getSettings();
+    s52::LUPname boundaryStyle=rs->nBoundaryStyle;
+    s52::LUPname symbolStyle=rs->nSymbolStyle;
+    for (size_t idx=start;idx < end;idx++){
+        const S57Object::Ptr &object=s57Objects[idx];
         const s52::LUPrec *LUP=nullptr;
         s52::LUPname LUP_Name = s52::PAPER_CHART;
 
-        switch( (*it)->geoPrimitive ){
+        switch( object->geoPrimitive ){
             case s52::GEO_POINT:
             case s52::GEO_META:
             case s52::GEO_PRIM:
@@ -869,66 +905,162 @@ bool OESUChart::PrepareRender(s52::S52Data::ConstPtr s52data){
                     LUP_Name = s52::SYMBOLIZED_BOUNDARIES;
                 break;
         }
-        LUP=s52data->findLUPrecord(LUP_Name,(*it)->featureTypeCode,&((*it)->attributes));
-        //LOG_DEBUG("chart object %d->%s: LUP RCID %d",(*it)->featureTypeCode, s52data->objectName((*it)->featureTypeCode),LUP?LUP->RCID:-1);
+        LUP=s52data->findLUPrecord(LUP_Name,object->featureTypeCode,&(object->attributes));
+        //LOG_DEBUG("chart object %d->%s: LUP RCID %d",object->featureTypeCode, s52data->objectName(object->featureTypeCode),LUP?LUP->RCID:-1);
         if (! LUP) {
             ;
             //ignore this object
         }
         else{
-            S57Object::RenderObject::Ptr renderObject=ocalloc::allocate_shared_pool<S57Object::RenderObject>(poolRef,(*it));        
+            S57Object::RenderObject::Ptr renderObject=ocalloc::allocate_shared_pool<S57Object::RenderObject>(pool,object);        
             s52::RuleConditions conditions;
-            conditions.geoPrimitive=(*it)->geoPrimitive;
-            conditions.attributes=&((*it)->attributes);
+            conditions.geoPrimitive=object->geoPrimitive;
+            conditions.attributes=&(object->attributes);
             conditions.nextSafetyContour=renderData->nextSafetyContour;
-            conditions.featureTypeCode=(*it)->featureTypeCode;
-            if ((*it)->geoPrimitive == s52::GEO_POINT){
+            conditions.featureTypeCode=object->featureTypeCode;
+            if (object->geoPrimitive == s52::GEO_POINT){
                 //floating base if there is a floating object at the same coordinates - but not a rigid
                 //see TOPMAR01 rule in orig plugin code
-                conditions.hasFloatingBase=floatAtons.find((*it)->point) != floatAtons.end() && rigidAtons.find((*it)->point) == rigidAtons.end();
+                conditions.hasFloatingBase=floatAtons.find(object->point) != floatAtons.end() && rigidAtons.find(object->point) == rigidAtons.end();
             }
             renderObject->SetLUP(LUP);
-            renderObject->expand(s52data.get(), &(renderData->ruleCreator), &conditions);
-            if (renderObject->shouldRenderCat(s52data->getSettings().get())){
-                renderData->addObject(renderObject);
+            renderObject->expand(s52data, creator, &conditions);
+            if (renderObject->shouldRenderCat(rs.get())){
+                objects.push_back(renderObject);
             }
         }
     }
     //sort by display priority
-    std::stable_sort(renderData->renderObjects.begin(),renderData->renderObjects.end(),
-        [](const S57Object::RenderObject::Ptr &left,const S57Object::RenderObject::Ptr &right){
-            return left->GetDisplayPriority() < right->GetDisplayPriority();
-        });
-    LOG_DEBUG("%s: prepareRender with %d objects",fileName,renderData->renderObjects.size());
-    renderData=renderData;
-    return true;
+    std::stable_sort(objects.begin(),objects.end(),compareRenderObjects);
 }
-class OESURenderContext: public ChartRenderContext{
-    String name;
-    public:
-        using ObjectList=std::vector<const S57Object::RenderObject*>;
-
-        std::map<int,ObjectList> matchingObjects;
-        ObjectList symbolAreObjects;
-        
-        void add(const S57Object::RenderObject* object){
-            int prio=object->GetDisplayPriority();
-            if (auto it=matchingObjects.find(prio) == matchingObjects.end()){
-                ObjectList prioObjects;
-                matchingObjects[prio]=prioObjects;
+bool OESUChart::PrepareRender(s52::S52Data::ConstPtr s52data, WorkerPool::Ptr workers){
+    LOG_DEBUG("%s: prepareRender",fileName);
+    if (! s52data) throw FileException(fileName,"s52data not set in prepareRender");
+    //currently we cannot recreate the render data as our allocator is 
+    //bound to the chart and we are unable to drop the render data allone
+    //additionally we have to ensure that only on thread at a time
+    //is working with our allocator any way
+    renderData=ocalloc::allocate_shared_pool<RenderData>(poolRef,s52data);
+    RenderSettings::ConstPtr rs=s52data->getSettings();
+    //compute the best matching safety contour
+    //see eSencChart::BuildDepthContourArray
+    double safetyDepth=rs->S52_MAR_SAFETY_CONTOUR;
+    for (auto it=s57Objects.begin();it != s57Objects.end();it++){
+        if ((*it)->featureTypeCode==S57ObjectClasses::DEPCNT){
+            double valdco=1e6;
+            if ((*it)->attributes.getDouble(S57AttrIds::VALDCO,valdco)){
+                if (valdco >= safetyDepth && valdco < renderData->nextSafetyContour){
+                    renderData->nextSafetyContour=valdco;
+                }
+            }
+        }
+    }
+    size_t numObjects=s57Objects.size();
+    size_t numPartitions=1;
+    if (workers){
+        numPartitions=std::min((size_t)workers->GetNumThreads()+1,numObjects/MIN_PARTITION_OBJECTS);
+    }
+    if (numPartitions <= 1){
+        prepareObjects(renderData->renderObjects,0,numObjects,&(renderData->ruleCreator),poolRef,s52data.get());
+    }
+    else{
+        //each part gets its own pool and rule creator as they are not thread safe
+        //the first part uses the chart pool
+        //as every part is sorted (stable) merging them in order 
+        //gives the same result as sorting all objects
+        std::vector<ocalloc::PoolRef> pools;
+        pools.reserve(numPartitions);
+        pools.push_back(poolRef);
+        for (size_t i=1;i<numPartitions;i++){
+            if (partitionPools.size() < i){
+                partitionPools.push_back(std::unique_ptr<ocalloc::Pool>(
+                    ocalloc::makePool(FileHelper::fileName(fileName,false)+FMT("-%d",i))));
             }
-            matchingObjects[prio].push_back(object);
-            if (object->hasRuleInStep(s52::RS_AREASY)) symbolAreObjects.push_back(object);
+            pools.push_back(ocalloc::PoolRef(partitionPools[i-1]));
+            renderData->partitionCreators.push_back(std::make_unique<s52::RuleCreator>(pools[i],i+1));
         }
-        OESURenderContext(String n):name(n){
+        std::vector<RenderData::RenderObjects> results;
+        std::vector<WorkerPool::Task> tasks;
+        for (size_t i=0;i<numPartitions;i++){
+            results.push_back(RenderData::RenderObjects(pools[i]));
         }
-        void prepare(){
+        for (size_t i=0;i<numPartitions;i++){
+            size_t start=numObjects*i/numPartitions;
+            size_t end=numObjects*(i+1)/numPartitions;
+            s52::RuleCreator *creator=(i == 0)?&(renderData->ruleCreator):renderData->partitionCreators[i-1].get();
+            tasks.push_back([this,&results,i,start,end,creator,&pools,&s52data](){
+                prepareObjects(results[i],start,end,creator,pools[i],s52data.get());
+            });
         }
-        virtual ~OESURenderContext(){
-            matchingObjects.clear();
-            LOG_DEBUG("ChartRenderCtx %s destroy",name);
+        workers->RunAll(tasks);
+        RenderData::RenderObjects &merged=renderData->renderObjects;
+        size_t numResults=0;
+        for (auto &&result:results) numResults+=result.size();
+        merged.reserve(numResults);
+        for (auto &&result:results){
+            size_t mid=merged.size();
+            merged.insert(merged.end(),result.begin(),result.end());
+            std::inplace_merge(merged.begin(),merged.begin()+mid,merged.end(),compareRenderObjects);
         }
-};
+    }
+    renderData->buildIndex(poolRef);
+    renderData->buildPasses();
+    LOG_DEBUG("%s: prepareRender with %d objects in %d parts",fileName,renderData->renderObjects.size(),numPartitions);
+    return true;
+}
+void OESUChart::RenderData::buildIndex(ocalloc::PoolRef pool){
+    const RenderSettings *settings=s52data->getSettings().get();
+    ZoomLevelScales scales(settings->scale);
+    buckets.clear();
+    //bucket MAX_ZOOM+1: never visible with the current settings
+    buckets.resize(MAX_ZOOM+2);
+    for (uint32_t i=0;i<renderObjects.size();i++){
+        const S57Object::RenderObject *ro=renderObjects[i].get();
+        int maxScale=ro->GetMaxScale(settings);
+        int zoom=0;
+        if (maxScale != std::numeric_limits<int>::max()){
+            while (zoom <= MAX_ZOOM && scales.GetScaleForZoom(zoom) > maxScale) zoom++;
+        }
+        if (! buckets[zoom]) buckets[zoom]=std::make_unique<ZoomBucket>(pool,zoom);
+        ZoomBucket *bucket=buckets[zoom].get();
+        bucket->index.add(ro->GetIndexExtent(),i);
+        if (maxScale > bucket->maxScale) bucket->maxScale=maxScale;
+        maxPixelMargin=std::max(maxPixelMargin,ro->GetPixelMargin());
+    }
+    avnav::erase_if(buckets,[](const std::unique_ptr<ZoomBucket> &bucket){
+        return !bucket;
+    });
+    for (auto &bucket:buckets){
+        bucket->index.build();
+    }
+}
+static inline Coord::World clampWorld(int64_t v){
+    if (v < std::numeric_limits<Coord::World>::min()) return std::numeric_limits<Coord::World>::min();
+    if (v > std::numeric_limits<Coord::World>::max()) return std::numeric_limits<Coord::World>::max();
+    return v;
+}
+void OESUChart::RenderData::findObjects(const Coord::PixelBox &pixelBox, const Coord::TileBox &tile, int scale, SpatialIndex::IdList &result) const{
+    //objects are checked against the tile in world coordinates
+    //and with their pixel extents against the pixel box
+    //so we search for the union of the tile and the pixel box
+    //expanded by the max margin (+ some rounding)
+    int64_t pixelScale=1;
+    if (tile.zoom <= Coord::COORD_ZOOM_LEVEL){
+        pixelScale=((int64_t)1) << (Coord::COORD_ZOOM_LEVEL-tile.zoom+Coord::SUB_PIXEL_BITS);
+    }
+    int64_t margin=maxPixelMargin+2;
+    Coord::Extent query;
+    query.xmin=clampWorld(std::min((int64_t)tile.xmin,tile.xmin+(pixelBox.xmin-margin)*pixelScale));
+    query.xmax=clampWorld(std::max((int64_t)tile.xmax,tile.xmin+(pixelBox.xmax+margin)*pixelScale));
+    query.ymin=clampWorld(std::min((int64_t)tile.ymin,tile.ymin+(pixelBox.ymin-margin)*pixelScale));
+    query.ymax=clampWorld(std::max((int64_t)tile.ymax,tile.ymin+(pixelBox.ymax+margin)*pixelScale));
+    query.valid=true;
+    for (const auto &bucket:buckets){
+        if (scale > bucket->maxScale) continue;
+        bucket->index.query(query,result);
+    }
+    std::sort(result.begin(),result.end());
+}
 static std::vector<s52::RenderStep> renderSteps({
     s52::RenderStep::RS_AREAS2,
     s52::RenderStep::RS_LINES,
@@ -940,9 +1072,78 @@ static std::vector<s52::RenderStep> overlayRenderSteps({
 static const int firstPassSteps=s52::PRIO_NUM * renderSteps.size()+2;
 static const int overlayPassSteps=s52::PRIO_NUM * overlayRenderSteps.size();
 
+class OESURenderContext: public ChartRenderContext{
+    String name;
+    public:
+        class Entry{
+            public:
+            const S57Object::RenderObject *object;
+            const S57Object::RenderObject::DrawCommand *command;
+            Entry(const S57Object::RenderObject *o, const S57Object::RenderObject::DrawCommand *c):object(o),command(c){}
+        };
+        using PassList=std::vector<Entry>;
+        //the (object,command) pairs for each pass (except pass 0) for this tile
+        std::vector<PassList> passLists;
+        uint64_t passMask=1; //pass 0 is always there
+
+        void add(const S57Object::RenderObject::Ptr &object, uint32_t pass, const S57Object::RenderObject::DrawCommand *command){
+            passLists[pass].push_back(Entry(object.get(),command));
+            passMask|=((uint64_t)1) << pass;
+        }
+        virtual bool HasPass(int pass) const override{
+            if (pass < 0 || pass >= 64) return false;
+            return (passMask & (((uint64_t)1) << pass)) != 0;
+        }
+        OESURenderContext(String n, int numPasses):name(n),passLists(numPasses){
+        }
+        virtual ~OESURenderContext(){
+            passLists.clear();
+            LOG_DEBUG("ChartRenderCtx %s destroy",name);
+        }
+};
+
 int OESUChart::getRenderPasses() const{
     return firstPassSteps+overlayPassSteps; //see comment below about passes
 }
+bool OESUChart::HasRenderPass(int pass) const{
+    RenderData* currentRenderData=renderData.get();
+    if (! currentRenderData) return pass == 0; //let render throw
+    if (pass < 0 || pass >= getRenderPasses()) return false;
+    return (currentRenderData->passMask & (((uint64_t)1) << pass)) != 0;
+}
+
+void OESUChart::RenderData::buildPasses(){
+    if ((firstPassSteps+overlayPassSteps) > 64){
+        throw AvException("too many render passes for the pass mask");
+    }
+    passRules.clear();
+    passRuleStart.clear();
+    passMask=0;
+    passRuleStart.reserve(renderObjects.size()+1);
+    auto addStep=[this](const S57Object::RenderObject *ro,uint32_t pass,s52::RenderStep step){
+        for (const auto &command:ro->GetCommands(step)){
+            passRules.push_back(PassRule(pass,&command));
+            passMask|=((uint64_t)1) << pass;
+        }
+    };
+    for (const auto &ro:renderObjects){
+        passRuleStart.push_back(passRules.size());
+        addStep(ro.get(),0,s52::RS_AREAS1);
+        addStep(ro.get(),1,s52::RS_AREASY);
+        int prio=ro->GetDisplayPriority();
+        if (prio < 0 || prio >= s52::PRIO_NUM) continue;
+        for (size_t step=0;step < renderSteps.size();step++){
+            addStep(ro.get(),2+prio*renderSteps.size()+step,renderSteps[step]);
+        }
+        for (size_t step=0;step < overlayRenderSteps.size();step++){
+            addStep(ro.get(),firstPassSteps+prio*overlayRenderSteps.size()+step,overlayRenderSteps[step]);
+        }
+    }
+    passRuleStart.push_back(passRules.size());
+    //pass 0 creates the chart context
+    if (renderObjects.size() > 0) passMask|=1;
+    passRules.shrink_to_fit();
+}
 
 
 Chart::RenderResult OESUChart::Render(int pass,RenderContext & renderCtx, DrawingContext &ctx, Coord::TileBox const &tile) const
@@ -959,10 +1160,10 @@ Chart::RenderResult OESUChart::Render(int pass,RenderContext & renderCtx, Drawin
      * (4) render "overlays" (like texts): iterate over priorities
      *     on each:
      *     () render texts       
+     * the pass for each draw command of an object is computed in prepareRender (buildPasses)
+     * in pass 0 we collect the (object,command) pairs of the objects intersecting
+     * the tile into one list per pass
      **/
-    //render objects are sorted by prio
-    //1st step: render all areas
-    //we use this to keep in mind the objects that intersect
     //as the list of objects does not change we can safely use pointers
     // the renderer mus ensure to hold a reference to the chart
     //during the complete render process
@@ -984,71 +1185,40 @@ Chart::RenderResult OESUChart::Render(int pass,RenderContext & renderCtx, Drawin
         if (pass != 0){
             throw AvException(FMT("%s: pass %d without chart context",fileName,pass));
         }
-        chartCtx = new OESURenderContext(fileName);
+        chartCtx = new OESURenderContext(fileName,getRenderPasses());
         renderCtx.chartContext.reset(chartCtx);
-        for (auto it = currentRenderData->renderObjects.begin(); it != currentRenderData->renderObjects.end(); it++)
+        const RenderSettings *settings=renderCtx.s52Data->getSettings().get();
+        //the index gives us the candidates in the original (priority) order
+        SpatialIndex::IdList candidates;
+        currentRenderData->findObjects(renderCtx.tileExtent,tile,renderCtx.scale,candidates);
+        for (auto idx:candidates)
         {
-            if (!(*it)->Intersects(renderCtx.tileExtent, tile))
+            const S57Object::RenderObject::Ptr &ro=currentRenderData->renderObjects[idx];
+            if (!ro->Intersects(renderCtx.tileExtent, tile))
             {
                 continue;
             }
-            chartCtx->add((*it).get());
-            //we assume step 0 here any way
-            (*it)->Render(renderCtx, ctx, tile, s52::RS_AREAS1);
+            if (! ro->shouldRenderScale(settings,renderCtx.scale)) continue;
+            uint32_t end=currentRenderData->passRuleStart[idx+1];
+            for (uint32_t ridx=currentRenderData->passRuleStart[idx];ridx < end;ridx++){
+                const RenderData::PassRule &pr=currentRenderData->passRules[ridx];
+                if (pr.pass == 0){
+                    ro->RenderCommand(renderCtx, ctx, tile, currentRenderData->s52data.get(), *(pr.command));
+                }
+                else{
+                    chartCtx->add(ro,pr.pass,pr.command);
+                }
+            }
         }
-        chartCtx->prepare();
         return RenderResult::ROK;
     }
     chartCtx=(OESURenderContext*)(renderCtx.chartContext.get());
     if (pass < 1){
         throw AvException(FMT("%s: pass 0 with existing chartContext",fileName));
     }
-    if (pass == 1){
-        //symbolized areas
-        for (auto &&ro:chartCtx->symbolAreObjects){
-            ro->Render(renderCtx, ctx, tile, s52::RS_AREASY);
-        }
-        return RenderResult::ROK;
-    }
-    //now all the rest priority based
-    int prio=0;
-    int step=0;
-    int origPass=pass;
-    bool overlay=false;
-    std::vector<s52::RenderStep> *currentSteps=NULL;
-    if (pass < firstPassSteps){
-        currentSteps=&renderSteps;
-        pass-=2;
-        prio = pass / renderSteps.size();
-        step=pass - prio * renderSteps.size();
-    }
-    else{
-        overlay=true;
-        currentSteps=&overlayRenderSteps;
-        if (pass == firstPassSteps){
-            //first overlay step - reset the context
-            chartCtx->prepare();
-        }
-        pass-=firstPassSteps;
-        if (pass < 0) return RenderResult::ROK;
-        prio=pass/overlayRenderSteps.size();
-        step=pass - prio * overlayRenderSteps.size();
-    }
-    /*LOG_DEBUG("Render %s pass %s, prio=%d, step=%d, overlay=%d",
-        fileName,
-        origPass,prio,step,overlay);
-        */
-    if (step >= currentSteps->size()){
-        throw AvException(FMT("%s: invalid renderStep %d",fileName,step));
-    }
-    if (prio >= s52::PRIO_NUM){
-        throw AvException(FMT("%s: invalid priority %d",fileName,prio));
-    }
-    const auto it=chartCtx->matchingObjects.find(prio);
-    if (it == chartCtx->matchingObjects.end()) return RenderResult::ROK;
-    s52::RenderStep renderStep=(*currentSteps)[step];
-    for (const auto renderObject:it->second){
-        renderObject->Render(renderCtx,ctx,tile,renderStep);
+    if (! chartCtx->HasPass(pass)) return RenderResult::ROK;
+    for (const auto &entry:chartCtx->passLists[pass]){
+        entry.object->RenderCommand(renderCtx,ctx,tile,currentRenderData->s52data.get(),*(entry.command));
     }
     return RenderResult::ROK;
 }
@@ -1096,8 +1266,11 @@ ObjectList OESUChart::FeatureInfo(RenderContext & context,DrawingContext &drawin
     rt.push_back(cd);
     RenderData *currentRenderData=renderData.get();
     context.chartContext.reset();
-    for (auto &it : currentRenderData->renderObjects){
-        ObjectDescription::Ptr description=it->getObjectDescription(context,drawing,box,overview,
+    SpatialIndex::IdList candidates;
+    currentRenderData->findObjects(context.tileExtent,box,context.scale,candidates);
+    for (auto idx : candidates){
+        const S57Object::RenderObject::Ptr &it=currentRenderData->renderObjects[idx];
+        ObjectDescription::Ptr description=it->getObjectDescription(context,drawing,box,currentRenderData->s52data.get(),overview,
             [this](const String &name){
                 ocalloc::String key(this->txtdscTable.get_allocator());
                 key.assign(name.c_str());
@@ -51,6 +51,7 @@
 #include <poll.h>
 
 #define TMP_PREFIX "OEX"
+#define RECEIVE_BUFFER_SIZE (1024*1024)
 #ifndef OCHARTS_VERSION
 #define OCHARTS_TEXT "1.0.0.0"
 #else
@@ -254,7 +255,7 @@ StartResult runOexServerd(const OexConfig &config,const String &progDir,const St
             std::cerr << "oexserverd" << exe << " not found " << std::endl;
             exit(1);
         }
-        for (auto it=config.environment.begin();it != oexconfig.environment.end();it++){
+        for (auto it=config.environment.begin();it != config.environment.end();it++){
             putenv(StringHelper::cloneData(StringHelper::format("%s=%s",it->first.c_str(),it->second.c_str())));
         }
         putenv(StringHelper::cloneData(StringHelper::format("%s=%d",ENV_AVNAV_PID,parent)));
@@ -295,52 +296,160 @@ StartResult runOexServerd(const OexConfig &config,const String &progDir,const St
     return rt;    
 }
 
-OexControl::Ptr OexControl::_instance;
-OexControl::OexControl(String progDir,String tempDir,StringVector additionalParameters)
-{
-    this->progDir = progDir;
-    this->tempDir = tempDir;
-    this->additionalParameters=additionalParameters;
-    lastDongleState=Timer::addMillis(Timer::steadyNow(),-QUERY_DONGLE_MS);
-}
-OexControl::~OexControl()
-{
-    if (GetState() == RUNNING)
-    {
-        Stop();
+/**
+ * the config for a particular instance
+ * all instances except the first one get a numbered socket address
+ */
+static OexConfig instanceConfig(const String &socketAddress){
+    OexConfig rt=oexconfig;
+    rt.socketAddress=socketAddress;
+    auto it=rt.environment.find(TEST_PIPE_ENV);
+    if (it != rt.environment.end()){
+        StringHelper::replaceInline(it->second,oexconfig.socketAddress,socketAddress);
     }
+    return rt;
 }
-OexControl::OexState OexControl::GetState() {
+
+/**
+ * a stream for an oexserverd request
+ * counts the outstanding requests of the server
+ */
+class OexControl::OexStream : public InputStream{
+    OexServer::Ptr server;
+    bool finished=false;
+    void finish(){
+        if (finished) return;
+        finished=true;
+        server->outstanding--;
+    }
+    public:
+    OexStream(int fd, OexServer::Ptr server):InputStream(fd,4096),server(server){}
+    virtual ~OexStream(){
+        finish();
+    }
+    virtual void close() override{
+        InputStream::close();
+        finish();
+    }
+};
+
+OexControl::OexServer::OexServer(int index,const String &socketAddress):
+    index(index),socketAddress(socketAddress){}
+
+OexControl::OexState OexControl::OexServer::GetState() {
     Synchronized l(mutex);
     return _state;
 }
-OexControl::OexState OexControl::GetRequestedState() {
+OexControl::OexState OexControl::OexServer::GetRequestedState() {
     Synchronized l(mutex);
     return _requestedState;
 }
-
-bool OexControl::SetState(OexControl::OexState state,String error) {
+bool OexControl::OexServer::SetState(OexControl::OexState state,String error) {
     Synchronized l(mutex);
     OexState oldState=_state;
     _state=state;
     lastError=error;
     return _state != oldState;
 }
-bool OexControl::SetRequestedState(OexControl::OexState state) {
+bool OexControl::OexServer::SetRequestedState(OexControl::OexState state) {
     Synchronized l(mutex);
     OexState oldState=_requestedState;
     _requestedState=state;
     return _requestedState != oldState;
 }
-OexControl::Supervisor::Supervisor(OexControl::Ptr control) : Thread(){
+String OexControl::OexServer::GetLastError(){
+    Synchronized l(mutex);
+    return lastError;
+}
+void OexControl::OexServer::addLog(const String &le){
+    Synchronized l(mutex);
+    if (oexLog.size() >= MAX_LOG) return;
+    oexLog.push_back(le);
+}
+void OexControl::OexServer::resetLog(){
+    Synchronized l(mutex);
+    oexLog.clear();
+}
+StringVector OexControl::OexServer::getLog(){
+    Synchronized l(mutex);
+    return oexLog;
+}
+void OexControl::OexServer::addLatency(int64_t micros){
+    Synchronized l(mutex);
+    latencySumMicros+=micros;
+    numLatencies++;
+    if (micros > latencyMaxMicros) latencyMaxMicros=micros;
+}
+static const std::map<OexControl::OexState,const char *> stateStrings={
+    {OexControl::UNKNOWN,"Down"},
+    {OexControl::ERROR,"Error"},
+    {OexControl::RUNNING,"Running"},
+    {OexControl::STARTING,"Starting"}
+};
+void OexControl::OexServer::ToJson(StatusStream &stream){
+    OexState state=GetState();
+    auto it=stateStrings.find(state);
+    stream["state"]=(it != stateStrings.end())?it->second:"Unknown";
+    stream["pid"]=(int)pid;
+    stream["outstanding"]=(int)outstanding;
+    stream["requests"]=(long)numRequests;
+    stream["errors"]=(long)numErrors;
+    stream["pingErrors"]=(long)numPingErrors;
+    int starts=numStarts;
+    stream["restarts"]=(starts > 0)?starts-1:0;
+    Synchronized l(mutex);
+    stream["latencyAvgMs"]=(numLatencies > 0)?(double)latencySumMicros/numLatencies/1000.0:0.0;
+    stream["latencyMaxMs"]=(double)latencyMaxMicros/1000.0;
+    if (state == ERROR){
+        stream["info"]=lastError;
+    }
+}
+
+OexControl::Ptr OexControl::_instance;
+OexControl::OexControl(String progDir,String tempDir,StringVector additionalParameters)
+{
+    this->progDir = progDir;
+    this->tempDir = tempDir;
+    this->additionalParameters=additionalParameters;
+    lastDongleState=Timer::addMillis(Timer::steadyNow(),-QUERY_DONGLE_MS);
+}
+OexControl::~OexControl()
+{
+    if (GetState() == RUNNING)
+    {
+        Stop();
+    }
+}
+OexControl::OexState OexControl::GetState() {
+    bool hasStarting=false;
+    bool hasError=false;
+    for (auto &&server:servers){
+        OexState state=server->GetState();
+        if (state == RUNNING) return RUNNING;
+        if (state == STARTING) hasStarting=true;
+        if (state == ERROR) hasError=true;
+    }
+    if (hasStarting) return STARTING;
+    if (hasError) return ERROR;
+    return UNKNOWN;
+}
+void OexControl::SetRequestedState(OexControl::OexState state) {
+    for (auto &&server:servers){
+        server->SetRequestedState(state);
+    }
+}
+OexControl::Supervisor::Supervisor(OexControl::Ptr control,OexServer::Ptr server) : Thread(){
     this->control=control;
+    this->server=server;
 }
 void OexControl::Kill(){
-    int spid=pid; //atomic
-    if (spid > 0){
-        LOG_INFOC("killing oexserver %d",spid);
-        kill(spid,SIGKILL);
-        kill(-spid,SIGKILL);
+    for (auto &&server:servers){
+        int spid=server->pid; //atomic
+        if (spid > 0){
+            LOG_INFOC("killing oexserver %d",spid);
+            kill(spid,SIGKILL);
+            kill(-spid,SIGKILL);
+        }
     }
 }
 void OexControl::StopServer(pid_t pid)
@@ -363,12 +472,13 @@ void OexControl::StopServer(pid_t pid)
         }
     }
 }
-bool OexControl::PingOex(long waitTime)
+bool OexControl::PingOex(OexServer::Ptr server, long waitTime)
 {
     InputStream::Ptr stream;
     try
     {
-        stream = DoSendOexCommand(CMD_TEST_AVAIL, "", "", waitTime, true);
+        server->outstanding++;
+        stream = DoSendOexCommand(server, CMD_TEST_AVAIL, "", "", waitTime);
     }
     catch (const OpenException &e)
     {
@@ -396,19 +506,11 @@ bool OexControl::PingOex(long waitTime)
     }
     return false;
 }
-void OexControl::addLog(const String &le){
-    Synchronized l(mutex);
-    if (oexLog.size() >= MAX_LOG) return;
-    oexLog.push_back(le);
-}
-void OexControl::resetLog(){
-    Synchronized l(mutex);
-    oexLog.clear();
-}
 void OexControl::writeLog(){
-    Synchronized l(mutex);
-    for (auto &&le:oexLog){
-        std::cout << le << std::endl;
+    for (auto &&server:servers){
+        for (auto &&le:server->getLog()){
+            std::cout << le << std::endl;
+        }
     }
 }
 void OexControl::Supervisor::run()
@@ -419,16 +521,16 @@ void OexControl::Supervisor::run()
         {RUNNING,500},
         {STARTING,100}
     };
-    LOG_DEBUG("oexserverd supervisor started");
+    LOG_DEBUG("oexserverd supervisor %d started",server->index);
     int pid = -1;
     Timer::SteadyTimePoint lastCheck=Timer::steadyNow();
     while (!this->shouldStop())
     {
-        OexState state = control->GetState();
+        OexState state = server->GetState();
         auto it=waitTimes.find(state);
         this->waitMillis((it != waitTimes.end())?it->second:500);
-        state = control->GetState();
-        OexState requested = control->GetRequestedState();
+        state = server->GetState();
+        OexState requested = server->GetRequestedState();
         if (requested != state)
         {
             // actions
@@ -436,24 +538,26 @@ void OexControl::Supervisor::run()
             {
             case RUNNING:
             {
-                LOG_INFO("oexserverd start requested");
-                control->resetLog();
-                StartResult res = runOexServerd(oexconfig, control->progDir, control->additionalParameters,true);
+                LOG_INFO("oexserverd %d start requested",server->index);
+                server->resetLog();
+                server->numStarts++;
+                StartResult res = runOexServerd(instanceConfig(server->socketAddress), control->progDir, control->additionalParameters,true);
                 if (res.hasError)
                 {
-                    control->SetState(ERROR,res.error);
+                    server->SetState(ERROR,res.error);
                     pid = -1;
-                    control->pid=pid;
+                    server->pid=pid;
                 }
                 else
                 {
-                    Thread reader([this, res]()
+                    OexServer::Ptr logServer=server;
+                    Thread reader([logServer, res]()
                                   { 
                                     int lc=0;
-                                    pipeReader(res.readFd, FMT("OEXSERVER:%d",res.pid), [this,&lc](const String &prefix, const char *text){
+                                    pipeReader(res.readFd, FMT("OEXSERVER:%d",res.pid), [logServer,&lc](const String &prefix, const char *text){
                                         logWrite(prefix,text);
                                         if (lc < MAX_LOG){
-                                            this->control->addLog(FMT("%s: %s",prefix,text));
+                                            logServer->addLog(FMT("%s: %s",prefix,text));
                                             lc++;
                                         }
                                     }); 
@@ -461,23 +565,23 @@ void OexControl::Supervisor::run()
                     reader.start();
                     reader.detach();
                     pid=res.pid;
-                    control->pid=pid;
-                    control->SetState(STARTING);
+                    server->pid=pid;
+                    server->SetState(STARTING);
                     Timer::SteadyTimePoint start=Timer::steadyNow();
                     bool connectSuccess=false;
                     while (! connectSuccess && ! Timer::steadyPassedMillis(start,10000)){
-                        connectSuccess=control->PingOex(3000);
+                        connectSuccess=control->PingOex(server,3000);
                         if (! connectSuccess) Timer::microSleep(500000);
                     }
                     if (! connectSuccess){
-                        control->SetState(ERROR,"unable to connect to oexserverd after start");
+                        server->SetState(ERROR,"unable to connect to oexserverd after start");
                         control->StopServer(pid);
                         pid=-1;
-                        control->pid=pid;
+                        server->pid=pid;
                     }
                     else{
-                        control->SetState(RUNNING);
-                        LOG_INFO("oexserverd %d successfully started and connected",pid);
+                        server->SetState(RUNNING);
+                        LOG_INFO("oexserverd %d (%d) successfully started and connected",server->index,pid);
                     }
                 }
             }
@@ -485,18 +589,18 @@ void OexControl::Supervisor::run()
             default:
                 if (state == RUNNING && pid > 0)
                 {
-                    LOG_INFO("stop oexserverd requested");
+                    LOG_INFO("stop oexserverd %d requested",server->index);
                     control->StopServer(pid);
                     pid = -1;
                 }
-                control->SetState(requested);
+                server->SetState(requested);
             }
         }
         if (pid > 0) {
-            if (control->GetState() == RUNNING){
+            if (server->GetState() == RUNNING){
             bool available = false;
             if (Timer::steadyPassedMillis(lastCheck, 2000)) {
-                available = control->PingOex(1000);
+                available = control->PingOex(server,1000);
                 lastCheck=Timer::steadyNow();
             } else {
                 Timer::SteadyTimePoint start = Timer::steadyNow();
@@ -510,16 +614,16 @@ void OexControl::Supervisor::run()
                 if (! available){
                     LOG_DEBUG("unable to kill -0 oexserver %d: %s", pid, SystemHelper::sysError());
                     //if kill did not succeed, we try to ping any way
-                    available=control->PingOex(1000);
+                    available=control->PingOex(server,1000);
                 }
             }
             int rt = waitpid(-pid, NULL, WNOHANG);
             if (!available) {
-                bool changed = control->SetState(ERROR, FMT("stopped unexpectedly, code=%d", rt));
+                bool changed = server->SetState(ERROR, FMT("stopped unexpectedly, code=%d", rt));
                 if (changed) {
-                    LOG_ERROR("oexserverd stopped unexpectedly, rt=%d", rt);
+                    LOG_ERROR("oexserverd %d stopped unexpectedly, rt=%d", server->index, rt);
                     pid = -1;
-                    control->pid=pid;
+                    server->pid=pid;
                 }
             }
             }
@@ -530,21 +634,20 @@ void OexControl::Supervisor::run()
 
         }
     }
-    LOG_DEBUG("oexserverd supervisor stopped");
+    LOG_DEBUG("oexserverd supervisor %d stopped",server->index);
 }
 
 void OexControl::Start() {
     SetRequestedState(RUNNING);
     Synchronized l(mutex);
-    if (supervisor){
+    for (auto &&supervisor:supervisors){
         supervisor->wakeUp();
     }
-    
 }
 void OexControl::Stop() {
     SetRequestedState(UNKNOWN);
     Synchronized l(mutex);
-    if (supervisor){
+    for (auto &&supervisor:supervisors){
         supervisor->wakeUp();
     }
 }
@@ -561,7 +664,7 @@ bool OexControl::WaitForState(OexControl::OexState state, long timeoutMillis){
     }
     return true;
 }
-void OexControl::Init(String progDir,String tempDir,StringVector additionalParameters)
+void OexControl::Init(String progDir,String tempDir,StringVector additionalParameters,int numInstances)
 {
     if (_instance.get() != NULL)
         _instance.reset();
@@ -574,25 +677,30 @@ void OexControl::Init(String progDir,String tempDir,StringVector additionalParam
             }
         }      
     }
+    if (numInstances < 1) numInstances=1;
     _instance = OexControl::Ptr(new OexControl(progDir,tempDir,additionalParameters));
-    _instance -> supervisor= new OexControl::Supervisor(_instance);
-    _instance -> supervisor->start();
+    for (int i=0;i<numInstances;i++){
+        String socketAddress=oexconfig.socketAddress;
+        if (i > 0) socketAddress+=FMT("-%d",i);
+        OexServer::Ptr server=std::make_shared<OexServer>(i,socketAddress);
+        _instance->servers.push_back(server);
+        Supervisor *supervisor=new OexControl::Supervisor(_instance,server);
+        _instance->supervisors.push_back(supervisor);
+        supervisor->start();
+    }
 }
 OexControl::Ptr OexControl::Instance()
 {
     return _instance;
 }
 String OexControl::GetLastError(){
-    Synchronized l(mutex);
-    return lastError;
+    for (auto &&server:servers){
+        String error=server->GetLastError();
+        if (! error.empty()) return error;
+    }
+    return String();
 }
 void OexControl::ToJson(StatusStream &stream){
-    static const std::map<OexState,const char *> stateStrings={
-        {UNKNOWN,"Down"},
-        {ERROR,"Error"},
-        {RUNNING,"Running"},
-        {STARTING,"Starting"}
-    };
     OexState state=GetState();
     auto it=stateStrings.find(state);
     stream["state"]=(it != stateStrings.end())?it->second:"Unknown";
@@ -600,19 +708,28 @@ void OexControl::ToJson(StatusStream &stream){
     if (state == ERROR){
         stream["info"]=GetLastError();
     }
+    if (servers.size() > 1){
+        json::JSON instances=json::Array();
+        for (auto &&server:servers){
+            json::JSON instance;
+            server->ToJson(instance);
+            instances.append(instance);
+        }
+        stream["instances"]=instances;
+    }
+    else if (servers.size() == 1){
+        servers[0]->ToJson(stream);
+    }
 }
 
-int OexControl::OpenConnection(long timeoutMillis, bool ignoreState) {
-    if ( !ignoreState && GetState() != RUNNING){
-        throw OpenException("oexserverd not running");
-    }
+int OexControl::OpenConnection(const String &socketAddress, long timeoutMillis) {
     struct sockaddr_un serv_addr;
     memset(&serv_addr, '0', sizeof(serv_addr));
-    if (oexconfig.socketAddress.size() >= (sizeof(serv_addr.sun_path) -1)){
-        throw OpenException(FMT("socket name %s too long",oexconfig.socketAddress.c_str()));
+    if (socketAddress.size() >= (sizeof(serv_addr.sun_path) -1)){
+        throw OpenException(FMT("socket name %s too long",socketAddress.c_str()));
     }
     serv_addr.sun_path[0] = '\0';  /* abstract namespace */
-    strcpy(serv_addr.sun_path+1, oexconfig.socketAddress.c_str());
+    strcpy(serv_addr.sun_path+1, socketAddress.c_str());
     int slen=offsetof(struct sockaddr_un, sun_path)+strlen(serv_addr.sun_path+1)+1;
     serv_addr.sun_family = AF_LOCAL;
     int sockFd=socket(AF_LOCAL, SOCK_STREAM, PF_UNIX);
@@ -650,11 +767,55 @@ int OexControl::OpenConnection(long timeoutMillis, bool ignoreState) {
     return sockFd;
 }
 
+/**
+ * try to increase the kernel buffer for the data coming from oexserverd
+ * so that it can continue decrypting while we are parsing
+ */
+static void setReceiveBuffer(int fd, int size){
+    if (fcntl(fd,F_SETPIPE_SZ,size) >= 0) return;
+    //not a pipe
+    if (setsockopt(fd,SOL_SOCKET,SO_RCVBUF,&size,sizeof(size)) < 0){
+        LOG_DEBUG("unable to set receive buffer size to %d: %s",size,SystemHelper::sysError());
+    }
+}
+OexControl::OexServer::Ptr OexControl::selectServer(){
+    Synchronized l(mutex);
+    OexServer::Ptr rt;
+    int best=0;
+    size_t num=servers.size();
+    for (size_t i=0;i<num;i++){
+        //rotate the start to distribute requests on equal load
+        OexServer::Ptr server=servers[(nextServer+i)%num];
+        if (server->GetState() != RUNNING) continue;
+        int outstanding=server->outstanding;
+        if (! rt || outstanding < best){
+            rt=server;
+            best=outstanding;
+        }
+    }
+    nextServer++;
+    if (rt) rt->outstanding++;
+    return rt;
+}
 InputStream::Ptr OexControl::SendOexCommand(OexCommands cmd,const String &fileName, const String &key, long waitTime){
-    return DoSendOexCommand(cmd,fileName,key,waitTime);
+    OexServer::Ptr server=selectServer();
+    if (! server){
+        throw OpenException("oexserverd not running");
+    }
+    server->numRequests++;
+    return DoSendOexCommand(server,cmd,fileName,key,waitTime);
 }
-InputStream::Ptr OexControl::DoSendOexCommand(OexCommands cmd,const String &fileName,
-     const String &key, long waitTime, bool ignoreState){
+/**
+ * the caller must already have counted the request as outstanding
+ */
+InputStream::Ptr OexControl::DoSendOexCommand(OexServer::Ptr server,OexCommands cmd,const String &fileName,
+     const String &key, long waitTime){
+    //pings are expected to fail while the server is starting
+    std::atomic<long> &errors=(cmd == CMD_TEST_AVAIL)?server->numPingErrors:server->numErrors;
+    avnav::VoidGuard guard([server,&errors](){
+        server->outstanding--;
+        errors++;
+    });
     LOG_DEBUG("send oex command %d for file %s",(int)cmd,fileName.c_str());
     if (fileName.size()>= (sizeof(OexMessage::senc_name)-1)){
         throw OpenException(FMT("fileName %s too long",fileName.c_str()));
@@ -663,7 +824,8 @@ InputStream::Ptr OexControl::DoSendOexCommand(OexCommands cmd,const String &file
         throw OpenException(FMT("key %s too long for %s",key.c_str(),fileName.c_str()));
     }
     Timer::SteadyTimePoint start=Timer::steadyNow();
-    int fd =OpenConnection(waitTime,ignoreState);
+    int fd =OpenConnection(server->socketAddress,waitTime);
+    setReceiveBuffer(fd,RECEIVE_BUFFER_SIZE);
     OexMessage msg;
     msg.cmd=cmd;
     strncpy(msg.senc_key,key.c_str(),sizeof(OexMessage::senc_key));
@@ -694,7 +856,7 @@ InputStream::Ptr OexControl::DoSendOexCommand(OexCommands cmd,const String &file
                 error = StringHelper::format("oexserver closed connection for %s", fileName.c_str());
                 break;
             }
-            ssize_t wr = ::write(fd, &msg + written, sizeof(OexMessage) - written);
+            ssize_t wr = ::write(fd, ((const char *)&msg) + written, sizeof(OexMessage) - written);
             if (wr < 0)
             {
                 if (errno != EAGAIN && errno != EWOULDBLOCK)
@@ -720,13 +882,16 @@ InputStream::Ptr OexControl::DoSendOexCommand(OexCommands cmd,const String &file
     }
     //the stream is in non blocking mode now, just create an inputStream
     LOG_DEBUG("opened oex stream for for %s",fileName.c_str());
-    InputStream::Ptr rt=std::make_shared<InputStream>(fd,4096);
+    InputStream::Ptr rt=std::make_shared<OexStream>(fd,server);
+    guard.disable(); //the stream will count down now
     bool check=rt->CheckRead(Timer::remainMillis(start,waitTime));
     if (! check){
+        errors++;
         String error=FMT("unable to read from oexserverd for %s",fileName);
         LOG_ERROR("%s",error);
         throw OpenException(error);
     }
+    server->addLatency(Timer::steadyDiffMicros(start));
     return rt;
 }
 
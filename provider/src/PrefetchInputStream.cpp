@@ -0,0 +1,146 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Prefetching input stream
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "PrefetchInputStream.h"
+#include "Timer.h"
+#include "Logger.h"
+#include <string.h>
+
+PrefetchInputStream::PrefetchInputStream(InputStream::Ptr source, size_t chunkSize, int numChunks):
+    InputStream(),source(source),chunkSize(chunkSize),cond(lock){
+    if (numChunks < 2) numChunks=2;
+    chunks.resize(numChunks);
+    for (auto &&chunk:chunks){
+        chunk.data=std::make_unique<char[]>(chunkSize);
+    }
+    reader=std::thread([this](){this->run();});
+}
+PrefetchInputStream::~PrefetchInputStream(){
+    close();
+}
+void PrefetchInputStream::run(){
+    while (true){
+        Chunk *chunk=nullptr;
+        {
+            Synchronized l(lock);
+            while (! stopped && numFilled >= chunks.size()){
+                cond.wait(l);
+            }
+            if (stopped) return;
+            chunk=&chunks[writeIdx];
+        }
+        Timer::SteadyTimePoint start=Timer::steadyNow();
+        ssize_t rd=source->read(chunk->data.get(),chunkSize,READ_WAIT_MILLIS);
+        transferMicros+=Timer::steadyDiffMicros(start);
+        Synchronized l(lock);
+        if (stopped) return;
+        if (rd > 0){
+            chunk->fill=rd;
+            chunk->pos=0;
+            writeIdx=(writeIdx+1) % chunks.size();
+            numFilled++;
+            cond.notifyAll(l);
+            continue;
+        }
+        if (rd < 0 || source->HasEof() || ! source->IsOpen()){
+            eof=true;
+            cond.notifyAll(l);
+            return;
+        }
+        //no data yet - just try again
+    }
+}
+ssize_t PrefetchInputStream::read(char *buffer,size_t maxSize, long waitMillis){
+    size_t rt=0;
+    Timer::SteadyTimePoint start=Timer::steadyNow();
+    Synchronized l(lock);
+    while (rt < maxSize){
+        if (numFilled == 0){
+            if (eof || stopped) break;
+            Timer::SteadyTimePoint waitStart=Timer::steadyNow();
+            if (waitMillis < 0){
+                cond.wait(l);
+            }
+            else{
+                //return what we have when the time is over
+                long remain=Timer::remainMillis(start,waitMillis);
+                if (remain <= 0) break;
+                cond.wait(l,remain);
+            }
+            waitMicros+=Timer::steadyDiffMicros(waitStart);
+            continue;
+        }
+        Chunk &chunk=chunks[readIdx];
+        size_t num=chunk.fill-chunk.pos;
+        if (num > (maxSize-rt)) num=maxSize-rt;
+        memcpy(buffer+rt,chunk.data.get()+chunk.pos,num);
+        chunk.pos+=num;
+        rt+=num;
+        if (chunk.pos >= chunk.fill){
+            readIdx=(readIdx+1) % chunks.size();
+            numFilled--;
+            cond.notifyAll(l);
+        }
+    }
+    bytesRead+=rt;
+    return rt;
+}
+void PrefetchInputStream::close(){
+    {
+        Synchronized l(lock);
+        stopped=true;
+        cond.notifyAll(l);
+    }
+    if (reader.joinable()) reader.join();
+    source->close();
+}
+size_t PrefetchInputStream::BytesRead(){
+    Synchronized l(lock);
+    return bytesRead;
+}
+bool PrefetchInputStream::IsOpen(){
+    Synchronized l(lock);
+    return ! stopped && (! eof || numFilled > 0);
+}
+bool PrefetchInputStream::HasEof(){
+    Synchronized l(lock);
+    return (eof || stopped) && numFilled == 0;
+}
+bool PrefetchInputStream::CheckRead(long waitMillis){
+    Timer::SteadyTimePoint start=Timer::steadyNow();
+    Synchronized l(lock);
+    while (numFilled == 0 && ! eof && ! stopped){
+        if (waitMillis < 0){
+            cond.wait(l);
+            continue;
+        }
+        long remain=Timer::remainMillis(start,waitMillis);
+        if (remain <= 0) break;
+        cond.wait(l,remain);
+    }
+    return numFilled > 0;
+}
@@ -212,6 +212,20 @@ void RenderHelper::renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContex
     const Coord::PixelXy &pstart, const Coord::PixelXy &pend, 
     const String &symbolName){
         if (symbolName.empty()) return;
+        renderSymbolLine(s52Data,ctx,pstart,pend,s52Data->getSymbolHandle(symbolName));
+    }
+void RenderHelper::renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContext &ctx,Coord::TileBox const &tile,
+    const Coord::WorldXy &start, const Coord::WorldXy &end, 
+    const s52::SymbolCache::Handle &symbol){
+        renderSymbolLine(s52Data,ctx,
+            tile.worldToPixel(start),
+            tile.worldToPixel(end),
+            symbol
+            );
+    }
+void RenderHelper::renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContext &ctx,
+    const Coord::PixelXy &pstart, const Coord::PixelXy &pend, 
+    const s52::SymbolCache::Handle &symbolHandle){
         Coord::Pixel dx=pend.x-pstart.x;
         Coord::Pixel dy=pend.y-pstart.y;
         int rotation=0;
@@ -220,7 +234,7 @@ void RenderHelper::renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContex
         //the rotation computed here has 0° when going east (dy==0,dx>0)
         //so to be inline with symbol rotations (0° == north up) we add 90°
         rotation+=90;
-        s52::SymbolPtr symbol=s52Data->getSymbol(symbolName,rotation);
+        s52::SymbolPtr symbol=s52Data->getSymbol(symbolHandle,rotation);
         if (! symbol) return;
         Coord::Pixel dw=symbol->width;
         Coord::Pixel dh=symbol->height;
@@ -242,24 +256,21 @@ void RenderHelper::renderSymbolLine(s52::S52Data::ConstPtr s52Data,DrawingContex
         }
     }
 
-DrawingContext::PatternSpec *RenderHelper::createPatternSpec(s52::SymbolPtr symbol, const Coord::TileBox &tile)
+DrawingContext::PatternSpec RenderHelper::createPatternSpec(const s52::SymbolData &symbol, const Coord::TileBox &tile)
     {
-        if (!symbol)
-            return nullptr;
-        DrawingContext::PatternSpec *pattern = new DrawingContext::PatternSpec(
-            symbol->buffer->data(),
-            symbol->width,
-            symbol->height);
-        pattern->distance = symbol->minDist;
-        pattern->stagger = symbol->stagger;
-        Coord::Pixel xraster = pattern->width + pattern->distance;
-        Coord::Pixel yraster = pattern->height + pattern->distance;
+        DrawingContext::PatternSpec pattern(nullptr);
+        DrawingContext::PatternTexture::ConstPtr texture=symbol.getPatternTexture();
+        if (! texture || texture->width <= 0 || texture->height <= 0)
+            return pattern;
+        pattern.texture=texture.get();
         //we need some absolute pixel values for the %
         //as our world coordinates are shifted we have to shift back
-        Coord::Pixel xoffset = Coord::worldToAbsPixel(tile.xmin,tile.zoom) % xraster;
-        Coord::Pixel yoffset = Coord::worldToAbsPixel(tile.ymin,tile.zoom) % yraster;
-        pattern->xoffset = xoffset;
-        pattern->yoffset = yoffset;
+        Coord::Pixel xoffset = Coord::worldToAbsPixel(tile.xmin,tile.zoom) % texture->width;
+        Coord::Pixel yoffset = Coord::worldToAbsPixel(tile.ymin,tile.zoom) % texture->height;
+        if (xoffset < 0) xoffset+=texture->width;
+        if (yoffset < 0) yoffset+=texture->height;
+        pattern.xoffset = xoffset;
+        pattern.yoffset = yoffset;
         return pattern;
     }
 
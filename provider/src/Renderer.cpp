@@ -30,6 +30,7 @@
 #include "PngHandler.h"
 #include "Logger.h"
 #include "Coordinates.h"
+#include "HitTestContext.h"
 
 class ChartIdx{
     public:
@@ -70,14 +71,14 @@ void Renderer::renderTile(const TileInfo &tile, const RenderInfo &info, RenderRe
     context.s52Data=chartManager->GetS52Data();
     RenderSettings::ConstPtr renderSettings=context.s52Data->getSettings();
     result.timer.add("settings");
-    ChartSet::ExtentList extents=chartManager->GetChartSetExtents(tile.chartSetKey,true);
-    if (extents.size() < 1){
+    ChartSet::ExtentList::ConstPtr extents=chartManager->GetChartSetExtents(tile.chartSetKey,true);
+    if (extents->size() < 1){
         throw RenderException(tile,"internal error: no chart set extent");
     }
     TileCache::CacheDescription cd;
     cd.settingsSequence=context.s52Data->getSequence();
-    cd.setHash=extents.setHash;
-    cd.setSequence=extents.setSequence;
+    cd.setHash=extents->setHash;
+    cd.setSequence=extents->setSequence;
     TileCache::Png tileFromCache=cache->getTile(cd,tile);
     if (tileFromCache){
         result.timer.add("cache");
@@ -86,11 +87,12 @@ void Renderer::renderTile(const TileInfo &tile, const RenderInfo &info, RenderRe
         return;
     }
     Coord::TileBox tileBox=Coord::tileToBox(tile);
-    WeightedChartList renderCharts = chartManager->FindChartsForTile(renderSettings, tile);
+    CoveragePlan::ConstPtr plan = chartManager->GetCoveragePlan(renderSettings, tile);
+    const WeightedChartList &renderCharts = plan->charts;
     result.timer.add("find");
     if (renderCharts.size() < 1)
     {
-        if (! tileBox.intersects(extents[0])){
+        if (! tileBox.intersects((*extents)[0])){
             throw NoChartsException(tile, "no charts to render");
         }
     }
@@ -174,7 +176,10 @@ void Renderer::renderTile(const TileInfo &tile, const RenderInfo &info, RenderRe
                 {
                     for (auto scaleChart = scaleCharts.begin(); scaleChart != scaleCharts.end(); scaleChart++)
                     {
-                        context.chartContext = chartContexts[scaleChart->idx];
+                        if (! scaleChart->chart->HasRenderPass(pass)) continue;
+                        const ChartRenderContext::Ptr &chartContext=chartContexts[scaleChart->idx];
+                        if (chartContext && ! chartContext->HasPass(pass)) continue;
+                        context.chartContext = chartContext;
                         if (pass == 0 || renderCharts[scaleChart->idx].kind != ChartInfoWithScale::KIND::SOFT){
                             //for "soft under" charts we only render areas
                             scaleChart->chart->Render(pass, context, *drawing,  renderCharts[scaleChart->idx].tile);
@@ -199,10 +204,9 @@ void Renderer::renderTile(const TileInfo &tile, const RenderInfo &info, RenderRe
     }
     result.timer.set(startRender,"render");
     chartContexts.clear(); //we must ensure to release all contexts before we release the charts
-    renderCharts.clear();
     DrawingContext::ColorAndAlpha boundingColor = context.s52Data->convertColor(context.s52Data->getColor("UINFG"));
     if (renderSettings->showChartBounds){
-        for (const auto &extent: extents){
+        for (const auto &extent: *extents){
             Coord::PixelBox pixelExtent=Coord::worldExtentToPixel(extent, tileBox);
             drawing->drawHLine(pixelExtent.ymin,pixelExtent.xmin,pixelExtent.xmax,boundingColor);
             drawing->drawHLine(pixelExtent.ymax,pixelExtent.xmin,pixelExtent.xmax,boundingColor);
@@ -243,8 +247,7 @@ ObjectList Renderer::featureInfo( const TileInfo &info, const Coord::TileBox &bo
     ZoomLevelScales scales(s52data->getSettings()->scale);
     context.scale = scales.GetScaleForZoom(info.zoom);
     context.s52Data=s52data;
-    std::unique_ptr<DrawingContext> drawing(DrawingContext::create(context.tileExtent.xmax,context.tileExtent.ymax));
-    drawing->setCheckOnly(true);
+    std::unique_ptr<DrawingContext> drawing(new HitTestContext(context.tileExtent.xmax,context.tileExtent.ymax));
     //for feature info we start with the smallest scale charts
     //they are at the end - so we iterate backwards
     for (auto it=renderCharts.rbegin();it != renderCharts.rend();it++){
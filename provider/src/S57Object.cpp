@@ -32,6 +32,8 @@
 #include "generated/S57ObjectClasses.h"
 #include "RenderHelper.h"
 #include "ObjectDescription.h"
+#include <array>
+#include <limits>
 S57BaseObject::S57BaseObject(ocalloc::PoolRef p,uint16_t id,uint16_t code,uint8_t prim)
     :featureId(id),
     featureTypeCode(code),
@@ -74,9 +76,10 @@ static s52::Arc parseArc(const s52::S52Data *s52data, const String& str){
 void S57Object::RenderObject::expandRule(const s52::S52Data *s52data,const s52::Rule *rule)
 {
     try{
+    //allocate from our pool, the object pool is shared by parallel prepares
     if (rule->type == s52::RUL_TXT_TE){
         const s52::StringTERule *sr=rule->cast<s52::StringTERule>();
-        s52::DisplayString str=s52::S52TextParser::parseTE(object->pool, s52data,rule->parameter.c_str(),sr->options,&(object->attributes));
+        s52::DisplayString str=s52::S52TextParser::parseTE(pool, s52data,rule->parameter.c_str(),sr->options,&(object->attributes));
         if (str.valid){
             expandedTexts.set(rule->key,str);
             pixelExtent.extend(str.relativeExtent);
@@ -84,7 +87,7 @@ void S57Object::RenderObject::expandRule(const s52::S52Data *s52data,const s52::
     }
     if (rule->type == s52::RUL_TXT_TX){
         const s52::StringTXRule *sr=rule->cast<s52::StringTXRule>();
-        s52::DisplayString str=s52::S52TextParser::parseTX(object->pool,s52data,rule->parameter.c_str(),sr->options,&(object->attributes));
+        s52::DisplayString str=s52::S52TextParser::parseTX(pool,s52data,rule->parameter.c_str(),sr->options,&(object->attributes));
         if (str.valid){
             expandedTexts.set(rule->key,str);
             pixelExtent.extend(str.relativeExtent);
@@ -142,6 +145,15 @@ void S57Object::RenderObject::expandRule(const s52::S52Data *s52data,const s52::
     }
 }
 
+//there is one command for each rule of each object
+static_assert(sizeof(S57Object::RenderObject::DrawCommand) <= 16,"draw command should be compact");
+
+class StepCompare{
+    public:
+    bool operator()(const S57Object::RenderObject::DrawCommand &c, uint8_t step) const{ return c.step < step;}
+    bool operator()(uint8_t step, const S57Object::RenderObject::DrawCommand &c) const{ return step < c.step;}
+};
+
 void S57Object::RenderObject::expand(const s52::S52Data *s52data, s52::RuleCreator *creator,const s52::RuleConditions *conditions){
     condRules.clear();
     pixelExtent.valid=false;
@@ -165,7 +177,20 @@ void S57Object::RenderObject::expand(const s52::S52Data *s52data, s52::RuleCreat
         
     }
 
-    //now build a map of rules by step
+    //now build a list of rules by step
+    ocalloc::Map<uint32_t,ARuleList> stepRules(pool);
+    auto addRuleToStep=[this,&stepRules](const s52::Rule *rule){
+        int step=rule->getRenderStep();
+        auto clist=stepRules.find(step);
+        if (clist == stepRules.end()){
+            ARuleList steplist(pool);
+            steplist.push_back(rule);
+            stepRules.set(step,steplist);
+        }
+        else{
+            clist->second.push_back(rule);
+        }
+    };
     for (auto && rule: lup->ruleList){
         if (rule->type == s52::RUL_CND_SY){
             auto syrules=condRules.find(rule->key);
@@ -182,132 +207,256 @@ void S57Object::RenderObject::expand(const s52::S52Data *s52data, s52::RuleCreat
     //we now have all the rules in our stepRules and we do not need the condRules
     //any more
     condRules.clear();
+    //compile the rules into draw commands
+    //stepRules is ordered by step - so the commands are ordered by step
+    commands.clear();
+    for (const auto &[step,rules]:stepRules){
+        for (const auto &rule:rules){
+            DrawCommand command;
+            if (! compileRule(s52data,rule,command)) continue;
+            command.step=step;
+            commands.push_back(command);
+        }
+    }
+    commands.shrink_to_fit();
 }
 
-void S57Object::RenderObject::RenderSingleRule(RenderContext &renderCtx, DrawingContext &ctx,  Coord::TileBox const &tile, const s52::Rule *rule) const
-{
-    auto renderSettings=renderCtx.s52Data->getSettings().get();
-    if (rule->type == s52::RUL_CND_SY)
-    {
+S57Object::RenderObject::CommandRange S57Object::RenderObject::GetCommands(s52::RenderStep step) const{
+    CommandRange rt;
+    auto range=std::equal_range(commands.begin(),commands.end(),(uint8_t)step,StepCompare());
+    if (range.first == range.second) return rt;
+    rt.first=&(*range.first);
+    rt.last=rt.first+(range.second-range.first);
+    return rt;
+}
 
-    }
-    if (rule->type == s52::RUL_ARE_CO || rule->type == s52::RUL_ARE_PA)
-    {
-        DrawingContext::ColorAndAlpha c=0;
-        std::unique_ptr<DrawingContext::PatternSpec> pattern;
-        if (rule->type == s52::RUL_ARE_CO){
+bool S57Object::RenderObject::compileRule(const s52::S52Data *s52data, const s52::Rule *rule, DrawCommand &command) const{
+    switch(rule->type){
+        case s52::RUL_ARE_CO:
+        {
             const s52::AreaRule *ar=rule->cast<s52::AreaRule>();
-            c = DrawingContext::convertColor(ar->color.R, ar->color.G, ar->color.B);
+            command.type=DrawCommand::C_AREA;
+            command.value=DrawingContext::convertColor(ar->color.R, ar->color.G, ar->color.B);
+            return true;
         }
-        else{
+        case s52::RUL_ARE_PA:
+        {
             const s52::SymAreaRule *ar=rule->cast<s52::SymAreaRule>();
-            if (ar->symbol){
-                pattern.reset(RenderHelper::createPatternSpec(ar->symbol,tile));
+            if (! ar->symbol) return false;
+            command.type=DrawCommand::C_AREA_PATTERN;
+            command.value=s52data->getCommandSymbolIndex(ar->symbol);
+            return command.value != s52::S52Data::NO_COMMAND_INDEX;
+        }
+        case s52::RUL_SYM_PT:
+        {
+            const s52::SymbolRule *sr = rule->cast<s52::SymbolRule>();
+            if (sr->finalName.empty()) return false;
+            double orient=0;
+            object->attributes.getDouble(S57AttrIds::ORIENT,orient);
+            s52::SymbolPtr symbol=s52data->getSymbol(sr->finalName,orient);
+            if (! symbol || ! symbol->buffer) return false;
+            command.type=DrawCommand::C_SYMBOL;
+            command.value=s52data->getCommandSymbolIndex(symbol);
+            return command.value != s52::S52Data::NO_COMMAND_INDEX;
+        }
+        case s52::RUL_TXT_TE:
+        case s52::RUL_TXT_TX:
+        {
+            auto it=expandedTexts.find(rule->key);
+            if (it == expandedTexts.end() || ! it->second.valid) return false;
+            int textGroup=0;
+            if (rule->type == s52::RUL_TXT_TE)
+            {
+                textGroup = rule->cast<s52::StringTERule>()->options.grp;
             }
-            else{
-                return;
+            else
+            {
+                textGroup = rule->cast<s52::StringTXRule>()->options.grp;
             }
+            //the text font only depends on the settings (see S52Data::getFontManager)
+            command.type=DrawCommand::C_TEXT;
+            command.param=std::max(0,std::min(textGroup,(int)UINT16_MAX));
+            command.value=rule->key;
+            return true;
         }
+        case s52::RUL_MUL_SG:
+        {
+            command.type=DrawCommand::C_SOUNDINGS;
+            return true;
+        }
+        case s52::RUL_SIN_SG:
+        {
+            command.type=DrawCommand::C_SOUNDING;
+            command.depth=::atof(rule->parameter.c_str());
+            return true;
+        }
+        case s52::RUL_ARC_2C:
+        {
+            auto it=arcs.find(rule->key);
+            if (it == arcs.end()) return false;
+            command.type=DrawCommand::C_ARC;
+            command.value=rule->key;
+            return true;
+        }
+        case s52::RUL_SIM_LN:
+        {
+            StringVector parts=StringHelper::split(rule->parameter.str(),",");
+            if (parts.size() < 3){
+                return false;
+            }
+            command.type=DrawCommand::C_LINE;
+            command.value = s52data->convertColor(s52data->getColor(parts[2]));
+            int width=atoi(parts[1].c_str()); 
+            command.param=std::max(1,std::min(width,(int)UINT16_MAX));
+            if (parts[0] == "DOTT"){
+                command.dash=DrawCommand::D_DOTT;
+            }
+            if (parts[0] == "DASH"){
+                command.dash=DrawCommand::D_DASH;
+            }
+            return true;
+        }
+        case s52::RUL_COM_LN:
+        {
+            const s52::SymbolLineRule *srule=rule->cast<s52::SymbolLineRule>();
+            if (srule->symbol.empty()) return false;
+            command.type=DrawCommand::C_SYMBOL_LINE;
+            command.value=s52data->getCommandSymbolHandleIndex(srule->symbol);
+            return command.value != s52::S52Data::NO_COMMAND_INDEX;
+        }
+        default:
+            return false;
+    }
+    return false;
+}
+
+void S57Object::RenderObject::RenderCommand(RenderContext &renderCtx, DrawingContext &ctx,  Coord::TileBox const &tile, const s52::S52Data *s52data, const DrawCommand &command) const
+{
+    switch(command.type){
+    case DrawCommand::C_AREA:
+    case DrawCommand::C_AREA_PATTERN:
+    {
+        DrawingContext::PatternSpec patternSpec(nullptr);
+        if (command.type == DrawCommand::C_AREA_PATTERN){
+            const s52::SymbolData *symbol=s52data->getCommandSymbol(command.value);
+            if (symbol) patternSpec=RenderHelper::createPatternSpec(*symbol,tile);
+        }
+        const DrawingContext::PatternSpec *pattern=patternSpec.texture?&patternSpec:nullptr;
+        DrawingContext::ColorAndAlpha c=command.value;
         // AREA
-        for (auto vlit = object->area.begin(); vlit != object->area.end(); vlit++)
+        if (! object->geometry) return;
+        int level=GeometryLod::levelForZoom(tile.zoom);
+        //all triangles of the area are collected and filled in one pass
+        DrawingContext::EdgeTable &edges=ctx.getEdgeTable();
+        Coord::Pixel w=ctx.getWidth();
+        Coord::Pixel h=ctx.getHeight();
+        //returns true if the triangle covers the complete context
+        auto addTriangle=[&edges,&ctx,w,h](const Coord::PixelXy *pp3){
+            ctx.numTriangles++;
+            if (ctx.coversAll(pp3[0], pp3[1], pp3[2])) return true;
+            if ((pp3[0].x < 0 && pp3[1].x < 0 && pp3[2].x < 0) ||
+                (pp3[0].x >= w && pp3[1].x >= w && pp3[2].x >= w) ||
+                (pp3[0].y < 0 && pp3[1].y < 0 && pp3[2].y < 0) ||
+                (pp3[0].y >= h && pp3[1].y >= h && pp3[2].y >= h)){
+                ctx.triUnhitCount++;
+                return false;
+            }
+            ctx.triHitCount++;
+            edges.addTriangle(pp3[0], pp3[1], pp3[2]);
+            return false;
+        };
+        for (const auto &vit : object->area)
         {
-            auto vit=*vlit;
-            /*
-            if (!extent.intersects(vit->extent))
-                continue;
-                */
-            uint8_t tc = vit->type;
-            Coord::WorldXy pp3[3]; // triangle corners
-            int inc = 1;
-            int max = vit->numAreaPoints;
+            if (vit.extent.valid){
+                //the lod triangles are snapped, so allow for one pixel
+                Coord::PixelBox listExtent=Coord::worldExtentToPixel(vit.extent,tile);
+                if (listExtent.xmax < -1 || listExtent.xmin > ctx.getWidth() ||
+                    listExtent.ymax < -1 || listExtent.ymin > ctx.getHeight()){
+                    ctx.listSkipCount++;
+                    continue;
+                }
+            }
+            //the points can only be read in sequence
+            //so we keep the (already transformed) corners of the last triangle
+            uint8_t tc = vit.type;
+            uint32_t numPoints=vit.numAreaPoints;
+            uint32_t offset=vit.offset;
+            if (level >= 0 && vit.lodNumPoints[level] != VertexList::NO_LOD){
+                tc=4;
+                numPoints=vit.lodNumPoints[level];
+                offset=vit.lodOffset[level];
+            }
+            if (numPoints < 3) continue;
+            CompactGeometry::Reader reader(*(object->geometry), offset);
+            Coord::PixelXy pp3[3]; // triangle corners
             switch (tc)
             {
             case 6: // PTG_TRIANGLE_FAN
-                max = vit->numAreaPoints - 2;
-                break;
             case 5: // PTG_TRIANGLE_STRIP
-                max = vit->numAreaPoints - 2;
+                pp3[0] = tile.worldToPixel(reader.next());
+                pp3[1] = tile.worldToPixel(reader.next());
+                for (uint32_t it = 2; it < numPoints; it++)
+                {
+                    pp3[2] = tile.worldToPixel(reader.next());
+                    if (addTriangle(pp3)){
+                        //the triangles of an area do not overlap
+                        ctx.fillAll(c, pattern);
+                        return;
+                    }
+                    if (tc == 5)
+                    {
+                        pp3[0] = pp3[1];
+                    }
+                    pp3[1] = pp3[2];
+                }
                 break;
             case 4: // PTG_TRIANGLES
-                inc = 3;
-                break;
-            default:
-                max = 0; // ignore
-                break;
-            }
-            for (int it = 0; it < max; it += inc)
-            {
-                switch (tc)
+                for (uint32_t it = 0; (it + 2) < numPoints; it += 3)
                 {
-                case 6: // PTG_TRIANGLE_FAN
-                    pp3[0].x = vit->points[0].x;
-                    pp3[0].y = vit->points[0].y;
-                    pp3[1].x = vit->points[it + 1].x;
-                    pp3[1].y = vit->points[it + 1].y;
-                    pp3[2].x = vit->points[it + 2].x;
-                    pp3[2].y = vit->points[it + 2].y;
-                    break;
-                case 5: // PTG_TRIANGLE_STRIP
-                    pp3[0].x = vit->points[it].x;
-                    pp3[0].y = vit->points[it].y;
-                    pp3[1].x = vit->points[it + 1].x;
-                    pp3[1].y = vit->points[it + 1].y;
-                    pp3[2].x = vit->points[it + 2].x;
-                    pp3[2].y = vit->points[it + 2].y;
-                    break;
-                case 4: // PTG_TRIANGLES
-                    pp3[0].x = vit->points[it].x;
-                    pp3[0].y = vit->points[it].y;
-                    pp3[1].x = vit->points[it + 1].x;
-                    pp3[1].y = vit->points[it + 1].y;
-                    pp3[2].x = vit->points[it + 2].x;
-                    pp3[2].y = vit->points[it + 2].y;
-                    break;
+                    pp3[0] = tile.worldToPixel(reader.next());
+                    pp3[1] = tile.worldToPixel(reader.next());
+                    pp3[2] = tile.worldToPixel(reader.next());
+                    if (addTriangle(pp3)){
+                        //the triangles of an area do not overlap
+                        ctx.fillAll(c, pattern);
+                        return;
+                    }
                 }
-                ctx.drawTriangle(
-                    tile.worldToPixel(pp3[0]),
-                    tile.worldToPixel(pp3[1]),
-                    tile.worldToPixel(pp3[2]),
-                    c,
-                    pattern.get());
+                break;
+            default:
+                break; // ignore
             }
         }
+        ctx.drawPolygon(edges, c, pattern);
         return;
     }
-    if (rule->type == s52::RUL_SYM_PT)
+    case DrawCommand::C_SYMBOL:
     {
-        const s52::SymbolRule *sr = rule->cast<s52::SymbolRule>();
-        if (!sr->finalName.empty())
-        {
-            double orient=0;
-            object->attributes.getDouble(S57AttrIds::ORIENT,orient);
-            s52::SymbolPtr symbol = renderCtx.s52Data->getSymbol(sr->finalName,orient);
-            if (symbol && symbol->buffer)
-            {
-                Coord::PixelXy pp = tile.worldToPixel(object->point);
-                pp.x -= symbol->pivot_x;
-                pp.y -= symbol->pivot_y;
-                //avoid drawing a symbol if it would be outside the area box if this
-                //is an area object
-                if (object->geoPrimitive == s52::GEO_AREA){
-                    Coord::PixelBox symbolExt=symbol->relativeExtent.getShifted(pp);
-                    Coord::PixelBox areaExtend=Coord::worldExtentToPixel(object->extent,tile);
-                    if (!areaExtend.includes(symbolExt)) {
-                        return;    
-                    }
-                }
-                ctx.drawSymbol(pp, symbol->width, symbol->height, symbol->buffer->data());
+        const s52::SymbolData *symbol=s52data->getCommandSymbol(command.value);
+        if (! symbol) return;
+        Coord::PixelXy pp = tile.worldToPixel(object->point);
+        pp.x -= symbol->pivot_x;
+        pp.y -= symbol->pivot_y;
+        //avoid drawing a symbol if it would be outside the area box if this
+        //is an area object
+        if (object->geoPrimitive == s52::GEO_AREA){
+            Coord::PixelBox symbolExt=symbol->relativeExtent.getShifted(pp);
+            Coord::PixelBox areaExtend=Coord::worldExtentToPixel(object->extent,tile);
+            if (!areaExtend.includes(symbolExt)) {
+                return;    
             }
         }
+        ctx.drawSymbol(pp, symbol->width, symbol->height, symbol->buffer->data());
         return;
     }
-    if (rule->type == s52::RUL_TXT_TE || rule->type == s52::RUL_TXT_TX){
-        auto it=expandedTexts.find(rule->key);
-        if (it == expandedTexts.end() || ! it->second.valid){
-            return;
-        }
+    case DrawCommand::C_TEXT:
+    {
+        auto textIt=expandedTexts.find(command.value);
+        if (textIt == expandedTexts.end()) return;
+        const s52::DisplayString &text=textIt->second;
+        auto renderSettings=renderCtx.s52Data->getSettings().get();
         Coord::PixelXy pp=tile.worldToPixel(object->point);
-        Coord::PixelBox ourExtent=it->second.relativeExtent.getShifted(pp);
+        Coord::PixelBox ourExtent=text.relativeExtent.getShifted(pp);
         if (renderSettings->bDeClutterText){
             //declutter
             for (auto di=renderCtx.textBoxes.begin();di != renderCtx.textBoxes.end();di++){
@@ -330,97 +479,78 @@ void S57Object::RenderObject::RenderSingleRule(RenderContext &renderCtx, Drawing
                 if (! renderSettings->bShowAtonText) return;
             }
         }
-
-        int group = 0;
-        int fontSize=16;
-        if (rule->type == s52::RUL_TXT_TE)
-        {
-            group = rule->cast<s52::StringTERule>()->options.grp;
-            fontSize=rule->cast<s52::StringTERule>()->options.fontSize;
-        }
-        else
-        {
-            group = rule->cast<s52::StringTXRule>()->options.grp;
-            fontSize=rule->cast<s52::StringTXRule>()->options.fontSize;
-        }
         if (renderSettings->bShowS57ImportantTextOnly)
         {
-            if (group < 20) return;
+            if (command.param < 20) return;
         }
-        FontManager::Ptr fm=renderCtx.s52Data->getFontManager(s52::S52Data::FONT_TXT,fontSize);
-        Coord::PixelBox te=RenderHelper::drawText(fm,ctx,it->second,pp);
+        Coord::PixelBox te=RenderHelper::drawText(s52data->getCommandFont(s52::S52Data::FONT_TXT),ctx,text,pp);
         renderCtx.textBoxes.push_back(te);
         return;
     }
-    if (rule->type == s52::RUL_MUL_SG){
-        RenderHelper::renderSounding(renderCtx.s52Data,ctx,tile, &(object->soundigs));
+    case DrawCommand::C_SOUNDINGS:
+        RenderHelper::renderSounding(renderCtx.s52Data,s52data->getSoundingStyle(),ctx,tile, &(object->soundigs));
         return;
-    }
-    if (rule->type == s52::RUL_SIN_SG){
+    case DrawCommand::C_SOUNDING:
+    {
         S57Object::Sounding sndg(object->point);
-        sndg.depth=::atof(rule->parameter.c_str());
-        std::vector<S57Object::Sounding> lst;
-        lst.push_back(sndg);
-        RenderHelper::renderSounding(renderCtx.s52Data,ctx,tile,&lst);
+        sndg.depth=command.depth;
+        std::array<S57Object::Sounding,1> lst={sndg};
+        RenderHelper::renderSounding(renderCtx.s52Data,s52data->getSoundingStyle(),ctx,tile,&lst);
         return;
     }
-    if (rule->type == s52::RUL_ARC_2C){
-        auto it=arcs.find(rule->key);
-        if (it != arcs.end()){
-            RenderHelper::renderArc(renderCtx.s52Data,ctx,it->second,tile.worldToPixel(object->point));
-        }
+    case DrawCommand::C_ARC:
+    {
+        auto arcIt=arcs.find(command.value);
+        if (arcIt == arcs.end()) return;
+        RenderHelper::renderArc(renderCtx.s52Data,ctx,arcIt->second,tile.worldToPixel(object->point));
+        return;
     }
-    if (rule->type == s52::RUL_SIM_LN){
-        StringVector parts=StringHelper::split(rule->parameter.str(),",");
-        if (parts.size() < 3){
-            return;
-        }
-        DrawingContext::ColorAndAlpha color = renderCtx.s52Data->convertColor(
-            renderCtx.s52Data->getColor(parts[2]));
-        int width=atoi(parts[1].c_str()); 
-        if (width < 1) width=1;
+    case DrawCommand::C_LINE:
+    {
+        DrawingContext::ColorAndAlpha color=command.value;
+        int width=command.param;
         DrawingContext::Dash dash;
         DrawingContext::Dash *dashPtr=nullptr;
-        if (parts[0] == "DOTT"){
-            dashPtr=&dash;
+        if (command.dash == DrawCommand::D_DOTT){
             dash.draw=width;
             dash.gap=width;
-        }
-        if (parts[0] == "DASH"){
             dashPtr=&dash;
+        }
+        if (command.dash == DrawCommand::D_DASH){
             dash.draw=3*width;
             dash.gap=width;
+            dashPtr=&dash;
         }
-        
+        int level=GeometryLod::levelForZoom(tile.zoom);
         for (const auto &it:object->polygons){
-            it.iterateSegments([&ctx,&tile,color,width,&dashPtr](Coord::WorldXy start, Coord::WorldXy end, bool isFirst){
+            it.iterateSegments([&ctx,&tile,color,width,dashPtr](Coord::WorldXy start, Coord::WorldXy end, bool isFirst){
                 RenderHelper::renderLine(ctx,tile,color,start,end,width,dashPtr);  
-            });
+            },false,level);
         } 
         return;
-        
     }
-    if (rule->type == s52::RUL_COM_LN){
-        //return;
-        const s52::SymbolLineRule *srule=rule->cast<s52::SymbolLineRule>();
+    case DrawCommand::C_SYMBOL_LINE:
+    {
+        const s52::SymbolCache::Handle *handlePtr=s52data->getCommandSymbolHandle(command.value);
+        if (! handlePtr) return;
+        const s52::SymbolCache::Handle &handle=*handlePtr;
+        int level=GeometryLod::levelForZoom(tile.zoom);
         for (const auto &it:object->polygons){
-            if (it.winding == S57Object::Polygon::WD_UN){
-                int debug=1;
-            }
-            it.iterateSegments([&renderCtx,&ctx,&tile,&srule](Coord::WorldXy start, Coord::WorldXy end, bool isFirst){
-                RenderHelper::renderSymbolLine(renderCtx.s52Data, ctx, tile, start, end, srule->symbol);
-            },it.winding == S57Object::Polygon::WD_CW);            
+            it.iterateSegments([&renderCtx,&ctx,&tile,&handle](Coord::WorldXy start, Coord::WorldXy end, bool isFirst){
+                RenderHelper::renderSymbolLine(renderCtx.s52Data, ctx, tile, start, end, handle);
+            },it.winding == S57Object::Polygon::WD_CW,level);            
         } 
-        
+        return;
+    }
+    default:
+        return;
     }
 }
-void S57Object::RenderObject::Render(RenderContext &renderCtx, DrawingContext &ctx, Coord::TileBox const &tile,const s52::RenderStep &step) const
+void S57Object::RenderObject::Render(RenderContext &renderCtx, DrawingContext &ctx, Coord::TileBox const &tile,const s52::S52Data *s52data,const s52::RenderStep &step) const
 {
     if (! shouldRenderScale(renderCtx.s52Data->getSettings().get(),renderCtx.scale)) return;
-    auto &&stepList=stepRules.find(step);
-    if (stepList == stepRules.end()) return;
-    for (auto && rule: stepList->second){
-        RenderSingleRule(renderCtx,ctx,tile,rule);
+    for (const auto &command: GetCommands(step)){
+        RenderCommand(renderCtx,ctx,tile,s52data,command);
     }              
 }
 
@@ -463,36 +593,52 @@ bool S57Object::RenderObject::Intersects(const Coord::PixelBox &pixelBox,Coord::
     }
     return false;
 }
+Coord::Extent S57Object::RenderObject::GetIndexExtent() const{
+    Coord::Extent rt;
+    if (object->extent.valid) rt.extend(object->extent);
+    if (object->geoPrimitive == s52::GEO_AREA || object->geoPrimitive == s52::GEO_POINT){
+        rt.extend(object->point);
+    }
+    return rt;
+}
+int S57Object::RenderObject::GetPixelMargin() const{
+    int rt=std::max(xmargin,ymargin);
+    if (pixelExtent.Valid()){
+        rt=std::max(rt,std::max(std::abs(pixelExtent.xmin),std::abs(pixelExtent.xmax)));
+        rt=std::max(rt,std::max(std::abs(pixelExtent.ymin),std::abs(pixelExtent.ymax)));
+    }
+    return rt;
+}
 S57Object::RenderObject::RenderObject(ocalloc::PoolRef p,S57Object::ConstPtr o)
     :object(o),
     expandedTexts(p),
     arcs(p),
     condRules(p),
     pool(p),
-    stepRules(p)
+    commands(p)
     {
 };
 
 Coord::WorldXy S57Object::LineIndex::firstPoint() const{
     if (startSegment.valid) return startSegment.start;
-    if (edgeNodes && edgeNodes->size() > 0) {
-        if (forward) return edgeNodes->at(0);
-        return edgeNodes->at(edgeNodes->size()-1);
+    if (numEdgeNodes > 0) {
+        if (forward) return edgeNodes[0];
+        return edgeNodes[numEdgeNodes-1];
     }
     if (endSegment.valid) return endSegment.start;
     return Coord::WorldXy();
 }
 Coord::WorldXy S57Object::LineIndex::lastPoint() const{
     if (endSegment.valid) return endSegment.end;
-    if (edgeNodes && edgeNodes->size() > 0){
-        if (forward) return edgeNodes->at(edgeNodes->size()-1);
-        return edgeNodes->at(0);
+    if (numEdgeNodes > 0){
+        if (forward) return edgeNodes[numEdgeNodes-1];
+        return edgeNodes[0];
     }
     if (startSegment.valid) return startSegment.end;
     return Coord::WorldXy();
 }
 
-void S57Object::LineIndex::iterateSegments(S57Object::LineIndex::SegmentIterator it, bool backward) const
+void S57Object::LineIndex::iterateSegments(S57Object::LineIndex::SegmentIterator it, bool backward, int level) const
 {
     /**
      * if we iterate backwards we start from the end point of the end segment
@@ -519,15 +665,20 @@ void S57Object::LineIndex::iterateSegments(S57Object::LineIndex::SegmentIterator
         isFirst = false;
     }
     bool iterateBackwards = (forward == backward);
-
-    if (edgeNodes != nullptr && edgeNodes->size() > 0)
+    const Coord::WorldXy *edgeNodes=this->edgeNodes;
+    uint32_t numEdgeNodes=this->numEdgeNodes;
+    if (level >= 0 && level < GeometryLod::NUM_LEVELS && lod[level].nodes){
+        edgeNodes=lod[level].nodes;
+        numEdgeNodes=lod[level].num;
+    }
+    if (numEdgeNodes > 0)
     {
         if (iterateBackwards)
         {
-            Coord::WorldXy current = edgeNodes->at(edgeNodes->size() - 1);
-            for (int i = edgeNodes->size() - 2; i >= 0; i--)
+            Coord::WorldXy current = edgeNodes[numEdgeNodes - 1];
+            for (int i = (int)numEdgeNodes - 2; i >= 0; i--)
             {
-                Coord::WorldXy next = edgeNodes->at(i);
+                Coord::WorldXy next = edgeNodes[i];
                 it(current, next, isFirst);
                 isFirst = false;
                 current = next;
@@ -535,10 +686,10 @@ void S57Object::LineIndex::iterateSegments(S57Object::LineIndex::SegmentIterator
         }
         else
         {
-            Coord::WorldXy current = edgeNodes->at(0);
-            for (int i = 1; i < edgeNodes->size(); i++)
+            Coord::WorldXy current = edgeNodes[0];
+            for (uint32_t i = 1; i < numEdgeNodes; i++)
             {
-                Coord::WorldXy next = edgeNodes->at(i);
+                Coord::WorldXy next = edgeNodes[i];
                 it(current, next, isFirst);
                 isFirst = false;
                 current = next;
@@ -551,22 +702,20 @@ void S57Object::LineIndex::iterateSegments(S57Object::LineIndex::SegmentIterator
     }
 }
 
-void S57Object::Polygon::iterateSegments(LineIndex::SegmentIterator i,bool backwards) const{
+void S57Object::Polygon::iterateSegments(LineIndex::SegmentIterator i,bool backwards, int level) const{
     //TODO: decide on adding a missing last segement if not complete
     if (! obj) return;
     if (backwards){
         for (int idx=endIndex;idx>=startIndex;idx--){
             if (idx >= 0 && idx < obj->lines.size()){
-                auto line=obj->lines[idx];
-                line.iterateSegments(i,backwards);
+                obj->lines[idx].iterateSegments(i,backwards,level);
             }
         }
     }
     else{
         for (int idx=startIndex;idx<=endIndex;idx++){
             if (idx >= 0 && idx < obj->lines.size()){
-                auto line=obj->lines[idx];
-                line.iterateSegments(i,backwards);
+                obj->lines[idx].iterateSegments(i,backwards,level);
             }
         }
     }
@@ -657,13 +806,16 @@ bool S57Object::RenderObject::shouldRenderCat(const RenderSettings *rs) const{
 }
 
 bool S57Object::RenderObject::shouldRenderScale(const RenderSettings *rs,int scale) const{
-    if (! rs->bUseSCAMIN) return true;
+    return scale <= GetMaxScale(rs);
+}
+int S57Object::RenderObject::GetMaxScale(const RenderSettings *rs) const{
+    if (! rs->bUseSCAMIN) return std::numeric_limits<int>::max();
     if( ( s52::DisCat::DISPLAYBASE == getDisplayCat()) || ( s52::DisPrio::PRIO_GROUP1 == lup->DPRI )) {
-        return true;
+        return std::numeric_limits<int>::max();
     }
-    if (object->scamin > 0 && scale > object->scamin) return false;
+    if (object->scamin > 0) return object->scamin;
     //TODO: special handling for "$TEXTS" ???
-    return true;
+    return std::numeric_limits<int>::max();
 }
 class S57ObjectDescription : public ObjectDescription
 {
@@ -970,6 +1122,7 @@ ObjectDescription::Ptr S57Object::RenderObject::getObjectDescription(
     RenderContext &context,
     DrawingContext &drawing,
     const Coord::TileBox &box,
+    const s52::S52Data *s52data,
     bool overview,
     S57Object::RenderObject::StringTranslator translator) const{
     if (!Intersects(context.tileExtent,box)) return ObjectDescription::Ptr();
@@ -1020,7 +1173,7 @@ ObjectDescription::Ptr S57Object::RenderObject::getObjectDescription(
                    s52::RenderStep::RS_POINTS});
         for (auto step : steps)
         {
-            Render(context, drawing, box, step);
+            Render(context, drawing, box, s52data, step);
             if (drawing.getDrawn())
                 break;
         }
@@ -0,0 +1,658 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Vectorized span kernels
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include "SpanKernels.h"
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+    #define SPAN_X86
+    #include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SPAN_NEON
+    #include <arm_neon.h>
+#endif
+
+SpanKernels::ColorAndAlpha SpanKernels::blendImpl(ColorAndAlpha dst, ColorAndAlpha src){
+    // A over B (A: src, B: dst)
+        // https://de.wikipedia.org/wiki/Alpha_Blending
+        // https://stackoverflow.com/questions/1102692/how-to-alpha-blend-rgba-unsigned-byte-color-fast
+        // https://arxiv.org/pdf/2202.02864.pdf
+        ColorAndAlpha aA = (src & 0xFF000000) >> 24;
+        if (aA == 255 ) return src;
+        ColorAndAlpha aB = (dst & 0xFF000000) >> 24;
+        if (aB == 0)
+            return src;
+        if (aA == 0) return dst;
+        ColorAndAlpha bF=(((255-aA)*aB) + (1<<7)) >> 8;
+        ColorAndAlpha anew = aA+bF;
+        ColorAndAlpha f=factors[anew];
+        const int shifts[3]={0,8,16};
+        ColorAndAlpha rt= (anew << 24);
+        for (int i=0;i<3;i++){
+            ColorAndAlpha c=((src >> shifts[i]) &0xff)*f*aA;
+            c+=((dst >> shifts[i])&0xff)*f*bF;
+            c+=1<<15; //+0.5 for better rounding
+            c=c>>16;
+            if (c > 255){
+                c=255;
+            }
+            rt|=c << shifts[i];
+        }
+        return rt;
+}
+
+namespace scalar{
+    using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+    static void fill(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        for (int i=0;i<num;i++){
+            dst[i]=color;
+        }
+    }
+    static void blendColor(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        for (int i=0;i<num;i++){
+            dst[i]=SpanKernels::blendPixel(dst[i],color);
+        }
+    }
+    static void blend(ColorAndAlpha *dst, const ColorAndAlpha *src, int num){
+        for (int i=0;i<num;i++){
+            dst[i]=SpanKernels::blendPixel(dst[i],src[i]);
+        }
+    }
+    static void glyph(ColorAndAlpha *dst, const uint8_t *src, int num, ColorAndAlpha color){
+        ColorAndAlpha rgb=color & 0xffffff;
+        for (int i=0;i<num;i++){
+            dst[i]=SpanKernels::blendPixel(dst[i],rgb | (((ColorAndAlpha)src[i]) << 24));
+        }
+    }
+    static const SpanKernels::Kernels kernels={"scalar",fill,blendColor,blend,glyph};
+}
+
+/*
+ * the vector versions compute the general case of blendImpl for all lanes
+ * and afterwards select the results of the special cases:
+ *   src == 0           -> dst
+ *   aA == 255, aB == 0 -> src
+ *   aA == 0            -> dst
+ * all intermediate values are below 2^24
+ * f*aA and f*bF are at most 65280
+ */
+#if defined(SPAN_X86) && defined(__SSE2__)
+namespace sse2{
+    using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+    //32 bit lanes of a,b < 2^16 with a*b < 2^16
+    static inline __m128i mul16(__m128i a, __m128i b){
+        return _mm_mullo_epi16(a,b);
+    }
+    //32 bit lanes of a < 2^8, b < 2^16
+    static inline __m128i mul24(__m128i a, __m128i b){
+        return _mm_or_si128(_mm_mullo_epi16(a,b),_mm_slli_epi32(_mm_mulhi_epu16(a,b),16));
+    }
+    static inline __m128i select(__m128i mask, __m128i a, __m128i b){
+        return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b));
+    }
+    static inline __m128i blend4(__m128i d, __m128i s){
+        const __m128i m8=_mm_set1_epi32(0xff);
+        const __m128i zero=_mm_setzero_si128();
+        __m128i aA=_mm_srli_epi32(s,24);
+        __m128i aB=_mm_srli_epi32(d,24);
+        __m128i bF=_mm_srli_epi32(_mm_add_epi32(mul16(_mm_sub_epi32(m8,aA),aB),_mm_set1_epi32(1<<7)),8);
+        __m128i anew=_mm_add_epi32(aA,bF);
+        alignas(16) uint32_t idx[4];
+        _mm_store_si128((__m128i*)idx,anew);
+        __m128i f=_mm_set_epi32(SpanKernels::factors[idx[3]],SpanKernels::factors[idx[2]],
+            SpanKernels::factors[idx[1]],SpanKernels::factors[idx[0]]);
+        __m128i wA=mul16(f,aA);
+        __m128i wB=mul16(f,bF);
+        __m128i rt=_mm_slli_epi32(anew,24);
+        for (int shift=0;shift<24;shift+=8){
+            __m128i sc=_mm_and_si128(_mm_srli_epi32(s,shift),m8);
+            __m128i dc=_mm_and_si128(_mm_srli_epi32(d,shift),m8);
+            __m128i c=_mm_add_epi32(_mm_add_epi32(mul24(sc,wA),mul24(dc,wB)),_mm_set1_epi32(1<<15));
+            c=_mm_srli_epi32(c,16);
+            c=select(_mm_cmpgt_epi32(c,m8),m8,c);
+            rt=_mm_or_si128(rt,_mm_slli_epi32(c,shift));
+        }
+        rt=select(_mm_cmpeq_epi32(aA,zero),d,rt);
+        rt=select(_mm_or_si128(_mm_cmpeq_epi32(aA,m8),_mm_cmpeq_epi32(aB,zero)),s,rt);
+        rt=select(_mm_cmpeq_epi32(s,zero),d,rt);
+        return rt;
+    }
+    static void fill(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        __m128i c=_mm_set1_epi32(color);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            _mm_storeu_si128((__m128i*)(dst+i),c);
+        }
+        for (;i<num;i++) dst[i]=color;
+    }
+    static void blendColor(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        if (color == 0) return;
+        if ((color & 0xff000000) == 0xff000000){
+            fill(dst,num,color);
+            return;
+        }
+        __m128i s=_mm_set1_epi32(color);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            __m128i d=_mm_loadu_si128((const __m128i*)(dst+i));
+            _mm_storeu_si128((__m128i*)(dst+i),blend4(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],color);
+    }
+    static void blend(ColorAndAlpha *dst, const ColorAndAlpha *src, int num){
+        const __m128i m8=_mm_set1_epi32(0xff);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            __m128i s=_mm_loadu_si128((const __m128i*)(src+i));
+            __m128i aA=_mm_srli_epi32(s,24);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(s,_mm_setzero_si128())) == 0xffff) continue;
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(aA,m8)) == 0xffff){
+                _mm_storeu_si128((__m128i*)(dst+i),s);
+                continue;
+            }
+            __m128i d=_mm_loadu_si128((const __m128i*)(dst+i));
+            _mm_storeu_si128((__m128i*)(dst+i),blend4(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],src[i]);
+    }
+    static void glyph(ColorAndAlpha *dst, const uint8_t *src, int num, ColorAndAlpha color){
+        const __m128i zero=_mm_setzero_si128();
+        ColorAndAlpha rgbValue=color & 0xffffff;
+        __m128i rgb=_mm_set1_epi32(rgbValue);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            int32_t a;
+            memcpy(&a,src+i,sizeof(a));
+            __m128i av=_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(a),zero),zero);
+            __m128i s=_mm_or_si128(rgb,_mm_slli_epi32(av,24));
+            __m128i d=_mm_loadu_si128((const __m128i*)(dst+i));
+            _mm_storeu_si128((__m128i*)(dst+i),blend4(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],rgbValue | (((ColorAndAlpha)src[i]) << 24));
+    }
+    static const SpanKernels::Kernels kernels={"sse2",fill,blendColor,blend,glyph};
+}
+#endif
+
+#if defined(SPAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SPAN_AVX2
+namespace avx2{
+    using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+    #define AVX2_FUNCTION __attribute__((target("avx2")))
+    AVX2_FUNCTION static inline __m256i select(__m256i mask, __m256i a, __m256i b){
+        return _mm256_blendv_epi8(b,a,mask);
+    }
+    AVX2_FUNCTION static inline __m256i blend8(__m256i d, __m256i s){
+        const __m256i m8=_mm256_set1_epi32(0xff);
+        const __m256i zero=_mm256_setzero_si256();
+        __m256i aA=_mm256_srli_epi32(s,24);
+        __m256i aB=_mm256_srli_epi32(d,24);
+        __m256i bF=_mm256_srli_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(m8,aA),aB),_mm256_set1_epi32(1<<7)),8);
+        __m256i anew=_mm256_add_epi32(aA,bF);
+        __m256i f=_mm256_i32gather_epi32((const int*)SpanKernels::factors,anew,4);
+        __m256i wA=_mm256_mullo_epi32(f,aA);
+        __m256i wB=_mm256_mullo_epi32(f,bF);
+        __m256i rt=_mm256_slli_epi32(anew,24);
+        for (int shift=0;shift<24;shift+=8){
+            __m256i sc=_mm256_and_si256(_mm256_srli_epi32(s,shift),m8);
+            __m256i dc=_mm256_and_si256(_mm256_srli_epi32(d,shift),m8);
+            __m256i c=_mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi32(sc,wA),_mm256_mullo_epi32(dc,wB)),_mm256_set1_epi32(1<<15));
+            c=_mm256_min_epu32(_mm256_srli_epi32(c,16),m8);
+            rt=_mm256_or_si256(rt,_mm256_slli_epi32(c,shift));
+        }
+        rt=select(_mm256_cmpeq_epi32(aA,zero),d,rt);
+        rt=select(_mm256_or_si256(_mm256_cmpeq_epi32(aA,m8),_mm256_cmpeq_epi32(aB,zero)),s,rt);
+        rt=select(_mm256_cmpeq_epi32(s,zero),d,rt);
+        return rt;
+    }
+    AVX2_FUNCTION static void fill(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        __m256i c=_mm256_set1_epi32(color);
+        int i=0;
+        for (;i+8<=num;i+=8){
+            _mm256_storeu_si256((__m256i*)(dst+i),c);
+        }
+        for (;i<num;i++) dst[i]=color;
+    }
+    AVX2_FUNCTION static void blendColor(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        if (color == 0) return;
+        if ((color & 0xff000000) == 0xff000000){
+            fill(dst,num,color);
+            return;
+        }
+        __m256i s=_mm256_set1_epi32(color);
+        int i=0;
+        for (;i+8<=num;i+=8){
+            __m256i d=_mm256_loadu_si256((const __m256i*)(dst+i));
+            _mm256_storeu_si256((__m256i*)(dst+i),blend8(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],color);
+    }
+    AVX2_FUNCTION static void blend(ColorAndAlpha *dst, const ColorAndAlpha *src, int num){
+        const __m256i m8=_mm256_set1_epi32(0xff);
+        int i=0;
+        for (;i+8<=num;i+=8){
+            __m256i s=_mm256_loadu_si256((const __m256i*)(src+i));
+            if (_mm256_testz_si256(s,s)) continue;
+            __m256i aA=_mm256_srli_epi32(s,24);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(aA,m8)) == -1){
+                _mm256_storeu_si256((__m256i*)(dst+i),s);
+                continue;
+            }
+            __m256i d=_mm256_loadu_si256((const __m256i*)(dst+i));
+            _mm256_storeu_si256((__m256i*)(dst+i),blend8(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],src[i]);
+    }
+    AVX2_FUNCTION static void glyph(ColorAndAlpha *dst, const uint8_t *src, int num, ColorAndAlpha color){
+        ColorAndAlpha rgbValue=color & 0xffffff;
+        __m256i rgb=_mm256_set1_epi32(rgbValue);
+        int i=0;
+        for (;i+8<=num;i+=8){
+            __m256i av=_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src+i)));
+            __m256i s=_mm256_or_si256(rgb,_mm256_slli_epi32(av,24));
+            __m256i d=_mm256_loadu_si256((const __m256i*)(dst+i));
+            _mm256_storeu_si256((__m256i*)(dst+i),blend8(d,s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],rgbValue | (((ColorAndAlpha)src[i]) << 24));
+    }
+    static const SpanKernels::Kernels kernels={"avx2",fill,blendColor,blend,glyph};
+}
+#endif
+
+#ifdef SPAN_NEON
+namespace neon{
+    using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+    static inline uint32x4_t blend4(uint32x4_t d, uint32x4_t s){
+        const uint32x4_t m8=vdupq_n_u32(0xff);
+        const uint32x4_t zero=vdupq_n_u32(0);
+        uint32x4_t aA=vshrq_n_u32(s,24);
+        uint32x4_t aB=vshrq_n_u32(d,24);
+        uint32x4_t bF=vshrq_n_u32(vaddq_u32(vmulq_u32(vsubq_u32(m8,aA),aB),vdupq_n_u32(1<<7)),8);
+        uint32x4_t anew=vaddq_u32(aA,bF);
+        uint32_t idx[4];
+        vst1q_u32(idx,anew);
+        uint32_t fv[4]={SpanKernels::factors[idx[0]],SpanKernels::factors[idx[1]],
+            SpanKernels::factors[idx[2]],SpanKernels::factors[idx[3]]};
+        uint32x4_t f=vld1q_u32(fv);
+        uint32x4_t wA=vmulq_u32(f,aA);
+        uint32x4_t wB=vmulq_u32(f,bF);
+        uint32x4_t rt=vshlq_n_u32(anew,24);
+        const int32x4_t shifts[3]={vdupq_n_s32(0),vdupq_n_s32(-8),vdupq_n_s32(-16)};
+        for (int i=0;i<3;i++){
+            uint32x4_t sc=vandq_u32(vshlq_u32(s,shifts[i]),m8);
+            uint32x4_t dc=vandq_u32(vshlq_u32(d,shifts[i]),m8);
+            uint32x4_t c=vaddq_u32(vaddq_u32(vmulq_u32(sc,wA),vmulq_u32(dc,wB)),vdupq_n_u32(1<<15));
+            c=vminq_u32(vshrq_n_u32(c,16),m8);
+            rt=vorrq_u32(rt,vshlq_u32(c,vnegq_s32(shifts[i])));
+        }
+        rt=vbslq_u32(vceqq_u32(aA,zero),d,rt);
+        rt=vbslq_u32(vorrq_u32(vceqq_u32(aA,m8),vceqq_u32(aB,zero)),s,rt);
+        rt=vbslq_u32(vceqq_u32(s,zero),d,rt);
+        return rt;
+    }
+    static inline bool allTrue(uint32x4_t v){
+        uint32x2_t t=vand_u32(vget_low_u32(v),vget_high_u32(v));
+        return (vget_lane_u32(t,0) & vget_lane_u32(t,1)) == 0xffffffff;
+    }
+    static void fill(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        uint32x4_t c=vdupq_n_u32(color);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            vst1q_u32(dst+i,c);
+        }
+        for (;i<num;i++) dst[i]=color;
+    }
+    static void blendColor(ColorAndAlpha *dst, int num, ColorAndAlpha color){
+        if (color == 0) return;
+        if ((color & 0xff000000) == 0xff000000){
+            fill(dst,num,color);
+            return;
+        }
+        uint32x4_t s=vdupq_n_u32(color);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            vst1q_u32(dst+i,blend4(vld1q_u32(dst+i),s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],color);
+    }
+    static void blend(ColorAndAlpha *dst, const ColorAndAlpha *src, int num){
+        const uint32x4_t m8=vdupq_n_u32(0xff);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            uint32x4_t s=vld1q_u32(src+i);
+            if (allTrue(vceqq_u32(s,vdupq_n_u32(0)))) continue;
+            if (allTrue(vceqq_u32(vshrq_n_u32(s,24),m8))){
+                vst1q_u32(dst+i,s);
+                continue;
+            }
+            vst1q_u32(dst+i,blend4(vld1q_u32(dst+i),s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],src[i]);
+    }
+    static void glyph(ColorAndAlpha *dst, const uint8_t *src, int num, ColorAndAlpha color){
+        ColorAndAlpha rgbValue=color & 0xffffff;
+        uint32x4_t rgb=vdupq_n_u32(rgbValue);
+        int i=0;
+        for (;i+4<=num;i+=4){
+            uint32_t a[4]={src[i],src[i+1],src[i+2],src[i+3]};
+            uint32x4_t s=vorrq_u32(rgb,vshlq_n_u32(vld1q_u32(a),24));
+            vst1q_u32(dst+i,blend4(vld1q_u32(dst+i),s));
+        }
+        for (;i<num;i++) dst[i]=SpanKernels::blendPixel(dst[i],rgbValue | (((ColorAndAlpha)src[i]) << 24));
+    }
+    static const SpanKernels::Kernels kernels={"neon",fill,blendColor,blend,glyph};
+}
+#endif
+
+std::vector<const SpanKernels::Kernels *> SpanKernels::available(){
+    std::vector<const Kernels *> rt;
+    rt.push_back(&scalar::kernels);
+#if defined(SPAN_X86) && defined(__SSE2__)
+    rt.push_back(&sse2::kernels);
+#endif
+#ifdef SPAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        rt.push_back(&avx2::kernels);
+    }
+#endif
+#ifdef SPAN_NEON
+    rt.push_back(&neon::kernels);
+#endif
+    return rt;
+}
+
+const SpanKernels::Kernels *SpanKernels::find(const String &name){
+    for (const auto &k:available()){
+        if (name == k->name) return k;
+    }
+    return nullptr;
+}
+
+const SpanKernels::Kernels *SpanKernels::get(){
+    static const Kernels *selected=available().back();
+    return selected;
+}
+
+const uint32_t SpanKernels::factors[256]={
+    //table for 255*256/x
+    1, //never used
+    65280,
+    32640,
+    21760,
+    16320,
+    13056,
+    10880,
+    9325,
+    8160,
+    7253,
+    6528,
+    5934,
+    5440,
+    5021,
+    4662,
+    4352,
+    4080,
+    3840,
+    3626,
+    3435,
+    3264,
+    3108,
+    2967,
+    2838,
+    2720,
+    2611,
+    2510,
+    2417,
+    2331,
+    2251,
+    2176,
+    2105,
+    2040,
+    1978,
+    1920,
+    1865,
+    1813,
+    1764,
+    1717,
+    1673,
+    1632,
+    1592,
+    1554,
+    1518,
+    1483,
+    1450,
+    1419,
+    1388,
+    1360,
+    1332,
+    1305,
+    1280,
+    1255,
+    1231,
+    1208,
+    1186,
+    1165,
+    1145,
+    1125,
+    1106,
+    1088,
+    1070,
+    1052,
+    1036,
+    1020,
+    1004,
+    989,
+    974,
+    960,
+    946,
+    932,
+    919,
+    906,
+    894,
+    882,
+    870,
+    858,
+    847,
+    836,
+    826,
+    816,
+    805,
+    796,
+    786,
+    777,
+    768,
+    759,
+    750,
+    741,
+    733,
+    725,
+    717,
+    709,
+    701,
+    694,
+    687,
+    680,
+    672,
+    666,
+    659,
+    652,
+    646,
+    640,
+    633,
+    627,
+    621,
+    615,
+    610,
+    604,
+    598,
+    593,
+    588,
+    582,
+    577,
+    572,
+    567,
+    562,
+    557,
+    553,
+    548,
+    544,
+    539,
+    535,
+    530,
+    526,
+    522,
+    518,
+    514,
+    510,
+    506,
+    502,
+    498,
+    494,
+    490,
+    487,
+    483,
+    480,
+    476,
+    473,
+    469,
+    466,
+    462,
+    459,
+    456,
+    453,
+    450,
+    447,
+    444,
+    441,
+    438,
+    435,
+    432,
+    429,
+    426,
+    423,
+    421,
+    418,
+    415,
+    413,
+    410,
+    408,
+    405,
+    402,
+    400,
+    398,
+    395,
+    393,
+    390,
+    388,
+    386,
+    384,
+    381,
+    379,
+    377,
+    375,
+    373,
+    370,
+    368,
+    366,
+    364,
+    362,
+    360,
+    358,
+    356,
+    354,
+    352,
+    350,
+    349,
+    347,
+    345,
+    343,
+    341,
+    340,
+    338,
+    336,
+    334,
+    333,
+    331,
+    329,
+    328,
+    326,
+    324,
+    323,
+    321,
+    320,
+    318,
+    316,
+    315,
+    313,
+    312,
+    310,
+    309,
+    307,
+    306,
+    305,
+    303,
+    302,
+    300,
+    299,
+    298,
+    296,
+    295,
+    294,
+    292,
+    291,
+    290,
+    288,
+    287,
+    286,
+    285,
+    283,
+    282,
+    281,
+    280,
+    278,
+    277,
+    276,
+    275,
+    274,
+    273,
+    272,
+    270,
+    269,
+    268,
+    267,
+    266,
+    265,
+    264,
+    263,
+    262,
+    261,
+    260,
+    259,
+    258,
+    257,
+    256
+};
@@ -0,0 +1,44 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Static spatial index
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include "SpatialIndex.h"
+
+SpatialIndex::SpatialIndex(ocalloc::PoolRef pool):tree(pool){}
+
+void SpatialIndex::add(const Coord::Extent &extent, uint32_t id){
+    if (! extent.valid) return;
+    tree.add(extent,id);
+}
+
+void SpatialIndex::build(){
+    tree.build();
+}
+
+void SpatialIndex::query(const Coord::Extent &box, IdList &result) const{
+    tree.query(box,[](const Traits::Summary &){ return true;},[&result](const Entry &e){
+        result.push_back(e.id);
+    });
+}
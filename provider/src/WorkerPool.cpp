@@ -0,0 +1,147 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Bounded worker pool
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "WorkerPool.h"
+#include "Logger.h"
+#include <exception>
+
+WorkerPool::WorkerPool(const String &name,int numThreads):name(name),numThreads(numThreads),waiter(lock){
+    if (this->numThreads < 1) this->numThreads=1;
+    for (int i=0;i<this->numThreads;i++){
+        threads.push_back(std::thread([this](){this->run();}));
+    }
+    LOG_INFO("worker pool %s started with %d threads",name,this->numThreads);
+}
+WorkerPool::~WorkerPool(){
+    Stop();
+}
+bool WorkerPool::Submit(Task task){
+    Synchronized l(lock);
+    if (stopped) return false;
+    queue.push_back(task);
+    waiter.notify(l);
+    return true;
+}
+class WorkerPool::RunAllState{
+    public:
+    const std::vector<Task> *tasks;
+    const size_t numTasks;
+    std::atomic<size_t> next={0};
+    std::mutex lock;
+    Condition waiter;
+    size_t finished=0;
+    std::exception_ptr error;
+    RunAllState(const std::vector<Task> *t):tasks(t),numTasks(t->size()),waiter(lock){}
+    //pick tasks until none are left
+    //tasks is only accessed for a valid index - so RunAll has not returned yet
+    void work(){
+        while (true){
+            size_t idx=next++;
+            if (idx >= numTasks) return;
+            std::exception_ptr taskError;
+            try{
+                (*tasks)[idx]();
+            }catch (...){
+                taskError=std::current_exception();
+            }
+            Synchronized l(lock);
+            if (taskError && ! error) error=taskError;
+            finished++;
+            if (finished >= numTasks) waiter.notifyAll(l);
+        }
+    }
+};
+
+void WorkerPool::RunAll(const std::vector<Task> &tasks){
+    if (tasks.empty()) return;
+    std::shared_ptr<RunAllState> state=std::make_shared<RunAllState>(&tasks);
+    for (size_t i=1;i<tasks.size() && i <= (size_t)numThreads;i++){
+        if (! Submit([state](){state->work();})) break;
+    }
+    state->work();
+    Synchronized l(state->lock);
+    while (state->finished < state->numTasks){
+        state->waiter.wait(l);
+    }
+    if (state->error) std::rethrow_exception(state->error);
+}
+void WorkerPool::Stop(){
+    std::deque<Task> dropped;
+    {
+        Synchronized l(lock);
+        if (stopped && threads.empty()) return;
+        stopped=true;
+        dropped.swap(queue);
+        waiter.notifyAll(l);
+    }
+    if (! dropped.empty()){
+        LOG_INFO("worker pool %s: dropping %d queued tasks",name,(int)dropped.size());
+    }
+    //release the dropped tasks outside the lock
+    //as their captures may run cleanup code
+    dropped.clear();
+    for (auto &&thread:threads){
+        if (thread.joinable()) thread.join();
+    }
+    threads.clear();
+}
+void WorkerPool::run(){
+    while (true){
+        Task task;
+        {
+            Synchronized l(lock);
+            while (! stopped && queue.empty()){
+                waiter.wait(l);
+            }
+            if (stopped) return;
+            task=queue.front();
+            queue.pop_front();
+            numRunning++;
+        }
+        try{
+            task();
+        }catch (std::exception &e){
+            LOG_ERROR("worker pool %s: exception in task: %s",name,e.what());
+        }catch (...){
+            LOG_ERROR("worker pool %s: unknown exception in task",name);
+        }
+        task=Task(); //release captures before counting the task as done
+        numRunning--;
+        numDone++;
+    }
+}
+void WorkerPool::ToJson(StatusStream &stream){
+    size_t queued=0;
+    {
+        Synchronized l(lock);
+        queued=queue.size();
+    }
+    stream["threads"]=numThreads;
+    stream["queued"]=(int)queued;
+    stream["running"]=(int)numRunning;
+    stream["done"]=(long)numDone;
+}
@@ -70,6 +70,8 @@ void usage (const char *name){
     std::cerr <<  "       -k switch on debug info in rendered tiles" << std::endl;
     std::cerr <<  "       -b predefinedName - predefined system name to be used when registering this system (android)" << std::endl;
     std::cerr <<  "       -x memPercent limit the chart memory to this percentage of the system memory (default: 50)" << std::endl;
+    std::cerr <<  "       -r numReaders parallel chart header reads per oexserverd (default: 4)" << std::endl;
+    std::cerr <<  "       -s numServers number of oexserverd instances to run (default: 1)" << std::endl;
     std::cerr <<  "       -c tileCacheKb - the memory for the tile cache in KB(default:"<< (40*1024) <<"), use 0 to disable" << std::endl;
     std::cerr <<  "       -z additional chart dir, multiple possible" << std::endl;
 }
@@ -105,9 +107,11 @@ int mainFunction(int argc, char **argv,bool *stopFlag=NULL)
     bool renderDebug=false;
     int logLevel=LOG_LEVEL_INFO;
     int numOpeners=6;
+    int numReaders=4;
+    int numOexServers=1;
     int tileCacheMem=40*1024;
     StringVector additionalChartDirs;
-    while ((opt = getopt(argc, argv, "l:a:d:u:g:t:kp:b:x:o:c:z:")) != -1) {
+    while ((opt = getopt(argc, argv, "l:a:d:u:g:t:kp:b:x:o:r:s:c:z:")) != -1) {
                 switch (opt) {
                 case 'k':
                     renderDebug=true;
@@ -142,6 +146,14 @@ int mainFunction(int argc, char **argv,bool *stopFlag=NULL)
                 case 'o':
                     numOpeners=::atoi(optarg);
                     break;
+                case 'r':
+                    numReaders=::atoi(optarg);
+                    if (numReaders < 1) numReaders=1;
+                    break;
+                case 's':
+                    numOexServers=::atoi(optarg);
+                    if (numOexServers < 1) numOexServers=1;
+                    break;
                 case 'c':
                     tileCacheMem=::atoi(optarg);
                     if (tileCacheMem < 0) tileCacheMem=0;
@@ -189,7 +201,7 @@ int mainFunction(int argc, char **argv,bool *stopFlag=NULL)
     if (oexParam != String("")){
         oexParamList=StringHelper::split(oexParam,":");
     }
-    OexControl::Init(codeBase,chartTempDir,oexParamList);
+    OexControl::Init(codeBase,chartTempDir,oexParamList,numOexServers);
     collector.AddItem("oexserverd",OexControl::Instance());
     OexControl::Instance()->Start();
     signal(SIGTERM,termHandler);
@@ -219,7 +231,7 @@ int mainFunction(int argc, char **argv,bool *stopFlag=NULL)
     ChartFactory::Ptr chartFactory=std::make_shared<ChartFactory>(OexControl::Instance());
     FontFileHolder::Ptr fontFile=std::make_shared<FontFileHolder>(FileHelper::concatPath(s57Dir,"Roboto-Regular.ttf"));
     fontFile->init();
-    chartManager=std::make_shared<ChartManager>(fontFile,settings->GetBaseSettings(), settings->GetRenderSettings(),chartFactory,s57Dir, memoryLimit,numOpeners);
+    chartManager=std::make_shared<ChartManager>(fontFile,settings->GetBaseSettings(), settings->GetRenderSettings(),chartFactory,s57Dir, memoryLimit,numOpeners,numReaders*numOexServers);
     settings->registerUpdater([&chartManager](IBaseSettings::ConstPtr base,RenderSettings::ConstPtr rs){
         chartManager->UpdateSettings(base,rs);
     });
@@ -287,7 +299,13 @@ int mainFunction(int argc, char **argv,bool *stopFlag=NULL)
             if (*it == chartInstaller->GetTempDir()) continue;
             toRead.push_back(*it);
         }
-        //TODO: chartInfoCache
+        String chartInfoCacheDir=FileHelper::concatPath(configDir,"chartIndex");
+        if (FileHelper::makeDirs(chartInfoCacheDir)){
+            chartManager->SetChartInfoCacheDir(chartInfoCacheDir);
+        }
+        else{
+            LOG_ERROR("unable to create chart info cache dir %s",chartInfoCacheDir);
+        }
         chartManager->ReadChartsInitial(toRead,true);
         chartManager->ReadChartsInitial(additionalChartDirs,false);
         chartManager->RemoveUnverified();
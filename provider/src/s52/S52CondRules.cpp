@@ -34,10 +34,13 @@
 #include <string.h>
 namespace s52
 {
-    String S52CondRules::expand(const LUPrec *lup, const String &rule,const S52Data *s52data, const RuleConditions *conditions){
+    S52CondRules::Rule::Map::const_iterator S52CondRules::findRule(const String &rule){
         String name=rule.substr(3);
         StringHelper::replaceInline(name,")","");
-        auto it=rules.find(name);
+        return rules.find(name);
+    }
+    String S52CondRules::expand(const LUPrec *lup, const String &rule,const S52Data *s52data, const RuleConditions *conditions){
+        auto it=findRule(rule);
         if (it == rules.end()) {
             LOG_DEBUG("unknown cond rule %s",rule);
             return rule;
@@ -46,6 +49,77 @@ namespace s52
         return it->second.function(lup,rule,s52data,conditions);    
     }
 
+    template <typename T>
+    static void appendValue(String &key, const T &v){
+        key.append((const char *)&v, sizeof(v));
+    }
+    bool S52CondRules::cacheKey(const LUPrec *lup, const String &rule, const S52Data *s52data, const RuleConditions *conditions, String &key){
+        auto it=findRule(rule);
+        if (it == rules.end()) return false;
+        if (it->second.type == Rule::T_STEP2 && conditions == nullptr) return false;
+        key.append(rule);
+        key.push_back('\0');
+        const Inputs &inputs=it->second.inputs;
+        if (inputs.flags & Inputs::I_OBCL){
+            key.append(lup->OBCL);
+            key.push_back('\0');
+        }
+        if (inputs.flags & Inputs::I_GEO) appendValue(key,conditions->geoPrimitive);
+        if (inputs.flags & Inputs::I_FLOATING_BASE) appendValue(key,conditions->hasFloatingBase);
+        if (inputs.flags & Inputs::I_NEXT_SAFETY) appendValue(key,conditions->nextSafetyContour);
+        if (inputs.flags & Inputs::I_FEATURE) appendValue(key,conditions->featureTypeCode);
+        const RenderSettings *settings=s52data->getSettings().get();
+        if (inputs.flags & Inputs::S_SAFETY_CONTOUR) appendValue(key,settings->S52_MAR_SAFETY_CONTOUR);
+        if (inputs.flags & Inputs::S_DEPTH_SHADES){
+            appendValue(key,settings->S52_MAR_TWO_SHADES);
+            appendValue(key,settings->S52_MAR_SHALLOW_CONTOUR);
+            appendValue(key,settings->S52_MAR_DEEP_CONTOUR);
+        }
+        if (inputs.flags & Inputs::S_DEPTH_UNIT) appendValue(key,settings->S52_DEPTH_UNIT_SHOW);
+        if (inputs.flags & Inputs::S_SYMBOL_SCALE) appendValue(key,settings->symbolScale);
+        if (inputs.flags & Inputs::S_BOUNDARY_STYLE) appendValue(key,settings->nBoundaryStyle);
+        if (inputs.attributes.empty()) return true;
+        if (conditions->attributes == nullptr){
+            key.push_back('N');
+            return true;
+        }
+        key.push_back('A');
+        for (auto id: inputs.attributes){
+            auto ait=conditions->attributes->find(id);
+            if (ait == conditions->attributes->end()){
+                key.push_back('-');
+                continue;
+            }
+            ait->second.addToSignature(key);
+        }
+        return true;
+    }
+
+    bool CondRuleCache::get(const String &key, String &expanded){
+        Synchronized l(lock);
+        auto it=cache.find(key);
+        if (it == cache.end()){
+            misses++;
+            return false;
+        }
+        hits++;
+        expanded=it->second;
+        return true;
+    }
+    void CondRuleCache::add(const String &key, const String &expanded){
+        Synchronized l(lock);
+        if (cache.size() >= MAX_ENTRIES) return;
+        cache[key]=expanded;
+    }
+    void CondRuleCache::ToJson(StatusStream &stream){
+        {
+            Synchronized l(lock);
+            stream["condProcEntries"]=(int)cache.size();
+        }
+        stream["condProcHits"]=(long)hits;
+        stream["condProcMisses"]=(long)misses;
+    }
+
     static String DEPARE01(const LUPrec *lup, const String &rule, const S52Data *s52data, const RuleConditions *conditions)
     {
         if (!conditions){
@@ -1805,6 +1879,15 @@ namespace s52
         rt.push_back('\037');
         return rt;
     }
+    //the inputs must contain everything a procedure reads from
+    //the object, the LUP and the settings - see cacheKey
+    static const S52CondRules::Inputs depareInputs(
+        S52CondRules::Inputs::I_OBCL | S52CondRules::Inputs::S_SAFETY_CONTOUR | S52CondRules::Inputs::S_DEPTH_SHADES,
+        {S57AttrIds::DRVAL1, S57AttrIds::DRVAL2});
+    static const S52CondRules::Inputs lightsInputs(
+        S52CondRules::Inputs::S_SYMBOL_SCALE | S52CondRules::Inputs::S_DEPTH_UNIT,
+        {S57AttrIds::CATLIT, S57AttrIds::COLOUR, S57AttrIds::VALNMR, S57AttrIds::EXCLIT, S57AttrIds::SECTR1, S57AttrIds::SECTR2,
+         S57AttrIds::LITVIS, S57AttrIds::LITCHR, S57AttrIds::SIGGRP, S57AttrIds::SIGPER, S57AttrIds::HEIGHT});
     S52CondRules::Rule::Map S52CondRules::rules({
         /*
         empty rules:
@@ -1826,20 +1909,23 @@ namespace s52
         */
         {"dummy1", Rule(dummy1)},
         {"DATCVR01", Rule(DATCVR01, Rule::T_STEP1)},
-        {"SLCONS03", Rule(SLCONS03)},
-        {"QUAPOS01", Rule(QUAPOS01)},
-        {"QUAPNT01", Rule(QUAPNT01)},
-        {"QUALIN01", Rule(QUALIN01)},
-        {"RESTRN01", Rule(RESTRN01)},
-        {"DEPARE01", Rule(DEPARE01)},
-        {"DEPARE02", Rule(DEPARE01)},
-        {"RESARE02", Rule(RESARE02)},
-        {"TOPMAR01", Rule(TOPMAR01)},
-        {"OBSTRN04", Rule(OBSTRN04)},
-        {"WRECKS02", Rule(WRECKS02)},
-        {"LIGHTS06", Rule(LIGHTS06)},
-        {"LIGHTS05", Rule(LIGHTS06)},
-        {"DEPCNT02", Rule(DEPCNT02)},
+        {"SLCONS03", Rule(SLCONS03, Inputs(Inputs::I_GEO, {S57AttrIds::QUAPOS, S57AttrIds::CONDTN, S57AttrIds::CATSLC, S57AttrIds::WATLEV}))},
+        {"QUAPOS01", Rule(QUAPOS01, Inputs(Inputs::I_GEO | Inputs::I_FEATURE, {S57AttrIds::QUAPOS, S57AttrIds::CONRAD, S57AttrIds::QUALTY}))},
+        {"QUAPNT01", Rule(QUAPNT01, Inputs(Inputs::I_NONE, {S57AttrIds::QUALTY}))},
+        {"QUALIN01", Rule(QUALIN01, Inputs(Inputs::I_FEATURE, {S57AttrIds::QUAPOS, S57AttrIds::CONRAD}))},
+        {"RESTRN01", Rule(RESTRN01, Inputs(Inputs::I_NONE, {S57AttrIds::RESTRN}))},
+        {"DEPARE01", Rule(DEPARE01, depareInputs)},
+        {"DEPARE02", Rule(DEPARE01, depareInputs)},
+        {"RESARE02", Rule(RESARE02, Inputs(Inputs::S_BOUNDARY_STYLE, {S57AttrIds::RESTRN, S57AttrIds::CATREA}))},
+        {"TOPMAR01", Rule(TOPMAR01, Inputs(Inputs::I_FLOATING_BASE, {S57AttrIds::TOPSHP}))},
+        {"OBSTRN04", Rule(OBSTRN04, Inputs(Inputs::I_OBCL | Inputs::I_GEO | Inputs::S_SAFETY_CONTOUR,
+            {S57AttrIds::VALSOU, S57AttrIds::CATOBS, S57AttrIds::WATLEV, S57AttrIds::QUALTY}))},
+        {"WRECKS02", Rule(WRECKS02, Inputs(Inputs::I_GEO | Inputs::S_SAFETY_CONTOUR,
+            {S57AttrIds::VALSOU, S57AttrIds::WATLEV, S57AttrIds::CATWRK, S57AttrIds::QUASOU, S57AttrIds::QUAPOS, S57AttrIds::QUALTY}))},
+        {"LIGHTS06", Rule(LIGHTS06, lightsInputs)},
+        {"LIGHTS05", Rule(LIGHTS06, lightsInputs)},
+        {"DEPCNT02", Rule(DEPCNT02, Inputs(Inputs::I_GEO | Inputs::I_NEXT_SAFETY | Inputs::S_SAFETY_CONTOUR,
+            {S57AttrIds::VALDCO, S57AttrIds::DRVAL1, S57AttrIds::DRVAL2, S57AttrIds::QUAPOS}))},
         {"SOUNDG02", Rule(SOUNDG02, Rule::T_STEP1)} // already translate when building s52data
     });
 }
@@ -33,6 +33,8 @@
 #include "Logger.h"
 #include "CsvReader.h"
 #include <cmath>
+#include <cstring>
+#include <set>
 #include <functional>
 #include "fpng.h"
 #include "PngHandler.h"
@@ -88,6 +90,64 @@ namespace s52
         return false;
     }
 
+    AttributeCondition::AttributeCondition(uint16_t i, const String &value) : id(i)
+    {
+        // see Attribute::equals
+        if (value.empty() || value == " ")
+        {
+            mode = C_ANY;
+            return;
+        }
+        if (value == "?")
+        {
+            mode = C_ABSENT;
+            return;
+        }
+        iv = ::atoi(value.c_str());
+        dv = ::atof(value.c_str());
+        sv = value;
+    }
+    bool Attribute::equals(const AttributeCondition &condition) const
+    {
+        if (condition.mode == AttributeCondition::C_ANY)
+            return true;
+        if (condition.mode == AttributeCondition::C_ABSENT)
+            return false;
+        switch (this->type)
+        {
+        case T_INT:
+            return condition.iv == iv;
+        case T_DOUBLE:
+            return ::fabs(condition.dv - dv) < 1e-6;
+        case T_STRING:
+            return strcmp(condition.sv.c_str(), sv.c_str()) == 0;
+        default:
+            return false;
+        }
+    }
+    void Attribute::addToSignature(String &signature) const
+    {
+        signature.push_back((char)('0' + type));
+        switch (type)
+        {
+        case T_INT:
+            signature.append((const char *)&iv, sizeof(iv));
+            break;
+        case T_DOUBLE:
+            signature.append((const char *)&dv, sizeof(dv));
+            break;
+        case T_STRING:
+        {
+            uint32_t len = sv.size();
+            signature.append((const char *)&len, sizeof(len));
+            signature.append(sv.c_str(), len);
+        }
+        break;
+        default:
+            break;
+        }
+    }
+
     bool Attribute::Map::hasAttr(uint16_t id, Attribute::Type type) const
     {
         auto it = find(id);
@@ -162,6 +222,15 @@ namespace s52
         return false;
     }
 
+    void LUPrec::parseConditions()
+    {
+        conditions.clear();
+        for (auto it = ATTCArray.begin(); it != ATTCArray.end(); it++)
+        {
+            conditions.push_back(AttributeCondition(it->first, it->second));
+        }
+        conditionsParsed = true;
+    }
     int LUPrec::attributeMatch(const Attribute::Map *objectAttributes) const
     {
         if (objectAttributes->size() < 1)
@@ -178,6 +247,26 @@ namespace s52
             return 0;
         }
         int rt = 0;
+        if (conditionsParsed)
+        {
+            for (auto it = conditions.begin(); it != conditions.end(); it++)
+            {
+                auto oit = objectAttributes->find(it->id);
+                if (oit == objectAttributes->end())
+                {
+                    if (it->mode == AttributeCondition::C_ABSENT)
+                    {
+                        rt++;
+                        continue;
+                    }
+                    return 0;
+                }
+                if (!oit->second.equals(*it))
+                    return 0;
+                rt++;
+            }
+            return rt;
+        }
         for (auto it = ATTCArray.begin(); it != ATTCArray.end(); it++)
         {
             auto oit = objectAttributes->find(it->first);
@@ -197,9 +286,92 @@ namespace s52
         }
         return rt;
     }
+
+    LUPSelector::LUPSelector(const LUPRecords &records)
+    {
+        std::set<uint16_t> ids;
+        for (auto &lui : records)
+        {
+            // see findLUPrecord: only the first LUP without attributes
+            // can match, the others have a score of 0
+            if (lui.ATTCArray.size() == 0)
+            {
+                if (noAttrMatch == nullptr)
+                    noAttrMatch = &lui;
+                continue;
+            }
+            candidates.push_back(&lui);
+            for (auto &&[id, value] : lui.ATTCArray)
+            {
+                ids.insert(id);
+            }
+        }
+        relevantIds.assign(ids.begin(), ids.end());
+    }
+    const LUPrec *LUPSelector::compute(const Attribute::Map *attributes) const
+    {
+        const LUPrec *bestMatch = nullptr;
+        int score = 0;
+        for (auto &lui : candidates)
+        {
+            int nScore = lui->attributeMatch(attributes);
+            if (nScore > score)
+            {
+                score = nScore;
+                bestMatch = lui;
+            }
+        }
+        if (bestMatch)
+            return bestMatch;
+        return noAttrMatch;
+    }
+    String LUPSelector::signature(const Attribute::Map *attributes) const
+    {
+        String rt;
+        rt.reserve(relevantIds.size() * 5 + 1);
+        // no attributes at all behaves different from no relevant attributes
+        rt.push_back('A');
+        for (auto id : relevantIds)
+        {
+            auto it = attributes->find(id);
+            if (it == attributes->end())
+            {
+                rt.push_back('-');
+                continue;
+            }
+            it->second.addToSignature(rt);
+        }
+        return rt;
+    }
+    const LUPrec *LUPSelector::find(const Attribute::Map *attributes, bool &cacheHit)
+    {
+        cacheHit = false;
+        if (candidates.size() == 0 || attributes == nullptr || attributes->size() < 1)
+        {
+            return noAttrMatch;
+        }
+        String key = signature(attributes);
+        {
+            Synchronized l(lock);
+            auto it = cache.find(key);
+            if (it != cache.end())
+            {
+                cacheHit = true;
+                return it->second;
+            }
+        }
+        const LUPrec *rt = compute(attributes);
+        Synchronized l(lock);
+        if (cache.size() < MAX_CACHE_ENTRIES)
+        {
+            cache[key] = rt;
+        }
+        return rt;
+    }
     S52Data::S52Data(RenderSettings::ConstPtr settings, FontFileHolder::Ptr f, int s) : sequence(s), pool(ocalloc::makePool("s52Data")), pref(pool), renderSettings(settings), fontFile(f)
     {
         ruleCreator = new RuleCreator(pref, 0);
+        condCache = std::make_shared<CondRuleCache>();
     }
     S52Data::~S52Data()
     {
@@ -242,6 +414,11 @@ namespace s52
         timer.set(startRaster, "createRasterSymbols");
         buildRules();
         timer.add("buildRules");
+        commandFonts[FONT_TXT] = getFontManager(FONT_TXT);
+        commandFonts[FONT_SOUND] = getFontManager(FONT_SOUND);
+        soundingStyle.fm = commandFonts[FONT_SOUND];
+        soundingStyle.cDeep = convertColor(getColor("SNDG1"));
+        soundingStyle.cShallow = convertColor(getColor("SNDG2"));
         initialized = true;
         LOG_DEBUG("finishing S52Data::init %s", timer.toString());
     }
@@ -275,40 +452,16 @@ namespace s52
     const LUPrec *S52Data::findLUPrecord(const LUPname &name, uint16_t featureTypeCode, const Attribute::Map *attributes) const
     {
         AVASSERT((froozenRules), "rules not froozen");
-        auto it = lupTables.find(name);
-        if (it == lupTables.end())
-            return NULL;
-        if (it->second->size() == 0)
-            return NULL;
-        auto records=it->second->find(featureTypeCode);
-        if (records == it->second->end()){
+        auto it = lupSelectors.find(selectorKey(name, featureTypeCode));
+        if (it == lupSelectors.end())
             return NULL;
-        }
-        const LUPrec *noAttrMatch = nullptr;
-        const LUPrec *bestMatch = nullptr;
-        int score = 0;
-        for (auto &lui : *(records->second))
-        {
-            // 1st try: exactly matching attributes
-            // 2nd try: LUP with no attributes
-
-            if (lui.ATTCArray.size() == 0 && noAttrMatch == nullptr)
-            {
-                noAttrMatch = &lui;
-                continue;
-            }
-            int nScore = lui.attributeMatch(attributes);
-            if (nScore > score)
-            {
-                score = nScore;
-                bestMatch = &lui;
-            }
-        }
-        if (bestMatch)
-        {
-            return bestMatch;
-        }
-        return noAttrMatch;
+        bool cacheHit = false;
+        const LUPrec *rt = it->second->find(attributes, cacheHit);
+        if (cacheHit)
+            lupCacheHits++;
+        else
+            lupCacheMisses++;
+        return rt;
     }
     void S52Data::addColorTable(const ColorTable &table)
     {
@@ -391,12 +544,112 @@ namespace s52
             {
                 for (auto &lup:*lupRecords){
                     createRulesForLup(lup);
+                    lup.parseConditions();
                 }
+                lupSelectors[selectorKey(n, k)] = std::make_shared<LUPSelector>(*lupRecords);
             }
         }
         LOG_DEBUG("finish building rules");
         froozenRules = true;
     }
+    const Rule *S52Data::internRule(const LUPrec *lup, RenderStep rs, const String &ruleStr, bool &interned) const
+    {
+        AVASSERT((froozenRules), "rules not froozen");
+        String key;
+        key.reserve(ruleStr.size() + 1);
+        key.push_back((char)rs);
+        key.append(ruleStr);
+        Synchronized l(internLock);
+        auto it = internedRules.find(key);
+        if (it != internedRules.end())
+        {
+            interned = true;
+            internHits++;
+            return it->second;
+        }
+        if (internedRules.size() >= MAX_INTERNED_RULES)
+        {
+            interned = false;
+            return nullptr;
+        }
+        //our pool and creator are only used under the lock after the rules are frozen
+        const Rule *rt = ruleCreator->createRule(lup, rs, ruleStr, this);
+        internedRules[key] = rt;
+        interned = true;
+        return rt;
+    }
+    bool S52Data::internRules(const LUPrec *lup, RenderStep rs, const String &ruleStr, CondRuleList &rules) const
+    {
+        StringVector topRules = StringHelper::split(ruleStr, "\037");
+        for (auto &&topRule : topRules)
+        {
+            StringVector strRules = StringHelper::split(topRule, ";");
+            for (auto &&sRule : strRules)
+            {
+                if (sRule.empty())
+                    continue;
+                bool interned = false;
+                const Rule *rule = internRule(lup, rs, sRule, interned);
+                if (!interned)
+                    return false;
+                if (rule)
+                    rules.push_back(rule);
+            }
+        }
+        return true;
+    }
+    bool S52Data::expandCondRule(const LUPrec *lup, const String &rule, const RuleConditions *conditions, std::function<void(const Rule *)> writer) const
+    {
+        if (!froozenRules)
+            return false;
+        String key;
+        key.push_back((char)lup->step);
+        if (!S52CondRules::cacheKey(lup, rule, this, conditions, key))
+            return false;
+        {
+            Synchronized l(condLock);
+            auto it = condRuleLists.find(key);
+            if (it != condRuleLists.end())
+            {
+                condHits++;
+                for (auto r : it->second)
+                    writer(r);
+                return true;
+            }
+        }
+        condMisses++;
+        //the procedure result does not depend on the step
+        String procKey = key.substr(1);
+        String expanded;
+        if (!condCache->get(procKey, expanded))
+        {
+            try
+            {
+                expanded = S52CondRules::expand(lup, rule, this, conditions);
+            }
+            catch (AvException &e)
+            {
+                LOG_DEBUG("exception expanding rule %s:%s", rule, e.what());
+                return false;
+            }
+            condCache->add(procKey, expanded);
+        }
+        CondRuleList rules;
+        if (!internRules(lup, lup->step, expanded, rules))
+            return false;
+        for (auto r : rules)
+            writer(r);
+        Synchronized l(condLock);
+        if (condRuleLists.size() < MAX_COND_RULE_LISTS)
+        {
+            condRuleLists.emplace(key, std::move(rules));
+        }
+        return true;
+    }
+    void S52Data::shareCondCache(const S52Data &other)
+    {
+        condCache = other.condCache;
+    }
     RGBColor S52Data::getColor(const String &color) const
     {
         String tableName = getColorTableName(renderSettings);
@@ -497,6 +750,46 @@ namespace s52
         rt = symbolCache->getSymbol("QUESMRK1", getColorFunction, rotation, scale);
         return rt;
     }
+    SymbolCache::Handle S52Data::getSymbolHandle(const String &name) const
+    {
+        AVASSERT(froozenSymbols, "symbols not frozen");
+        return symbolCache->getHandle(name);
+    }
+    const SymbolPtr S52Data::getSymbol(const SymbolCache::Handle &handle, int rotation, double scale) const
+    {
+        AVASSERT(froozenSymbols, "symbols not frozen");
+        SymbolCache::GetColorFunction getColorFunction = [this](const String &name)
+        {
+            RGBColor c = this->getColor(name);
+            return DrawingContext::convertColor(c.R, c.G, c.B);
+        };
+        SymbolPtr rt = symbolCache->getSymbol(handle, getColorFunction, rotation, scale);
+        if (rt)
+            return rt;
+        rt = symbolCache->getSymbol("QUESMRK1", getColorFunction, rotation, scale);
+        return rt;
+    }
+    uint32_t S52Data::getCommandSymbolIndex(SymbolPtr symbol) const
+    {
+        if (!symbol)
+            return NO_COMMAND_INDEX;
+        return commandSymbols.add(symbol.get(), symbol);
+    }
+    const SymbolData *S52Data::getCommandSymbol(uint32_t index) const
+    {
+        const SymbolPtr *rt = commandSymbols.get(index);
+        if (!rt)
+            return nullptr;
+        return rt->get();
+    }
+    uint32_t S52Data::getCommandSymbolHandleIndex(const String &name) const
+    {
+        return commandSymbolHandles.add(name, getSymbolHandle(name));
+    }
+    const SymbolCache::Handle *S52Data::getCommandSymbolHandle(uint32_t index) const
+    {
+        return commandSymbolHandles.get(index);
+    }
     String S52Data::checkSymbol(const String &name) const
     {
         AVASSERT(froozenSymbols, "symbols not frozen");
@@ -512,6 +805,22 @@ namespace s52
         {
             stream["numRasterSymbols"] = symbolMap.size();
         }
+        {
+            Synchronized l(internLock);
+            stream["internedRules"] = (int)internedRules.size();
+        }
+        stream["internHits"] = (long)internHits;
+        {
+            Synchronized l(condLock);
+            stream["condRuleLists"] = (int)condRuleLists.size();
+        }
+        stream["condHits"] = (long)condHits;
+        stream["condMisses"] = (long)condMisses;
+        condCache->ToJson(stream);
+        stream["lupCacheHits"] = (long)lupCacheHits;
+        stream["lupCacheMisses"] = (long)lupCacheMisses;
+        stream["commandSymbols"] = (int)commandSymbols.size();
+        stream["commandSymbolHandles"] = (int)commandSymbolHandles.size();
         return true;
     }
     double S52Data::convertSounding(double valMeters, uint16_t attrid) const
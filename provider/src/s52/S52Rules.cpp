@@ -36,6 +36,9 @@ namespace s52
     void RuleCreator::rulesFromString(const LUPrec *lup, const String &ruleStr, const S52Data *s52data, std::function<void (const s52::Rule *)> writer, bool tryExpansion, const RuleConditions *conditions)
     {
         RenderStep rs=lup->step;
+        //after the rules have been built we share the rules
+        //between all charts
+        bool intern=s52data != nullptr && s52data->rulesFrozen();
         StringVector topRules = StringHelper::split(ruleStr, "\037");
         for (auto pRule = topRules.begin(); pRule != topRules.end(); pRule++)
         {
@@ -46,105 +49,100 @@ namespace s52
                     continue;
                 }
                 //LOG_DEBUG("LUP %d:parsing rule %s, num %ld",lup->RCID, ruleStr,rules.size());
-                StringVector nv = StringHelper::split(*sRule, "(",1);
-                if (nv.size() != 2)
+                if (tryExpansion && StringHelper::startsWith(*sRule,"CS("))
                 {
-                    LOG_DEBUG("%d:%s invalid rule", lup->RCID, *sRule);
-                    continue;
-                }
-                try
-                {
-                    StringHelper::rtrimI(nv[1], ')');
-                    if (nv[0] == "CS")
-                    {
-                        if (tryExpansion)
-                        {
-                            String expanded = S52CondRules::expand(lup, *sRule, s52data, conditions);
-                            rulesFromString(lup, expanded, s52data, writer, false);
-                        }
-                        else
-                        {
-                            const CondRule *rule = create<CondRule>(rs,*sRule);
-                            writer(rule);
-                        }
-                        continue;
-                    }
-                    if (nv[0] == "AC")
-                    {
-                        const AreaRule *r = create<AreaRule>(rs,nv[1], s52data->getColor(StringHelper::beforeFirst(nv[1],",",true)));
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == "AP")
-                    {
-                        SymbolPtr symbol=s52data->getSymbol(PT_PREFIX+nv[1]);
-                        const SymAreaRule *r=create<SymAreaRule>(rs,nv[1],symbol);
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == "SY")
-                    {
-                        const SymbolRule *r = create<SymbolRule>(rs,nv[1], s52data->checkSymbol(nv[1]));
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == "TE")
-                    {
-                        StringVector parts=StringHelper::split(nv[1],",");
-                        StringOptions options=S52TextParser::parseStringOptions(s52data,parts,2);
-                        const StringTERule *r = create<StringTERule>(rs,nv[1],options);
-                        writer(r);
+                    if (intern && s52data->expandCondRule(lup,*sRule,conditions,writer)){
                         continue;
                     }
-                    if (nv[0] == "TX")
-                    {
-                        StringVector parts=StringHelper::split(nv[1],",");
-                        StringOptions options=S52TextParser::parseStringOptions(s52data,parts,1);
-                        const StringTXRule *r = create<StringTXRule>(rs,nv[1],options);
-                        writer(r);
-                        continue;
+                    try{
+                        String expanded = S52CondRules::expand(lup, *sRule, s52data, conditions);
+                        rulesFromString(lup, expanded, s52data, writer, false);
                     }
-                    if (nv[0] == "MP")
+                    catch (AvException &e)
                     {
-                        StringVector parts=StringHelper::split(nv[1],",");
-                        const SoundingRule *r = create<SoundingRule>(rs,nv[1]);
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == PrivateRules::PR_SOUND()){
-                        const SingleSoundingRule *r=create<SingleSoundingRule>(rs,nv[1]);
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == PrivateRules::PR_LIGHT()){
-                        const CARule *r=create<CARule>(rs,nv[1]);
-                        writer(r);
-                        continue;
+                        LOG_DEBUG("exception expanding rule %s:%s", *sRule, e.what());
                     }
-                    if (nv[0] == PrivateRules::PR_CAT()){
-                        const DisCatRule *r=create<DisCatRule>(rs,nv[1]);
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == "LS"){
-                        const SimpleLineRule *r=create<SimpleLineRule>(rs,nv[1]);
-                        writer(r);
-                        continue;
-                    }
-                    if (nv[0] == "LC"){
-                        String symName=LS_PREFIX+nv[1];
-                        const SymbolLineRule *r = create<SymbolLineRule>(rs,nv[1],s52data->checkSymbol(symName));
-                        writer(r);
-                        continue;
-                    }
-                    LOG_DEBUG("unknown rule %s",*sRule);
+                    continue;
                 }
-                catch (AvException &e)
-                {
-                    LOG_DEBUG("exception parsing rule %s(%s):%s", nv[0],nv[1], e.what());
+                const Rule *rule=nullptr;
+                bool interned=false;
+                if (intern){
+                    rule=s52data->internRule(lup,rs,*sRule,interned);
+                }
+                if (! interned){
+                    rule=createRule(lup,rs,*sRule,s52data);
                 }
+                if (rule) writer(rule);
             }
         }
         return;
     }
+    const Rule * RuleCreator::createRule(const LUPrec *lup, RenderStep rs, const String &sRule, const S52Data *s52data)
+    {
+        StringVector nv = StringHelper::split(sRule, "(",1);
+        if (nv.size() != 2)
+        {
+            LOG_DEBUG("%d:%s invalid rule", lup->RCID, sRule);
+            return nullptr;
+        }
+        try
+        {
+            StringHelper::rtrimI(nv[1], ')');
+            if (nv[0] == "CS")
+            {
+                return create<CondRule>(rs,sRule);
+            }
+            if (nv[0] == "AC")
+            {
+                return create<AreaRule>(rs,nv[1], s52data->getColor(StringHelper::beforeFirst(nv[1],",",true)));
+            }
+            if (nv[0] == "AP")
+            {
+                SymbolPtr symbol=s52data->getSymbol(PT_PREFIX+nv[1]);
+                return create<SymAreaRule>(rs,nv[1],symbol);
+            }
+            if (nv[0] == "SY")
+            {
+                return create<SymbolRule>(rs,nv[1], s52data->checkSymbol(nv[1]));
+            }
+            if (nv[0] == "TE")
+            {
+                StringVector parts=StringHelper::split(nv[1],",");
+                StringOptions options=S52TextParser::parseStringOptions(s52data,parts,2);
+                return create<StringTERule>(rs,nv[1],options);
+            }
+            if (nv[0] == "TX")
+            {
+                StringVector parts=StringHelper::split(nv[1],",");
+                StringOptions options=S52TextParser::parseStringOptions(s52data,parts,1);
+                return create<StringTXRule>(rs,nv[1],options);
+            }
+            if (nv[0] == "MP")
+            {
+                return create<SoundingRule>(rs,nv[1]);
+            }
+            if (nv[0] == PrivateRules::PR_SOUND()){
+                return create<SingleSoundingRule>(rs,nv[1]);
+            }
+            if (nv[0] == PrivateRules::PR_LIGHT()){
+                return create<CARule>(rs,nv[1]);
+            }
+            if (nv[0] == PrivateRules::PR_CAT()){
+                return create<DisCatRule>(rs,nv[1]);
+            }
+            if (nv[0] == "LS"){
+                return create<SimpleLineRule>(rs,nv[1]);
+            }
+            if (nv[0] == "LC"){
+                String symName=LS_PREFIX+nv[1];
+                return create<SymbolLineRule>(rs,nv[1],s52data->checkSymbol(symName));
+            }
+            LOG_DEBUG("unknown rule %s",sRule);
+        }
+        catch (AvException &e)
+        {
+            LOG_DEBUG("exception parsing rule %s(%s):%s", nv[0],nv[1], e.what());
+        }
+        return nullptr;
+    }
 }
@@ -544,31 +544,36 @@ namespace s52{
     };
 
 
-    SymbolPtr SymbolCache::getSymbol(const String &name,SymbolCache::GetColorFunction colorGet, int rotation,double scale){
-        SymbolBase::Ptr rt;
+    SymbolCache::Handle SymbolCache::getHandle(const String &name){
+        Handle rt;
+        Synchronized locker(lock);
+        BaseMap::const_iterator it;
+        size_t p = name.find(",");
+        if (p != String::npos)
         {
-            Synchronized locker(lock);
-            BaseMap::const_iterator it;
-            size_t p = name.find(",");
-            if (p != String::npos)
-            {
-                it = baseMap.find(name.substr(0, p));
-            }
-            else
-            {
-                it = baseMap.find(name);
-            }
-            if (it == baseMap.end())
-                return SymbolPtr();
-            rt=it->second;    
+            it = baseMap.find(name.substr(0, p));
         }
+        else
+        {
+            it = baseMap.find(name);
+        }
+        if (it == baseMap.end())
+            return rt;
+        rt.base=it->second;
+        return rt;
+    }
+    SymbolPtr SymbolCache::getSymbol(const String &name,SymbolCache::GetColorFunction colorGet, int rotation,double scale){
+        return getSymbol(getHandle(name),colorGet,rotation,scale);
+    }
+    SymbolPtr SymbolCache::getSymbol(const SymbolCache::Handle &handle,SymbolCache::GetColorFunction colorGet, int rotation,double scale){
+        if (! handle.valid()) return SymbolPtr();
         SymbolBase::CreateParam param;
         param.scaleTolerance=scaleTolerance;
         param.rotationTolerance=rotationTolerance;
         uint64_t addedBytes=0;
-        SymbolPtr prt=rt->getOrCreate(colorGet, addedBytes, param,rotation,scale);
+        SymbolPtr prt=handle.base->getOrCreate(colorGet, addedBytes, param,rotation,scale);
         if (addedBytes) {
-            memUsage+=addedBytes;
+            *memUsage+=addedBytes;
             symbolEntries+=1;
         }
         return prt;
@@ -711,10 +716,11 @@ namespace s52{
                 LOG_ERROR("raster symbol %s already in cache",name);
                 removedBytes=it->second->numBytes();
             }
+            base->baseSymbol->memCounter=memUsage; //inherited by all derived symbols
             baseMap[name]=base;
             //rough estimate - ignoring mem usage of base map
-            memUsage-=removedBytes;
-            memUsage+=base->numBytes();
+            *memUsage-=removedBytes;
+            *memUsage+=base->numBytes();
         }
         return true;
     }
@@ -736,10 +742,11 @@ namespace s52{
                 LOG_ERROR("vector symbol %s already in cache",name);
                 removedBytes=it->second->numBytes();
             }
+            base->baseSymbol->memCounter=memUsage; //inherited by all derived symbols
             baseMap[name]=base;
             //rough estimate - ignoring mem usage of base map
-            memUsage-=removedBytes;
-            memUsage+=base->numBytes();
+            *memUsage-=removedBytes;
+            *memUsage+=base->numBytes();
         }
         return true;
 
@@ -752,6 +759,6 @@ namespace s52{
         Synchronized locker(lock);
         stream["baseSymbols"]=baseMap.size();
         stream["derivedSymbols"]=symbolEntries.load();
-        stream["memkb"]=memUsage.load()/1000;
+        stream["memkb"]=memUsage->load()/1000;
     };
 }
\ No newline at end of file
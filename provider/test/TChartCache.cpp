@@ -26,6 +26,7 @@
  */
 #include <gtest/gtest.h>
 #include <functional>
+#include <stdlib.h>
 #include "SimpleThread.h"
 #include "TestHelper.h"
 #include "ChartCache.h"
@@ -98,7 +99,14 @@ public:
     }
 };
 
-static SettingsManager *settings=new SettingsManager(".",[](json::JSON &,const String &)->bool{return false;});
+//the settings manager writes its files - keep them out of the source tree
+static String settingsDir(){
+    char tmpl[]="/tmp/avtestXXXXXX";
+    char *dir=mkdtemp(tmpl);
+    if (dir == nullptr) return String(".");
+    return String(dir);
+}
+static SettingsManager *settings=new SettingsManager(settingsDir(),[](json::JSON &,const String &)->bool{return false;});
 
 class TS52Data : public s52::S52Data{
     public:
@@ -133,7 +141,7 @@ class OpenWaitChart: public Chart{
             Timer::microSleep(waitMillis*1000);
             return true;
         }
-        virtual bool PrepareRender(s52::S52Data::ConstPtr s52data) override{
+        virtual bool PrepareRender(s52::S52Data::ConstPtr s52data, WorkerPool::Ptr workers=WorkerPool::Ptr()) override{
             md5=s52data->getMD5();
             return true;
         }
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test ChartIndex
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include "TestHelper.h"
+#include "ChartIndex.h"
+#include "Coordinates.h"
+
+static std::vector<ChartInfo::Ptr> createCharts(int num, unsigned int seed){
+    std::vector<ChartInfo::Ptr> rt;
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> lon(-20,20);
+    std::uniform_real_distribution<double> lat(30,60);
+    std::uniform_real_distribution<double> size(0.01,3);
+    std::uniform_int_distribution<int> scale(1000,3000000);
+    for (int i=0;i<num;i++){
+        Coord::LLBox e;
+        e.w_lon=lon(gen);
+        e.e_lon=e.w_lon+size(gen);
+        e.s_lat=lat(gen);
+        e.n_lat=e.s_lat+size(gen);
+        rt.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,FMT("c%d.oesu",i),scale(gen),e.toWorld(),false));
+    }
+    return rt;
+}
+
+static WeightedChartList linearFind(const std::vector<ChartInfo::Ptr> &charts, const Coord::Extent &ext, double minScale, double maxScale){
+    WeightedChartList rt;
+    for (const auto &info: charts){
+        int scale=info->HasTile(ext);
+        if (scale <= 0 || scale < minScale || scale >= maxScale) continue;
+        rt.push_back(ChartInfoWithScale(scale,info));
+    }
+    return rt;
+}
+
+static void compare(const WeightedChartList &expected, const WeightedChartList &found){
+    ASSERT_EQ(expected.size(),found.size());
+    for (size_t i=0;i<expected.size();i++){
+        EXPECT_EQ(expected[i].info,found[i].info) << "at index " << i;
+        EXPECT_EQ(expected[i].scale,found[i].scale) << "at index " << i;
+    }
+}
+
+TEST(ChartIndex,empty){
+    std::vector<ChartInfo::Ptr> charts;
+    ChartIndex index(charts);
+    Coord::Extent ext=Coord::tileToBox(10,548,328);
+    EXPECT_EQ(index.Find(ext).size(),0);
+}
+
+TEST(ChartIndex,sameAsLinear){
+    std::vector<ChartInfo::Ptr> charts=createCharts(2000,4711);
+    ChartIndex index(charts);
+    EXPECT_EQ(index.GetNumCharts(),charts.size());
+    EXPECT_GT(index.GetDepth(),1);
+    for (int zoom=4;zoom<=12;zoom+=2){
+        for (int i=0;i<20;i++){
+            Coord::WorldXy wp=Coord::latLonToWorld(30+i*1.5,-20+i*2);
+            Coord::TileBox box=Coord::tileToBox(Coord::worldPointToTile(wp,zoom));
+            compare(linearFind(charts,box,0,ChartIndex::NO_MAX_SCALE),index.Find(box));
+        }
+    }
+}
+
+TEST(ChartIndex,scaleWindow){
+    std::vector<ChartInfo::Ptr> charts=createCharts(1000,815);
+    ChartIndex index(charts);
+    Coord::LLBox e;
+    e.w_lon=-5;
+    e.e_lon=5;
+    e.s_lat=40;
+    e.n_lat=50;
+    Coord::Extent ext=e.toWorld();
+    WeightedChartList all=index.Find(ext);
+    EXPECT_GT(all.size(),0);
+    WeightedChartList windowed=index.Find(ext,50000,500000);
+    compare(linearFind(charts,ext,50000,500000),windowed);
+    EXPECT_LT(windowed.size(),all.size());
+    for (const auto &c:windowed){
+        EXPECT_GE(c.scale,50000);
+        EXPECT_LT(c.scale,500000);
+    }
+}
+
+TEST(ChartIndex,skipInvalid){
+    std::vector<ChartInfo::Ptr> charts=createCharts(10,1);
+    charts.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,"invalid.oesu"));
+    Coord::LLBox e;
+    e.w_lon=-20;
+    e.e_lon=20;
+    e.s_lat=30;
+    e.n_lat=60;
+    charts.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,"ignored.oesu",1000,e.toWorld(),false,true));
+    ChartIndex index(charts);
+    EXPECT_EQ(index.GetNumCharts(),10);
+    compare(linearFind(std::vector<ChartInfo::Ptr>(charts.begin(),charts.begin()+10),e.toWorld(),0,ChartIndex::NO_MAX_SCALE),
+        index.Find(e.toWorld()));
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test Chart Info Cache
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <filesystem.hpp>
+#include <fstream>
+#include "TestHelper.h"
+#include "ChartInfoCache.h"
+#include "FileHelper.h"
+#include "Coordinates.h"
+
+#define FSNS ghc::filesystem
+
+class ChartInfoCacheTest : public ::testing::Test {
+    protected:
+        FSNS::path dir;
+        void SetUp() override{
+            dir=FSNS::temp_directory_path() / FMT("chartInfoCache%d",(int)getpid());
+            FSNS::remove_all(dir);
+            FSNS::create_directories(dir);
+        }
+        void TearDown() override{
+            FSNS::remove_all(dir);
+        }
+        String createChart(const String &name, const String &content){
+            String fn=(dir / name).string();
+            std::ofstream s(fn);
+            s << content;
+            return fn;
+        }
+};
+
+TEST_F(ChartInfoCacheTest,roundTrip){
+    Coord::LLBox box;
+    box.w_lon=10;
+    box.e_lon=11;
+    box.s_lat=54;
+    box.n_lat=55;
+    Coord::Extent extent=box.toWorld();
+    String c1=createChart("c1.oesu","chart1");
+    String c2=createChart("c2.oesu","chart2");
+    ChartSet::InfoList charts;
+    charts.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,c1,22000,extent,true));
+    charts.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,c2,50000,extent,false,true));
+    charts.push_back(std::make_shared<ChartInfo>(Chart::ChartType::OESU,(dir / "c3.oesu").string())); //invalid
+    String cacheFile=(dir / (String("test")+ChartInfoCache::EXTENSION)).string();
+    ChartInfoCache writer(cacheFile);
+    EXPECT_FALSE(writer.Read());
+    EXPECT_TRUE(writer.Write(charts));
+    ChartInfoCache reader(cacheFile);
+    EXPECT_TRUE(reader.Read());
+    EXPECT_EQ(reader.GetNumEntries(),2);
+    ChartInfo::Ptr r1=reader.Find(c1);
+    ASSERT_TRUE((bool)r1);
+    EXPECT_TRUE(r1->IsValid());
+    EXPECT_EQ(r1->GetNativeScale(),22000);
+    EXPECT_EQ(r1->GetType(),Chart::ChartType::OESU);
+    EXPECT_TRUE(r1->HasSoftUnder());
+    EXPECT_FALSE(r1->IsIgnored());
+    EXPECT_EQ(r1->GetExtent().xmin,extent.xmin);
+    EXPECT_EQ(r1->GetExtent().ymax,extent.ymax);
+    EXPECT_TRUE(r1->GetExtent().valid);
+    ChartInfo::Ptr r2=reader.Find(c2);
+    ASSERT_TRUE((bool)r2);
+    EXPECT_TRUE(r2->IsIgnored());
+    EXPECT_FALSE(reader.Find((dir / "c3.oesu").string()));
+    //changed size
+    createChart("c2.oesu","chart2 changed");
+    EXPECT_FALSE(reader.Find(c2));
+    EXPECT_TRUE((bool)reader.Find(c1));
+}
+
+TEST_F(ChartInfoCacheTest,invalidFile){
+    String cacheFile=createChart(String("test")+ChartInfoCache::EXTENSION,"AVCIgarbage");
+    ChartInfoCache reader(cacheFile);
+    EXPECT_FALSE(reader.Read());
+    EXPECT_EQ(reader.GetNumEntries(),0);
+}
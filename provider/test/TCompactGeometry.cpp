@@ -0,0 +1,89 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test compact geometry
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "CompactGeometry.h"
+#include "TestHelper.h"
+#include <vector>
+
+static std::vector<Coord::WorldXy> readBack(const CompactGeometry &g,uint32_t offset, size_t num){
+    std::vector<Coord::WorldXy> rt;
+    CompactGeometry::Reader reader(g,offset);
+    for (size_t i=0;i<num;i++){
+        rt.push_back(reader.next());
+    }
+    return rt;
+}
+
+TEST(CompactGeometry,smallDeltas){
+    std::unique_ptr<ocalloc::Pool> pool(ocalloc::makePool("test"));
+    CompactGeometry g(pool);
+    g.setOrigin(Coord::WorldXy(100000,200000));
+    std::vector<Coord::WorldXy> points({
+        {100010,200020},
+        {100000,199000},
+        {132000,180000}
+    });
+    uint32_t offset=g.startSequence();
+    for (const auto &p:points) g.add(p);
+    g.finish();
+    EXPECT_EQ(g.sizeBytes(),points.size()*2*sizeof(CompactGeometry::Word));
+    auto result=readBack(g,offset,points.size());
+    for (size_t i=0;i<points.size();i++){
+        EXPECT_EQ(result[i].x,points[i].x) << "index " << i;
+        EXPECT_EQ(result[i].y,points[i].y) << "index " << i;
+    }
+}
+TEST(CompactGeometry,largeDeltas){
+    std::unique_ptr<ocalloc::Pool> pool(ocalloc::makePool("test"));
+    CompactGeometry g(pool);
+    g.setOrigin(Coord::WorldXy(0,0));
+    std::vector<Coord::WorldXy> first({
+        {1,-1},
+        {INT32_MAX,INT32_MIN},
+        {INT32_MIN,INT32_MAX},
+        {-32768,32767}
+    });
+    std::vector<Coord::WorldXy> second({
+        {5,7},
+        {40000,-40000}
+    });
+    uint32_t o1=g.startSequence();
+    for (const auto &p:first) g.add(p);
+    uint32_t o2=g.startSequence();
+    for (const auto &p:second) g.add(p);
+    //sequences are independent
+    auto r2=readBack(g,o2,second.size());
+    auto r1=readBack(g,o1,first.size());
+    for (size_t i=0;i<first.size();i++){
+        EXPECT_EQ(r1[i].x,first[i].x) << "index " << i;
+        EXPECT_EQ(r1[i].y,first[i].y) << "index " << i;
+    }
+    for (size_t i=0;i<second.size();i++){
+        EXPECT_EQ(r2[i].x,second[i].x) << "index " << i;
+        EXPECT_EQ(r2[i].y,second[i].y) << "index " << i;
+    }
+}
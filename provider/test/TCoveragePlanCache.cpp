@@ -0,0 +1,71 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test CoveragePlanCache
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "TestHelper.h"
+#include "CoveragePlanCache.h"
+
+static CoveragePlan::ConstPtr createPlan(int setSequence, const MD5Name &md5){
+    auto rt=std::make_shared<CoveragePlan>();
+    rt->setSequence=setSequence;
+    rt->settingsMd5=md5;
+    return rt;
+}
+
+TEST(CoveragePlanCache,hitAndGeneration){
+    CoveragePlanCache cache(100);
+    MD5Name md5=MD5::Compute("settings1");
+    TileInfo tile(10,548,328,"set1");
+    CoveragePlanCache::Key key(tile,false);
+    EXPECT_FALSE(cache.Get(key,1,md5));
+    CoveragePlan::ConstPtr plan=createPlan(1,md5);
+    cache.Add(key,plan);
+    EXPECT_EQ(cache.Get(key,1,md5),plan);
+    EXPECT_FALSE(cache.Get(key,2,md5)) << "set sequence changed";
+    EXPECT_FALSE(cache.Get(key,1,MD5::Compute("settings2"))) << "settings changed";
+    EXPECT_FALSE(cache.Get(CoveragePlanCache::Key(tile,true),1,md5)) << "allLower differs";
+    EXPECT_FALSE(cache.Get(CoveragePlanCache::Key(TileInfo(10,548,328,"set2"),false),1,md5)) << "other set";
+    CoveragePlan::ConstPtr newer=createPlan(2,md5);
+    cache.Add(key,newer);
+    EXPECT_EQ(cache.Get(key,2,md5),newer);
+    cache.Clear();
+    EXPECT_FALSE(cache.Get(key,2,md5));
+}
+
+TEST(CoveragePlanCache,limit){
+    CoveragePlanCache cache(CoveragePlanCache::NUM_SHARDS*2);
+    MD5Name md5=MD5::Compute("settings1");
+    for (int x=0;x<1000;x++){
+        cache.Add(CoveragePlanCache::Key(TileInfo(10,x,328,"set1"),false),createPlan(1,md5));
+    }
+    int found=0;
+    for (int x=0;x<1000;x++){
+        if (cache.Get(CoveragePlanCache::Key(TileInfo(10,x,328,"set1"),false),1,md5)) found++;
+    }
+    EXPECT_LE(found,CoveragePlanCache::NUM_SHARDS*2);
+    EXPECT_GT(found,0);
+    EXPECT_TRUE(cache.Get(CoveragePlanCache::Key(TileInfo(10,999,328,"set1"),false),1,md5)) << "last one must be there";
+}
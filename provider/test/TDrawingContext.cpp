@@ -26,6 +26,7 @@
  */
 #include <gtest/gtest.h>
 #include "DrawingContext.h"
+#include "HitTestContext.h"
 #include "Coordinates.h"
 #include "TestHelper.h"
 
@@ -233,4 +234,146 @@ TEST(BasicDrawingContext,DrawArcOutlineRange){
     EXPECT_EQ(*ctx->pixel(100,55),c);
     EXPECT_EQ(*ctx->pixel(100,74),c);
     EXPECT_EQ(*ctx->pixel(74,100),c);
-}
\ No newline at end of file
+}
+
+TEST(BasicDrawingContext,TriangleOutside){
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    ctx->drawTriangle(Coord::PixelXy(-100,10),Coord::PixelXy(-10,10),Coord::PixelXy(-50,200),c);
+    ctx->drawTriangle(Coord::PixelXy(10,300),Coord::PixelXy(200,300),Coord::PixelXy(100,400),c);
+    EXPECT_EQ(ctx->triUnhitCount,2);
+    EXPECT_EQ(ctx->triHitCount,0);
+    EXPECT_EQ(*ctx->pixel(0,10),0);
+    EXPECT_EQ(*ctx->pixel(100,255),0);
+}
+TEST(BasicDrawingContext,TriangleCoversAll){
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    EXPECT_TRUE(ctx->coversAll(Coord::PixelXy(-10,-10),Coord::PixelXy(1000,-10),Coord::PixelXy(-10,1000)));
+    EXPECT_TRUE(ctx->coversAll(Coord::PixelXy(-10,-10),Coord::PixelXy(-10,1000),Coord::PixelXy(1000,-10)));
+    EXPECT_FALSE(ctx->coversAll(Coord::PixelXy(-10,-10),Coord::PixelXy(300,-10),Coord::PixelXy(-10,300)));
+    EXPECT_FALSE(ctx->coversAll(Coord::PixelXy(0,0),Coord::PixelXy(1000,0),Coord::PixelXy(0,1000)));
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    ctx->fillAll(c);
+    EXPECT_EQ(*ctx->pixel(0,0),c);
+    EXPECT_EQ(*ctx->pixel(255,255),c);
+    EXPECT_EQ(ctx->fillCount,1);
+}
+TEST(BasicDrawingContext,PolygonTriangles){
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    DrawingContext::EdgeTable edges;
+    //a square from 2 triangles with different orientation
+    edges.addTriangle(Coord::PixelXy(10,10),Coord::PixelXy(100,10),Coord::PixelXy(100,100));
+    edges.addTriangle(Coord::PixelXy(10,10),Coord::PixelXy(10,100),Coord::PixelXy(100,100));
+    ctx->drawPolygon(edges,c);
+    EXPECT_EQ(*ctx->pixel(10,10),c);
+    EXPECT_EQ(*ctx->pixel(100,10),c);
+    EXPECT_EQ(*ctx->pixel(55,55),c);
+    EXPECT_EQ(*ctx->pixel(99,99),c);
+    EXPECT_EQ(*ctx->pixel(9,50),0);
+    EXPECT_EQ(*ctx->pixel(101,50),0);
+    EXPECT_EQ(*ctx->pixel(50,9),0);
+    EXPECT_EQ(*ctx->pixel(50,100),0);
+}
+TEST(BasicDrawingContext,PolygonReuseEdgeTable){
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::ColorAndAlpha c1=DrawingContext::convertColor(255,255,0);
+    DrawingContext::ColorAndAlpha c2=DrawingContext::convertColor(0,255,255);
+    DrawingContext::EdgeTable &edges=ctx->getEdgeTable();
+    edges.addTriangle(Coord::PixelXy(10,10),Coord::PixelXy(100,10),Coord::PixelXy(100,100));
+    ctx->drawPolygon(edges,c1);
+    DrawingContext::EdgeTable &next=ctx->getEdgeTable();
+    EXPECT_TRUE(next.empty());
+    next.addTriangle(Coord::PixelXy(150,150),Coord::PixelXy(200,150),Coord::PixelXy(200,200));
+    ctx->drawPolygon(next,c2);
+    EXPECT_EQ(*ctx->pixel(90,20),c1);
+    EXPECT_EQ(*ctx->pixel(190,160),c2);
+    EXPECT_EQ(*ctx->pixel(120,120),0);
+}
+TEST(BasicDrawingContext,PolygonOutline){
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    DrawingContext::EdgeTable edges;
+    //outer ring clipped by the context, inner ring with the opposite direction
+    Coord::PixelXy outer[4]={Coord::PixelXy(-20,-20),Coord::PixelXy(300,-20),Coord::PixelXy(300,300),Coord::PixelXy(-20,300)};
+    Coord::PixelXy inner[4]={Coord::PixelXy(50,50),Coord::PixelXy(50,150),Coord::PixelXy(150,150),Coord::PixelXy(150,50)};
+    for (int i=0;i<4;i++){
+        edges.addEdge(outer[i],outer[(i+1)%4]);
+        edges.addEdge(inner[i],inner[(i+1)%4]);
+    }
+    ctx->drawPolygon(edges,c);
+    EXPECT_EQ(*ctx->pixel(0,0),c);
+    EXPECT_EQ(*ctx->pixel(255,255),c);
+    EXPECT_EQ(*ctx->pixel(40,100),c);
+    EXPECT_EQ(*ctx->pixel(100,100),0);
+    EXPECT_EQ(*ctx->pixel(160,100),c);
+}
+TEST(BasicDrawingContext,PatternFill){
+    //3x2 symbol, distance 4, staggered rows
+    DrawingContext::ColorAndAlpha symbol[6];
+    for (int i=0;i<6;i++) symbol[i]=DrawingContext::convertColor(10*i+10,0,0);
+    DrawingContext::PatternTexture texture(symbol,3,2,4,true);
+    EXPECT_EQ(texture.width,7);
+    EXPECT_EQ(texture.height,12);
+    EXPECT_EQ(texture.rows[0].first,0);
+    EXPECT_EQ(texture.rows[0].last,2);
+    EXPECT_EQ(texture.rows[6].first,3);
+    EXPECT_EQ(texture.rows[6].last,5);
+    EXPECT_LT(texture.rows[2].last,texture.rows[2].first);
+    DrawingContext *ctx=DrawingContext::create(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::PatternSpec pattern(&texture);
+    pattern.xoffset=5;
+    pattern.yoffset=3;
+    ctx->fillAll(DrawingContext::convertColor(255,255,0),&pattern);
+    for (uint32_t y=0;y<Coord::TILE_SIZE;y++){
+        int ay=y+pattern.yoffset;
+        int sy=ay%6;
+        int shift=((ay/6)&1)?3:0;
+        for (uint32_t x=0;x<Coord::TILE_SIZE;x++){
+            int sx=(((x+pattern.xoffset-shift)%7)+7)%7;
+            DrawingContext::ColorAndAlpha expected=0;
+            if (sy < 2 && sx < 3) expected=symbol[sy*3+sx];
+            ASSERT_EQ(*ctx->pixel(x,y),expected) << "x=" << x << ", y=" << y;
+        }
+    }
+}
+TEST(HitTestContext,Polygon){
+    HitTestContext ctx(Coord::TILE_SIZE,Coord::TILE_SIZE);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    DrawingContext::EdgeTable edges;
+    edges.addTriangle(Coord::PixelXy(10,10),Coord::PixelXy(100,10),Coord::PixelXy(100,100));
+    ctx.drawPolygon(edges,c);
+    EXPECT_TRUE(ctx.getDrawn());
+    EXPECT_EQ(ctx.getBuffer(),nullptr);
+}
+TEST(HitTestContext,Lines){
+    HitTestContext ctx(10,10);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    ctx.drawLine(Coord::PixelXy(-20,-10),Coord::PixelXy(-5,30),c);
+    EXPECT_FALSE(ctx.getDrawn());
+    ctx.drawLine(Coord::PixelXy(-20,15),Coord::PixelXy(30,15),c);
+    EXPECT_FALSE(ctx.getDrawn());
+    ctx.drawThickLine(Coord::PixelXy(-20,12),Coord::PixelXy(30,12),c,false,nullptr,6);
+    EXPECT_TRUE(ctx.getDrawn());
+    ctx.resetDrawn();
+    ctx.drawLine(Coord::PixelXy(-20,-20),Coord::PixelXy(30,30),c);
+    EXPECT_TRUE(ctx.getDrawn());
+    ctx.resetDrawn();
+    ctx.drawAaLine(Coord::PixelXy(-20,5),Coord::PixelXy(30,7),c);
+    EXPECT_TRUE(ctx.getDrawn());
+    EXPECT_EQ(ctx.getBuffer(),nullptr);
+}
+TEST(HitTestContext,SymbolsAndArcs){
+    HitTestContext ctx(10,10);
+    DrawingContext::ColorAndAlpha c=DrawingContext::convertColor(255,255,0);
+    ctx.drawSymbol(Coord::PixelXy(-20,0),20,20,nullptr);
+    EXPECT_FALSE(ctx.getDrawn());
+    ctx.drawSymbol(Coord::PixelXy(-19,0),20,20,nullptr);
+    EXPECT_TRUE(ctx.getDrawn());
+    ctx.resetDrawn();
+    //circle around the context
+    ctx.drawArc(Coord::PixelXy(5,5),c,20);
+    EXPECT_FALSE(ctx.getDrawn());
+    ctx.drawArc(Coord::PixelXy(5,5),c,20,0);
+    EXPECT_TRUE(ctx.getDrawn());
+}
@@ -32,6 +32,7 @@
 #include "Timer.h"
 #include "SimpleThread.h"
 #include "TestHelper.h"
+#include "Osenc.h"
 #include <fcntl.h>
 #include <unistd.h>
 #include <limits.h>
@@ -503,3 +504,59 @@ TEST_F(FileSystem,listDirGlob){
     EXPECT_EQ(listed.size(),1);
     EXPECT_EQ(listed[0],files[1]);
 }
+
+TEST_F(FileSystem,mappedStream){
+    String fn=FileHelper::concatPath(TESTDIR,"mapped");
+    {
+        std::ofstream s(fn);
+        s << "0123456789";
+    }
+    InputStream::Ptr stream=FileHelper::openMappedFileStream(fn);
+    EXPECT_TRUE(stream->IsMapped());
+    char buffer[20];
+    EXPECT_EQ(stream->read(buffer,2),2);
+    EXPECT_EQ(String(buffer,2),"01");
+    size_t available=0;
+    char *data=stream->ReadMapped(5,available);
+    EXPECT_EQ(available,5);
+    EXPECT_EQ(String(data,available),"23456");
+    EXPECT_FALSE(stream->HasEof());
+    EXPECT_EQ(stream->read(buffer,20),3);
+    EXPECT_EQ(String(buffer,3),"789");
+    EXPECT_TRUE(stream->HasEof());
+    EXPECT_EQ(stream->BytesRead(),10);
+    EXPECT_EQ(stream->read(buffer,20),0);
+}
+TEST_F(FileSystem,mappedStreamEmpty){
+    String fn=FileHelper::concatPath(TESTDIR,"empty");
+    {
+        std::ofstream s(fn);
+    }
+    InputStream::Ptr stream=FileHelper::openMappedFileStream(fn);
+    EXPECT_FALSE(stream->IsMapped());
+    char buffer[20];
+    EXPECT_EQ(stream->read(buffer,20),0);
+}
+TEST_F(FileSystem,recordBufferGrow){
+    String fn=FileHelper::concatPath(TESTDIR,"records");
+    String small("0123456789");
+    String large;
+    for (int i=0;i<1000;i++){
+        large+=(char)('a'+i%26);
+    }
+    {
+        std::ofstream s(fn);
+        s << small << large;
+    }
+    InputStream::Ptr stream=FileHelper::openFileStream(fn);
+    ASSERT_FALSE(stream->IsMapped());
+    RecordBuffer buffer(fn);
+    char *data=buffer.WriteToBuffer(stream,small.size());
+    EXPECT_EQ(buffer.GetBuffer(),data);
+    EXPECT_EQ(String(buffer.GetBuffer(),buffer.GetFill()),small);
+    //larger then the initial buffer - must reallocate
+    data=buffer.WriteToBuffer(stream,large.size());
+    EXPECT_EQ(buffer.GetBuffer(),data);
+    ASSERT_EQ(buffer.GetFill(),large.size());
+    EXPECT_EQ(String(buffer.GetBuffer(),buffer.GetFill()),large);
+}
@@ -0,0 +1,87 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Level of detail geometry tests
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "GeometryLod.h"
+#include "TestHelper.h"
+#include <vector>
+
+TEST(GeometryLod,levelForZoom){
+    EXPECT_EQ(GeometryLod::levelForZoom(18),-1);
+    EXPECT_EQ(GeometryLod::levelForZoom(15),-1);
+    EXPECT_EQ(GeometryLod::levelForZoom(14),0);
+    EXPECT_EQ(GeometryLod::levelForZoom(12),0);
+    EXPECT_EQ(GeometryLod::levelForZoom(11),1);
+    EXPECT_EQ(GeometryLod::levelForZoom(8),2);
+    EXPECT_EQ(GeometryLod::levelForZoom(0),2);
+}
+
+TEST(GeometryLod,simplifyLine){
+    //almost straight line with one real corner
+    std::vector<Coord::WorldXy> points({
+        {0,0},{100,1},{200,-1},{300,0},{300,300},{301,600}
+    });
+    GeometryLod::Points out;
+    GeometryLod::simplifyLine(points.data(),points.size(),10,out);
+    ASSERT_EQ(out.size(),3);
+    EXPECT_EQ(out[0],points[0]);
+    EXPECT_EQ(out[1],points[3]);
+    EXPECT_EQ(out[2],points[5]);
+    //small tolerance keeps everything
+    GeometryLod::simplifyLine(points.data(),points.size(),0,out);
+    EXPECT_EQ(out.size(),points.size());
+}
+
+TEST(GeometryLod,toTriangles){
+    std::vector<Coord::WorldXy> points({{0,0},{10,0},{10,10},{0,10}});
+    GeometryLod::Points out;
+    GeometryLod::toTriangles(6,points,out);
+    ASSERT_EQ(out.size(),6);
+    EXPECT_EQ(out[3],points[0]);
+    EXPECT_EQ(out[4],points[2]);
+    EXPECT_EQ(out[5],points[3]);
+    GeometryLod::toTriangles(5,points,out);
+    ASSERT_EQ(out.size(),6);
+    EXPECT_EQ(out[3],points[1]);
+    GeometryLod::toTriangles(4,points,out);
+    EXPECT_EQ(out.size(),3);
+}
+
+TEST(GeometryLod,snapTriangles){
+    GeometryLod::Points triangles({
+        {0,0},{1000,0},{1000,1000}, //large - kept
+        {0,0},{3,1},{1,4},          //tiny - collapses
+        {-1001,-5},{-2,-3},{-1000,990} //kept, snapped
+    });
+    GeometryLod::Points out;
+    GeometryLod::snapTriangles(triangles,100,out);
+    ASSERT_EQ(out.size(),6);
+    EXPECT_EQ(out[0],Coord::WorldXy(0,0));
+    EXPECT_EQ(out[2],Coord::WorldXy(1000,1000));
+    EXPECT_EQ(out[3],Coord::WorldXy(-1000,0));
+    EXPECT_EQ(out[4],Coord::WorldXy(0,0));
+    EXPECT_EQ(out[5],Coord::WorldXy(-1000,1000));
+}
@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test OexControl
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <filesystem.hpp>
+#include <fstream>
+#include "TestHelper.h"
+#include "OexControl.h"
+#include "FileHelper.h"
+#include "StringHelper.h"
+#include "Timer.h"
+
+#define FSNS ghc::filesystem
+
+#ifdef FAKEOEX_EXE
+//uses the fake oexserverd (tools/fakeoex.cpp)
+class OexControlTest : public ::testing::Test{
+    protected:
+    String dir;
+    String chartFile;
+    String content;
+    virtual void SetUp() override{
+        FSNS::path base=FSNS::temp_directory_path() / FMT("fakeoex%d",(int)getpid());
+        FSNS::remove_all(base);
+        FSNS::create_directories(base);
+        FSNS::create_symlink(FAKEOEX_EXE,base / "oexserverd");
+        dir=base.string();
+        chartFile=(base / "test.oesu").string();
+        for (int i=0;i<20000;i++){
+            content+=FMT("%08d",i);
+        }
+        std::ofstream s(chartFile);
+        s << content;
+    }
+    virtual void TearDown() override{
+        OexControl::Ptr control=OexControl::Instance();
+        if (control){
+            control->Stop();
+            control->WaitForState(OexControl::UNKNOWN,10000);
+        }
+        unsetenv("FAKEOEX_OPTIONS");
+        FSNS::remove_all(dir);
+    }
+    OexControl::Ptr start(const char *options, int numInstances){
+        setenv("FAKEOEX_OPTIONS",options,1);
+        OexControl::Init(dir,dir,StringVector(),numInstances);
+        OexControl::Ptr control=OexControl::Instance();
+        control->Start();
+        for (int i=0;i<2000;i++){
+            json::JSON status;
+            control->ToJson(status);
+            int running=0;
+            if (numInstances > 1){
+                for (int n=0;n<status["instances"].length();n++){
+                    if (status["instances"][n]["state"].ToString() == "Running") running++;
+                }
+            }
+            else{
+                if (status["state"].ToString() == "Running") running++;
+            }
+            if (running >= numInstances) break;
+            Timer::microSleep(10000);
+        }
+        return control;
+    }
+    String readAll(InputStream::Ptr stream){
+        String rt;
+        char buffer[8192];
+        ssize_t rd=0;
+        while ((rd=stream->read(buffer,sizeof(buffer),5000)) > 0){
+            rt.append(buffer,rd);
+        }
+        return rt;
+    }
+};
+
+TEST_F(OexControlTest,pool){
+    OexControl::Ptr control=start("-l 50",2);
+    json::JSON status;
+    control->ToJson(status);
+    EXPECT_EQ(status["instances"].length(),2);
+    InputStream::Ptr s1=control->SendOexCommand(OexControl::CMD_READ_OESU,chartFile,"key");
+    InputStream::Ptr s2=control->SendOexCommand(OexControl::CMD_READ_OESU,chartFile,"key");
+    ASSERT_TRUE(s1 != nullptr);
+    ASSERT_TRUE(s2 != nullptr);
+    status=json::JSON();
+    control->ToJson(status);
+    //both requests are outstanding, so they must have been distributed
+    EXPECT_EQ(status["instances"][0]["outstanding"].ToInt(),1);
+    EXPECT_EQ(status["instances"][1]["outstanding"].ToInt(),1);
+    EXPECT_EQ(readAll(s1),content);
+    EXPECT_EQ(readAll(s2),content);
+    s1.reset();
+    s2.reset();
+    status=json::JSON();
+    control->ToJson(status);
+    EXPECT_EQ(status["instances"][0]["outstanding"].ToInt(),0);
+    EXPECT_EQ(status["instances"][1]["outstanding"].ToInt(),0);
+}
+
+TEST_F(OexControlTest,failure){
+    OexControl::Ptr control=start("-f 100",1);
+    EXPECT_EQ(control->GetState(),OexControl::RUNNING);
+    json::JSON status;
+    control->ToJson(status);
+    //failed pings during the startup are not counted as errors
+    EXPECT_EQ(status["errors"].ToInt(),0);
+    EXPECT_THROW(control->SendOexCommand(OexControl::CMD_READ_OESU,chartFile,"key"),OexControl::OpenException);
+    status=json::JSON();
+    control->ToJson(status);
+    EXPECT_EQ(status["errors"].ToInt(),1);
+    EXPECT_EQ(status["outstanding"].ToInt(),0);
+}
+
+TEST_F(OexControlTest,restart){
+    OexControl::Ptr control=start("-c 1",1);
+    EXPECT_EQ(control->GetState(),OexControl::RUNNING);
+    InputStream::Ptr s1=control->SendOexCommand(OexControl::CMD_READ_OESU,chartFile,"key");
+    EXPECT_EQ(readAll(s1),content);
+    //the second request lets the fake crash, the supervisor must restart it
+    EXPECT_THROW(control->SendOexCommand(OexControl::CMD_READ_OESU,chartFile,"key"),OexControl::OpenException);
+    json::JSON status;
+    for (int i=0;i<2000;i++){
+        status=json::JSON();
+        control->ToJson(status);
+        if (status["restarts"].ToInt() > 0 && status["state"].ToString() == "Running") break;
+        Timer::microSleep(10000);
+    }
+    EXPECT_GE(status["restarts"].ToInt(),1);
+    EXPECT_EQ(control->GetState(),OexControl::RUNNING);
+}
+#endif
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test Prefetching input stream
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <thread>
+#include "TestHelper.h"
+#include "PrefetchInputStream.h"
+#include "Timer.h"
+
+static void writeData(int fd, size_t len, int delayEvery){
+    std::thread([fd,len,delayEvery](){
+        char buffer[1000];
+        size_t written=0;
+        int loop=0;
+        while (written < len){
+            size_t num=len-written;
+            if (num > sizeof(buffer)) num=sizeof(buffer);
+            for (size_t i=0;i<num;i++){
+                buffer[i]=(char)((written+i) % 251);
+            }
+            ssize_t wr=::write(fd,buffer,num);
+            if (wr <= 0) break;
+            written+=wr;
+            loop++;
+            if (delayEvery > 0 && (loop % delayEvery) == 0) Timer::microSleep(1000);
+        }
+        ::close(fd);
+    }).detach();
+}
+
+static void checkStream(bool nonBlocking){
+    int fds[2];
+    ASSERT_EQ(pipe(fds),0);
+    if (nonBlocking){
+        fcntl(fds[0],F_SETFL,fcntl(fds[0],F_GETFL) | O_NONBLOCK);
+    }
+    const size_t len=500000;
+    writeData(fds[1],len,50);
+    InputStream::Ptr source=std::make_shared<InputStream>(fds[0],4096);
+    PrefetchInputStream::Ptr stream=std::make_shared<PrefetchInputStream>(source,8192,4);
+    EXPECT_TRUE(stream->CheckRead(2000));
+    char buffer[777];
+    size_t total=0;
+    bool ok=true;
+    while (true){
+        ssize_t rd=stream->read(buffer,sizeof(buffer));
+        if (rd <= 0) break;
+        for (ssize_t i=0;i<rd && ok;i++){
+            if (buffer[i] != (char)((total+i) % 251)) ok=false;
+        }
+        total+=rd;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(total,len);
+    EXPECT_EQ(stream->BytesRead(),len);
+    EXPECT_TRUE(stream->HasEof());
+    EXPECT_GT(stream->GetTransferMicros(),0);
+}
+
+TEST(PrefetchInputStream,blocking){
+    checkStream(false);
+}
+TEST(PrefetchInputStream,nonBlocking){
+    checkStream(true);
+}
+TEST(PrefetchInputStream,closeEarly){
+    int fds[2];
+    ASSERT_EQ(pipe(fds),0);
+    fcntl(fds[0],F_SETFL,fcntl(fds[0],F_GETFL) | O_NONBLOCK);
+    InputStream::Ptr source=std::make_shared<InputStream>(fds[0],4096);
+    PrefetchInputStream::Ptr stream=std::make_shared<PrefetchInputStream>(source,8192,4);
+    EXPECT_FALSE(stream->CheckRead(50));
+    stream->close();
+    EXPECT_TRUE(stream->HasEof());
+    char buffer[10];
+    EXPECT_EQ(stream->read(buffer,sizeof(buffer)),0);
+    ::close(fds[1]);
+}
+TEST(PrefetchInputStream,readTimeout){
+    int fds[2];
+    ASSERT_EQ(pipe(fds),0);
+    fcntl(fds[0],F_SETFL,fcntl(fds[0],F_GETFL) | O_NONBLOCK);
+    InputStream::Ptr source=std::make_shared<InputStream>(fds[0],4096);
+    PrefetchInputStream::Ptr stream=std::make_shared<PrefetchInputStream>(source,8192,4);
+    char data[100];
+    memset(data,'x',sizeof(data));
+    ASSERT_EQ(::write(fds[1],data,sizeof(data)),(ssize_t)sizeof(data));
+    EXPECT_TRUE(stream->CheckRead(2000));
+    char buffer[1000];
+    Timer::SteadyTimePoint start=Timer::steadyNow();
+    //only 100 bytes available - must return them after the timeout
+    EXPECT_EQ(stream->read(buffer,sizeof(buffer),100),100);
+    int64_t waited=Timer::steadyDiffMicros(start);
+    EXPECT_GE(waited,90000);
+    EXPECT_LT(waited,2000000);
+    EXPECT_EQ(stream->read(buffer,sizeof(buffer),0),0);
+    EXPECT_FALSE(stream->HasEof());
+    stream->close();
+    ::close(fds[1]);
+}
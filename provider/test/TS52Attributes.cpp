@@ -121,4 +121,88 @@ TEST(S52Attributes,LUPCompareQMark){
     s52::LUPrec lup;
     lup.ATTCArray=lupAttrs;
     EXPECT_TRUE(lup.attributeMatch(&attributes));
-}
\ No newline at end of file
+}
+
+TEST(S52Attributes,LUPCompareParsed){
+    MKPOOL
+    s52::Attribute::Map attributes({
+        {1,{poolRef,1,"5",1}},
+        {2,{poolRef,2,(uint32_t)8}},
+        {3,{poolRef,3,99.1}}
+    },poolRef);
+    s52::LUPrec lup;
+    lup.ATTCArray=s52::LUPrec::AttributeMap({
+        {1," "},
+        {2,"8"},
+        {3,"99.1"},
+        {4,"?"}
+    });
+    lup.parseConditions();
+    EXPECT_EQ(lup.attributeMatch(&attributes),4);
+    lup.ATTCArray[2]="7";
+    lup.parseConditions();
+    EXPECT_EQ(lup.attributeMatch(&attributes),0);
+}
+TEST(S52Attributes,LUPSelector){
+    MKPOOL
+    s52::LUPRecords records;
+    s52::LUPrec noAttr;
+    noAttr.RCID=1;
+    records.push_back(noAttr);
+    s52::LUPrec one;
+    one.RCID=2;
+    one.ATTCArray=s52::LUPrec::AttributeMap({{1,"5"}});
+    records.push_back(one);
+    s52::LUPrec two;
+    two.RCID=3;
+    two.ATTCArray=s52::LUPrec::AttributeMap({{1,"5"},{2,"7"}});
+    records.push_back(two);
+    for (auto &lup:records) lup.parseConditions();
+    s52::LUPSelector selector(records);
+    s52::Attribute::Map attributes({
+        {1,{poolRef,1,"5",1}},
+        {2,{poolRef,2,(uint32_t)7}},
+        {3,{poolRef,3,1.0}}
+    },poolRef);
+    bool hit=true;
+    const s52::LUPrec *rt=selector.find(&attributes,hit);
+    ASSERT_TRUE(rt != nullptr);
+    EXPECT_EQ(rt->RCID,3);
+    EXPECT_FALSE(hit);
+    //attribute 3 is not used by any LUP
+    s52::Attribute::Map other({
+        {1,{poolRef,1,"5",1}},
+        {2,{poolRef,2,(uint32_t)7}},
+        {3,{poolRef,3,2.0}}
+    },poolRef);
+    rt=selector.find(&other,hit);
+    ASSERT_TRUE(rt != nullptr);
+    EXPECT_EQ(rt->RCID,3);
+    EXPECT_TRUE(hit);
+    s52::Attribute::Map onlyOne({
+        {1,{poolRef,1,"5",1}}
+    },poolRef);
+    rt=selector.find(&onlyOne,hit);
+    ASSERT_TRUE(rt != nullptr);
+    EXPECT_EQ(rt->RCID,2);
+    s52::Attribute::Map empty(poolRef);
+    rt=selector.find(&empty,hit);
+    ASSERT_TRUE(rt != nullptr);
+    EXPECT_EQ(rt->RCID,1);
+}
+TEST(S52CommandTable,grow){
+    s52::CommandTable<uint32_t,uint32_t> table;
+    //more than fits into fixed size chunks of CHUNK_SIZE
+    const uint32_t num=s52::CommandTable<uint32_t,uint32_t>::CHUNK_SIZE*300;
+    for (uint32_t i=0;i<num;i++){
+        ASSERT_EQ(table.add(i,i+1),i);
+    }
+    EXPECT_EQ(table.size(),num);
+    EXPECT_EQ(table.add(5,100),5);
+    for (uint32_t i=0;i<num;i++){
+        const uint32_t *v=table.get(i);
+        ASSERT_TRUE(v != nullptr);
+        ASSERT_EQ(*v,i+1) << "index " << i;
+    }
+    EXPECT_TRUE(table.get(num) == nullptr);
+}
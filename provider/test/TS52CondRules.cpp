@@ -0,0 +1,115 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test S52 conditional rules
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "S52CondRules.h"
+#include "S52Rules.h"
+#include "generated/S57AttributeIds.h"
+#include "TestHelper.h"
+
+#define MKPOOL auto apool=ocalloc::makePool("test"); auto poolRef=ocalloc::PoolRef(apool);
+
+static s52::S52Data::Ptr makeS52Data(double safetyContour){
+    auto settings=std::make_shared<RenderSettings>();
+    settings->S52_MAR_SAFETY_CONTOUR=safetyContour;
+    return std::make_shared<s52::S52Data>(settings,FontFileHolder::Ptr());
+}
+static String cacheKey(s52::S52Data::Ptr s52data, const s52::LUPrec *lup, const String &rule, const s52::RuleConditions *conditions){
+    String key;
+    EXPECT_TRUE(s52::S52CondRules::cacheKey(lup,rule,s52data.get(),conditions,key));
+    return key;
+}
+
+TEST(S52CondRules,cacheKeyDepare){
+    MKPOOL
+    s52::Attribute::Map attributes({
+        {S57AttrIds::DRVAL1,{poolRef,S57AttrIds::DRVAL1,2.0}},
+        {S57AttrIds::DRVAL2,{poolRef,S57AttrIds::DRVAL2,5.0}},
+        {S57AttrIds::OBJNAM,{poolRef,S57AttrIds::OBJNAM,"x",1}}
+    },poolRef);
+    s52::Attribute::Map otherName({
+        {S57AttrIds::DRVAL1,{poolRef,S57AttrIds::DRVAL1,2.0}},
+        {S57AttrIds::DRVAL2,{poolRef,S57AttrIds::DRVAL2,5.0}},
+        {S57AttrIds::OBJNAM,{poolRef,S57AttrIds::OBJNAM,"y",1}}
+    },poolRef);
+    s52::Attribute::Map otherDepth({
+        {S57AttrIds::DRVAL1,{poolRef,S57AttrIds::DRVAL1,3.0}},
+        {S57AttrIds::DRVAL2,{poolRef,S57AttrIds::DRVAL2,5.0}}
+    },poolRef);
+    s52::LUPrec lup;
+    lup.OBCL="DEPARE";
+    s52::RuleConditions conditions;
+    conditions.geoPrimitive=s52::GEO_AREA;
+    conditions.attributes=&attributes;
+    auto s52data=makeS52Data(3.0);
+    String key=cacheKey(s52data,&lup,"CS(DEPARE01)",&conditions);
+    //attributes the procedure does not use do not change the key
+    conditions.attributes=&otherName;
+    EXPECT_EQ(key,cacheKey(s52data,&lup,"CS(DEPARE01)",&conditions));
+    conditions.attributes=&otherDepth;
+    EXPECT_NE(key,cacheKey(s52data,&lup,"CS(DEPARE01)",&conditions));
+    conditions.attributes=&attributes;
+    EXPECT_NE(key,cacheKey(makeS52Data(10.0),&lup,"CS(DEPARE01)",&conditions));
+    lup.OBCL="DRGARE";
+    EXPECT_NE(key,cacheKey(s52data,&lup,"CS(DEPARE01)",&conditions));
+}
+TEST(S52CondRules,cacheKeySafetyIndependent){
+    MKPOOL
+    s52::Attribute::Map attributes({
+        {S57AttrIds::RESTRN,{poolRef,S57AttrIds::RESTRN,"7",1}}
+    },poolRef);
+    s52::LUPrec lup;
+    lup.OBCL="RESARE";
+    s52::RuleConditions conditions;
+    conditions.geoPrimitive=s52::GEO_AREA;
+    conditions.attributes=&attributes;
+    conditions.nextSafetyContour=5;
+    String key=cacheKey(makeS52Data(3.0),&lup,"CS(RESTRN01)",&conditions);
+    conditions.nextSafetyContour=10;
+    EXPECT_EQ(key,cacheKey(makeS52Data(10.0),&lup,"CS(RESTRN01)",&conditions));
+}
+TEST(S52CondRules,cacheKeyInvalid){
+    s52::LUPrec lup;
+    auto s52data=makeS52Data(3.0);
+    String key;
+    EXPECT_FALSE(s52::S52CondRules::cacheKey(&lup,"CS(UNKNOWN01)",s52data.get(),nullptr,key));
+    //object dependent rules need conditions
+    EXPECT_FALSE(s52::S52CondRules::cacheKey(&lup,"CS(DEPARE01)",s52data.get(),nullptr,key));
+    EXPECT_TRUE(s52::S52CondRules::cacheKey(&lup,"CS(DATCVR01)",s52data.get(),nullptr,key));
+}
+TEST(S52CondRules,procedureCache){
+    s52::CondRuleCache cache;
+    String expanded;
+    EXPECT_FALSE(cache.get("k1",expanded));
+    cache.add("k1","AC(DEPVS)");
+    EXPECT_TRUE(cache.get("k1",expanded));
+    EXPECT_EQ(expanded,"AC(DEPVS)");
+    json::JSON status;
+    cache.ToJson(status);
+    EXPECT_EQ(status["condProcHits"].ToInt(),1);
+    EXPECT_EQ(status["condProcMisses"].ToInt(),1);
+    EXPECT_EQ(status["condProcEntries"].ToInt(),1);
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Tests for the span kernels
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "SpanKernels.h"
+#include "TestHelper.h"
+#include <vector>
+#include <random>
+
+using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+using Buffer=std::vector<ColorAndAlpha>;
+
+//all combinations of the alpha values with random colors
+static void allAlphas(Buffer &dst, Buffer &src){
+    std::mt19937 rnd(1234);
+    for (uint32_t aA=0;aA<256;aA++){
+        for (uint32_t aB=0;aB<256;aB++){
+            src.push_back((rnd() & 0xffffff) | (aA << 24));
+            dst.push_back((rnd() & 0xffffff) | (aB << 24));
+        }
+    }
+    //some special values
+    src.push_back(0);
+    dst.push_back(0x00123456);
+    src.push_back(0x00123456);
+    dst.push_back(0);
+}
+
+TEST(SpanKernels,scalarAvailable){
+    auto kernels=SpanKernels::available();
+    ASSERT_GE(kernels.size(),1);
+    EXPECT_STREQ(kernels[0]->name,"scalar");
+    EXPECT_NE(SpanKernels::get(),nullptr);
+    EXPECT_EQ(SpanKernels::find("scalar"),kernels[0]);
+    EXPECT_EQ(SpanKernels::find("unknown"),nullptr);
+}
+
+TEST(SpanKernels,blend){
+    Buffer dst;
+    Buffer src;
+    allAlphas(dst,src);
+    Buffer expected(dst.size());
+    for (size_t i=0;i<dst.size();i++){
+        expected[i]=SpanKernels::blendPixel(dst[i],src[i]);
+    }
+    for (const auto &k:SpanKernels::available()){
+        Buffer result=dst;
+        //odd length to check the remainder handling
+        k->blend(result.data(),src.data(),result.size()-3);
+        for (size_t i=0;i<result.size()-3;i++){
+            ASSERT_EQ(result[i],expected[i]) << k->name << " at " << i;
+        }
+        for (size_t i=result.size()-3;i<result.size();i++){
+            ASSERT_EQ(result[i],dst[i]) << k->name << " at " << i;
+        }
+    }
+}
+
+TEST(SpanKernels,blendColor){
+    Buffer dst;
+    Buffer src;
+    allAlphas(dst,src);
+    for (ColorAndAlpha color: {0x00000000u,0x00336699u,0x01336699u,0x80336699u,0xfe336699u,0xff336699u}){
+        for (const auto &k:SpanKernels::available()){
+            Buffer result=dst;
+            k->blendColor(result.data(),result.size(),color);
+            for (size_t i=0;i<result.size();i++){
+                ASSERT_EQ(result[i],SpanKernels::blendPixel(dst[i],color)) << k->name << " at " << i;
+            }
+        }
+    }
+}
+
+TEST(SpanKernels,glyph){
+    Buffer dst;
+    Buffer src;
+    allAlphas(dst,src);
+    std::vector<uint8_t> glyph(dst.size());
+    for (size_t i=0;i<glyph.size();i++){
+        //runs without coverage
+        glyph[i]=((i / 16) % 3 == 0)?0:(src[i] >> 24);
+    }
+    ColorAndAlpha color=0xff336699;
+    for (const auto &k:SpanKernels::available()){
+        Buffer result=dst;
+        k->glyph(result.data(),glyph.data(),result.size(),color);
+        for (size_t i=0;i<result.size();i++){
+            ColorAndAlpha gc=(color & 0xffffff) | (((ColorAndAlpha)glyph[i]) << 24);
+            ASSERT_EQ(result[i],SpanKernels::blendPixel(dst[i],gc)) << k->name << " at " << i;
+        }
+    }
+}
+
+TEST(SpanKernels,fill){
+    for (const auto &k:SpanKernels::available()){
+        Buffer result(37,0x11111111);
+        k->fill(result.data()+1,35,0x80336699);
+        EXPECT_EQ(result[0],0x11111111) << k->name;
+        EXPECT_EQ(result[36],0x11111111) << k->name;
+        for (int i=1;i<36;i++){
+            ASSERT_EQ(result[i],0x80336699) << k->name << " at " << i;
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Spatial index tests
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+#include <gtest/gtest.h>
+#include "SpatialIndex.h"
+#include "TestHelper.h"
+#include <vector>
+#include <random>
+#include <algorithm>
+
+static Coord::Extent mkExtent(Coord::World xmin, Coord::World xmax, Coord::World ymin, Coord::World ymax){
+    Coord::Extent rt(xmin,xmax,ymin,ymax);
+    rt.valid=true;
+    return rt;
+}
+
+TEST(SpatialIndex,empty){
+    std::unique_ptr<ocalloc::Pool> pool(ocalloc::makePool("test"));
+    SpatialIndex index(pool);
+    index.build();
+    SpatialIndex::IdList result;
+    index.query(mkExtent(-100,100,-100,100),result);
+    EXPECT_EQ(result.size(),0);
+}
+
+TEST(SpatialIndex,invalidExtent){
+    std::unique_ptr<ocalloc::Pool> pool(ocalloc::makePool("test"));
+    SpatialIndex index(pool);
+    index.add(Coord::Extent(),1);
+    index.add(mkExtent(0,10,0,10),2);
+    index.build();
+    EXPECT_EQ(index.size(),1);
+    SpatialIndex::IdList result;
+    index.query(mkExtent(5,5,5,5),result);
+    ASSERT_EQ(result.size(),1);
+    EXPECT_EQ(result[0],2);
+}
+
+TEST(SpatialIndex,bruteForce){
+    std::unique_ptr<ocalloc::Pool> pool(ocalloc::makePool("test"));
+    SpatialIndex index(pool);
+    std::mt19937 rnd(4711);
+    std::uniform_int_distribution<Coord::World> pos(-1000000,1000000);
+    std::uniform_int_distribution<Coord::World> size(0,20000);
+    std::vector<Coord::Extent> extents;
+    for (uint32_t i=0;i<5000;i++){
+        Coord::World x=pos(rnd);
+        Coord::World y=pos(rnd);
+        extents.push_back(mkExtent(x,x+size(rnd),y,y+size(rnd)));
+        index.add(extents.back(),i);
+    }
+    index.build();
+    EXPECT_EQ(index.size(),extents.size());
+    for (int q=0;q<200;q++){
+        Coord::World x=pos(rnd);
+        Coord::World y=pos(rnd);
+        Coord::World w=size(rnd)*(q%5);
+        Coord::Extent box=mkExtent(x,x+w,y,y+w);
+        SpatialIndex::IdList expected;
+        for (uint32_t i=0;i<extents.size();i++){
+            if (extents[i].intersects(box)) expected.push_back(i);
+        }
+        SpatialIndex::IdList result;
+        index.query(box,result);
+        std::sort(result.begin(),result.end());
+        EXPECT_EQ(result,expected) << "query " << q;
+    }
+    SpatialIndex::IdList all;
+    index.query(mkExtent(INT32_MIN,INT32_MAX,INT32_MIN,INT32_MAX),all);
+    EXPECT_EQ(all.size(),extents.size());
+}
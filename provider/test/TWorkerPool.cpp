@@ -0,0 +1,143 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Test Worker Pool
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include "TestHelper.h"
+#include "WorkerPool.h"
+#include "Timer.h"
+#include "Exception.h"
+
+TEST(WorkerPool,runAll){
+    WorkerPool pool("test",4);
+    std::atomic<int> done={0};
+    std::atomic<int> running={0};
+    std::atomic<int> maxRunning={0};
+    for (int i=0;i<100;i++){
+        EXPECT_TRUE(pool.Submit([&](){
+            int current=++running;
+            int old=maxRunning;
+            while (current > old && ! maxRunning.compare_exchange_weak(old,current)){}
+            Timer::microSleep(200);
+            running--;
+            done++;
+        }));
+    }
+    for (int i=0;i<1000 && done < 100;i++){
+        Timer::microSleep(10000);
+    }
+    EXPECT_EQ(done,100);
+    EXPECT_LE(maxRunning,4);
+    pool.Stop();
+    EXPECT_FALSE(pool.Submit([](){}));
+}
+
+TEST(WorkerPool,exception){
+    WorkerPool pool("test",1);
+    std::atomic<int> done={0};
+    pool.Submit([](){throw AvException("test");});
+    pool.Submit([&](){done++;});
+    for (int i=0;i<100 && done < 1;i++){
+        Timer::microSleep(10000);
+    }
+    EXPECT_EQ(done,1);
+}
+
+TEST(WorkerPool,runAllTasks){
+    WorkerPool pool("test",3);
+    std::vector<int> results(20,0);
+    std::vector<WorkerPool::Task> tasks;
+    for (int i=0;i<20;i++){
+        tasks.push_back([i,&results](){
+            Timer::microSleep(1000);
+            results[i]=i+1;
+        });
+    }
+    pool.RunAll(tasks);
+    for (int i=0;i<20;i++){
+        EXPECT_EQ(results[i],i+1);
+    }
+}
+
+TEST(WorkerPool,runAllStopped){
+    WorkerPool pool("test",2);
+    pool.Stop();
+    std::atomic<int> done={0};
+    std::vector<WorkerPool::Task> tasks;
+    for (int i=0;i<5;i++){
+        tasks.push_back([&done](){done++;});
+    }
+    //the caller must run all tasks
+    pool.RunAll(tasks);
+    EXPECT_EQ(done,5);
+}
+
+TEST(WorkerPool,runAllException){
+    WorkerPool pool("test",2);
+    std::atomic<int> done={0};
+    std::vector<WorkerPool::Task> tasks;
+    for (int i=0;i<4;i++){
+        tasks.push_back([&done,i](){
+            done++;
+            if (i == 2) throw AvException("test");
+        });
+    }
+    EXPECT_THROW(pool.RunAll(tasks),AvException);
+    EXPECT_EQ(done,4);
+}
+
+TEST(WorkerPool,unknownException){
+    WorkerPool pool("test",1);
+    std::atomic<int> done={0};
+    pool.Submit([](){throw 1;});
+    pool.Submit([&](){done++;});
+    for (int i=0;i<100 && done < 1;i++){
+        Timer::microSleep(10000);
+    }
+    EXPECT_EQ(done,1);
+}
+
+TEST(WorkerPool,stopReleasesTasks){
+    class Guard{
+        public:
+        std::atomic<int> *released;
+        Guard(std::atomic<int> *r):released(r){}
+        ~Guard(){(*released)++;}
+    };
+    std::atomic<int> released={0};
+    {
+        WorkerPool pool("test",1);
+        pool.Submit([](){Timer::microSleep(50000);});
+        for (int i=0;i<5;i++){
+            std::shared_ptr<Guard> guard=std::make_shared<Guard>(&released);
+            pool.Submit([guard](){});
+        }
+        pool.Stop();
+        //dropped or run - all captures must be gone
+        EXPECT_EQ(released,5);
+    }
+}
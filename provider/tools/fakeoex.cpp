@@ -0,0 +1,335 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  fake oexserverd for testing and benchmarking
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+/**
+ * a stand in for oexserverd
+ * it speaks the same socket protocol but serves unencrypted SENC files
+ * as if they had been decrypted, so the provider can be exercised
+ * (opener concurrency, timeouts, restarts) without any real charts.
+ * It can be installed as "oexserverd" in the provider's program dir.
+ * Options are taken from FAKEOEX_OPTIONS first and then from the command line,
+ * unknown options are ignored as the provider passes its own parameters.
+ */
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <getopt.h>
+#include <string.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include "EnvDefines.h"
+
+#define DEFAULT_ADDR "com.opencpn.ocharts_pi"
+#define OPTIONS_ENV "FAKEOEX_OPTIONS"
+#define LOCAL_PRFX "LOCAL:"
+
+//must match OexControl::OexCommands
+static const unsigned char CMD_READ_ESENC=0;
+static const unsigned char CMD_TEST_AVAIL=1;
+static const unsigned char CMD_EXIT=2;
+static const unsigned char CMD_READ_ESENC_HDR=3;
+static const unsigned char CMD_READ_OESU=8;
+static const unsigned char CMD_READ_OESU_HDR=9;
+
+//must match OexControl::OexMessage
+typedef struct {
+    unsigned char cmd;
+    char fifo_name[256];
+    char senc_name[256];
+    char senc_key[512];
+} OexMessage;
+
+static const long REQUEST_TIMEOUT_MS=10000;
+static const size_t CHUNK_SIZE=65536;
+
+typedef std::unique_lock<std::mutex> Synchronized;
+using Clock=std::chrono::steady_clock;
+
+class Config{
+    public:
+    std::string socketName=DEFAULT_ADDR;
+    long latencyMs=0;       //delay before the first byte of a chart
+    long throughputKb=0;    //kb/s per request, 0: unlimited
+    int failPercent=0;      //percentage of chart requests closed without data
+    long crashAfter=0;      //exit after this number of chart requests
+    long startDelayMs=0;    //delay before listening
+    bool verbose=false;
+};
+
+static Config config;
+static std::atomic<long> numChartRequests={0};
+static std::mutex randomLock;
+static std::minstd_rand randomGenerator;
+
+#define DPRINTF(...) {if (config.verbose) {printf("fakeoex(%d) ",getpid());printf(__VA_ARGS__);printf("\n");fflush(stdout);}}
+
+static void usage(const char *pn){
+    std::cerr << "usage: " << pn << " [-a socketName] [-l latencyMs] [-t throughputKbPerSec]"
+        << " [-f failPercent] [-c crashAfterRequests] [-s startDelayMs] [-v]" << std::endl;
+    std::cerr << "       options can also be set in " << OPTIONS_ENV << std::endl;
+}
+
+static void parseOptions(int argc, char **argv){
+    optind=1;
+    opterr=0;
+    int opt;
+    while ((opt = getopt(argc, argv, "a:l:t:f:c:s:vh")) != -1){
+        switch(opt){
+            case 'a':
+                config.socketName=optarg;
+                break;
+            case 'l':
+                config.latencyMs=atol(optarg);
+                break;
+            case 't':
+                config.throughputKb=atol(optarg);
+                break;
+            case 'f':
+                config.failPercent=atoi(optarg);
+                break;
+            case 'c':
+                config.crashAfter=atol(optarg);
+                break;
+            case 's':
+                config.startDelayMs=atol(optarg);
+                break;
+            case 'v':
+                config.verbose=true;
+                break;
+            case 'h':
+                usage(argv[0]);
+                exit(0);
+            default:
+                //parameters meant for the real oexserverd
+                break;
+        }
+    }
+}
+
+static void parseEnvOptions(const char *pn){
+    const char *options=getenv(OPTIONS_ENV);
+    if (options == NULL) return;
+    std::vector<std::string> parts;
+    std::istringstream stream(options);
+    std::string part;
+    parts.push_back(pn);
+    while (stream >> part) parts.push_back(part);
+    std::vector<char *> args;
+    for (auto &&p: parts) args.push_back(const_cast<char*>(p.c_str()));
+    args.push_back(NULL);
+    parseOptions(parts.size(),args.data());
+}
+
+static void sleepMillis(long millis){
+    if (millis <= 0) return;
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+}
+
+static bool readRequest(int fd, OexMessage &msg){
+    size_t received=0;
+    char *buffer=(char *)&msg;
+    Clock::time_point start=Clock::now();
+    while (received < sizeof(OexMessage)){
+        long remain=REQUEST_TIMEOUT_MS-std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now()-start).count();
+        if (remain <= 0) return false;
+        struct pollfd pfd;
+        pfd.fd=fd;
+        pfd.events=POLLIN;
+        pfd.revents=0;
+        int prt=poll(&pfd,1,remain);
+        if (prt < 0 && errno != EINTR) return false;
+        if (prt <= 0) continue;
+        ssize_t rd=read(fd,buffer+received,sizeof(OexMessage)-received);
+        if (rd <= 0) return false;
+        received+=rd;
+    }
+    msg.senc_name[sizeof(msg.senc_name)-1]=0;
+    return true;
+}
+
+static bool writeAll(int fd, const char *buffer, size_t len){
+    while (len > 0){
+        ssize_t wr=send(fd,buffer,len,MSG_NOSIGNAL);
+        if (wr < 0){
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buffer+=wr;
+        len-=wr;
+    }
+    return true;
+}
+
+static bool shouldFail(){
+    if (config.failPercent <= 0) return false;
+    Synchronized l(randomLock);
+    return (int)(randomGenerator()%100) < config.failPercent;
+}
+
+/**
+ * send the file, limiting the throughput if configured
+ * the client may close the connection early (header reads)
+ */
+static size_t sendFile(int fd, const char *fileName){
+    int ffd=open(fileName,O_RDONLY);
+    if (ffd < 0){
+        DPRINTF("unable to open %s: %s",fileName,strerror(errno));
+        return 0;
+    }
+    std::vector<char> buffer(CHUNK_SIZE);
+    size_t chunkSize=CHUNK_SIZE;
+    double bytesPerSecond=config.throughputKb*1024.0;
+    if (bytesPerSecond > 0){
+        //~ 20 chunks/s to keep the rate smooth
+        chunkSize=(size_t)(bytesPerSecond/20);
+        if (chunkSize < 512) chunkSize=512;
+        if (chunkSize > CHUNK_SIZE) chunkSize=CHUNK_SIZE;
+    }
+    Clock::time_point start=Clock::now();
+    size_t sent=0;
+    while (true){
+        ssize_t rd=read(ffd,buffer.data(),chunkSize);
+        if (rd < 0 && errno == EINTR) continue;
+        if (rd <= 0) break;
+        if (! writeAll(fd,buffer.data(),rd)) break;
+        sent+=rd;
+        if (bytesPerSecond > 0){
+            Clock::time_point target=start+std::chrono::microseconds((int64_t)(sent*1e6/bytesPerSecond));
+            std::this_thread::sleep_until(target);
+        }
+    }
+    close(ffd);
+    return sent;
+}
+
+static void handleConnection(int fd){
+    OexMessage msg;
+    if (! readRequest(fd,msg)){
+        DPRINTF("unable to read request");
+        close(fd);
+        return;
+    }
+    switch(msg.cmd){
+        case CMD_TEST_AVAIL:
+            writeAll(fd,"OK",2);
+            break;
+        case CMD_EXIT:
+            DPRINTF("exit requested");
+            exit(0);
+        case CMD_READ_ESENC:
+        case CMD_READ_ESENC_HDR:
+        case CMD_READ_OESU:
+        case CMD_READ_OESU_HDR:
+        {
+            long num=++numChartRequests;
+            if (config.crashAfter > 0 && num > config.crashAfter){
+                DPRINTF("crashing after %ld requests",config.crashAfter);
+                _exit(1);
+            }
+            if (shouldFail()){
+                DPRINTF("injected failure for %s",msg.senc_name);
+                break;
+            }
+            sleepMillis(config.latencyMs);
+            Clock::time_point start=Clock::now();
+            size_t sent=sendFile(fd,msg.senc_name);
+            DPRINTF("cmd %d, sent %ld bytes of %s in %ld ms",(int)msg.cmd,(long)sent,msg.senc_name,
+                (long)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now()-start).count());
+        }
+        break;
+        default:
+            DPRINTF("unsupported command %d",(int)msg.cmd);
+            break;
+    }
+    close(fd);
+}
+
+int main(int argc, char **argv){
+    const char *pipe=getenv(TEST_PIPE_ENV);
+    if (pipe != NULL && *pipe != 0){
+        config.socketName=pipe;
+        if (config.socketName.find(LOCAL_PRFX) == 0){
+            config.socketName=config.socketName.substr(strlen(LOCAL_PRFX));
+        }
+    }
+    parseEnvOptions(argv[0]);
+    parseOptions(argc,argv);
+    signal(SIGPIPE,SIG_IGN);
+    randomGenerator.seed(getpid());
+    sleepMillis(config.startDelayMs);
+    struct sockaddr_un addr;
+    memset(&addr,0,sizeof(addr));
+    addr.sun_family=AF_LOCAL;
+    if (config.socketName.size() >= (sizeof(addr.sun_path)-1)){
+        std::cerr << "socket name " << config.socketName << " too long" << std::endl;
+        return 1;
+    }
+    //abstract namespace like the real oexserverd
+    strcpy(addr.sun_path+1,config.socketName.c_str());
+    socklen_t addrLen=offsetof(struct sockaddr_un,sun_path)+1+config.socketName.size();
+    int listenFd=socket(AF_LOCAL,SOCK_STREAM|SOCK_CLOEXEC,0);
+    if (listenFd < 0){
+        std::cerr << "unable to create socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    if (bind(listenFd,(struct sockaddr *)&addr,addrLen) != 0){
+        std::cerr << "unable to bind to " << config.socketName << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    if (listen(listenFd,64) != 0){
+        std::cerr << "unable to listen: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    printf("fakeoexserverd listening on %s, latency=%ldms, throughput=%ldkb/s, fail=%d%%, crashAfter=%ld\n",
+        config.socketName.c_str(),config.latencyMs,config.throughputKb,config.failPercent,config.crashAfter);
+    fflush(stdout);
+    while (true){
+        int fd=accept4(listenFd,NULL,NULL,SOCK_CLOEXEC);
+        if (fd < 0){
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            std::cerr << "accept failed: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        std::thread([fd](){handleConnection(fd);}).detach();
+    }
+    return 0;
+}
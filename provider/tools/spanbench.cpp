@@ -0,0 +1,95 @@
+/******************************************************************************
+ *
+ * Project:  AvNav ocharts-provider
+ * Purpose:  Micro benchmark for the span kernels
+ * Author:   Andreas Vogel
+ *
+ ***************************************************************************
+ *   Copyright (C) 2024 by Andreas Vogel   *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.             *
+ ***************************************************************************
+ *
+ */
+
+#include "SpanKernels.h"
+#include "Timer.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <cstdlib>
+
+/**
+ * usage: spanbench [spanLength] [iterations]
+ * runs all kernels available on this cpu on spans of the given length
+ * the data resembles a tile: mostly opaque with some transparent parts
+ */
+using ColorAndAlpha=SpanKernels::ColorAndAlpha;
+using Buffer=std::vector<ColorAndAlpha>;
+
+static void fillRandom(Buffer &b, std::mt19937 &rnd){
+    for (auto &c:b){
+        uint32_t v=rnd();
+        switch(v % 4){
+            case 0: c=0; break;
+            case 1: c=v | 0xff000000; break;
+            default: c=v;
+        }
+    }
+}
+
+int main(int argc, char **argv){
+    int spanLength=256;
+    int iterations=20000;
+    if (argc > 1) spanLength=::atoi(argv[1]);
+    if (argc > 2) iterations=::atoi(argv[2]);
+    if (spanLength <= 0 || iterations <= 0){
+        std::cerr << "usage: " << argv[0] << " [spanLength] [iterations]" << std::endl;
+        return 1;
+    }
+    std::mt19937 rnd(4711);
+    Buffer src(spanLength);
+    Buffer dstInitial(spanLength);
+    std::vector<uint8_t> glyph(spanLength);
+    fillRandom(src,rnd);
+    fillRandom(dstInitial,rnd);
+    for (auto &g:glyph) g=rnd() & 0xff;
+    ColorAndAlpha color=0x80336699;
+    std::cout << "span length " << spanLength << ", iterations " << iterations 
+        << ", selected: " << SpanKernels::get()->name << std::endl;
+    std::cout << std::setw(8) << "kernels" << std::setw(12) << "fill" << std::setw(12) << "blendColor"
+        << std::setw(12) << "blend" << std::setw(12) << "glyph" << "  [ns/pixel]" << std::endl;
+    for (const auto &k:SpanKernels::available()){
+        Buffer dst=dstInitial;
+        auto measure=[&](std::function<void()> f){
+            dst=dstInitial;
+            Timer::SteadyTimePoint start=Timer::steadyNow();
+            for (int i=0;i<iterations;i++){
+                f();
+            }
+            int64_t micros=Timer::steadyDiffMicros(start);
+            return (double)micros*1000.0/((double)iterations*spanLength);
+        };
+        double tfill=measure([&](){k->fill(dst.data(),spanLength,color);});
+        double tblendColor=measure([&](){k->blendColor(dst.data(),spanLength,color);});
+        double tblend=measure([&](){k->blend(dst.data(),src.data(),spanLength);});
+        double tglyph=measure([&](){k->glyph(dst.data(),glyph.data(),spanLength,color);});
+        std::cout << std::setw(8) << k->name << std::fixed << std::setprecision(3)
+            << std::setw(12) << tfill << std::setw(12) << tblendColor
+            << std::setw(12) << tblend << std::setw(12) << tglyph << std::endl;
+    }
+    return 0;
+}